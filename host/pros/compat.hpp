@@ -0,0 +1,14 @@
+#pragma once
+
+// Functions the robot code gets from newlib on the brain that glibc doesn't provide.
+// Force-included into every translation unit of the host build.
+
+// pros/screen.h defines _GNU_SOURCE with no value, which clashes with the 1 g++ defines. Define it the same way
+#undef _GNU_SOURCE
+#define _GNU_SOURCE
+
+#ifdef __cplusplus
+#include <cmath>
+
+inline double infinity() { return HUGE_VAL; }
+#endif
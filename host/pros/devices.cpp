@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "pros/adi.hpp"
+#include "pros/distance.hpp"
+#include "pros/imu.hpp"
+#include "pros/optical.hpp"
+#include "pros/rotation.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// Host implementation of the smart sensors and the ADI ports used by this project, backed by sim::World.
+
+namespace {
+// simulated time an inertial sensor takes to calibrate, in microseconds
+constexpr std::uint64_t IMU_CALIBRATION_TIME = 2000000;
+
+sim::World& world() {
+    sim::Scheduler::get().charge();
+    return sim::World::get();
+}
+
+struct ImuState {
+        double rotationOffset = 0;
+        double headingOffset = 0;
+        std::uint64_t calibratedAt = 0;
+};
+
+struct RotationState {
+        bool reversed = false;
+        std::int32_t offset = 0;
+};
+
+std::array<ImuState, 22> imus;
+std::array<RotationState, 22> rotations;
+std::array<std::uint8_t, 22> ledPwm {};
+
+struct OpticalState {
+        // PROS default, in milliseconds
+        double integrationTime = 100;
+        std::array<double, 4> reading {};
+        std::uint64_t sampledAt = 0;
+        bool sampled = false;
+};
+
+std::array<OpticalState, 22> opticals;
+
+/**
+ * @brief The last sample of an optical sensor as {proximity, red, green, blue}. The sensor takes one sample per
+ * integration time, and reads the same until the next. The sample is what is in front of it at the first read after
+ * the integration time starts
+ */
+std::array<double, 4> opticalReading(std::uint8_t port) {
+    OpticalState& state = opticals.at(port);
+    sim::World& world = ::world();
+    const std::uint64_t now = sim::Scheduler::get().now();
+    const std::uint64_t period = std::max<std::uint64_t>(1, state.integrationTime * 1000);
+    if (!state.sampled || now / period != state.sampledAt / period) {
+        state.reading = world.optical(port);
+        state.sampledAt = now;
+        state.sampled = true;
+    }
+    return state.reading;
+}
+
+std::uint8_t adiIndex(std::uint8_t port) {
+    if (port >= 'a' && port <= 'h') return port - 'a' + 1;
+    if (port >= 'A' && port <= 'H') return port - 'A' + 1;
+    return port;
+}
+
+double wrap(double angle, double low, double high) {
+    const double range = high - low;
+    return angle - range * std::floor((angle - low) / range);
+}
+} // namespace
+
+namespace pros {
+inline namespace v5 {
+Device::Device(const std::uint8_t port)
+    : _port(port) {}
+
+std::uint8_t Device::get_port() const { return _port; }
+
+bool Device::is_installed() { return true; }
+
+// inertial sensor
+
+std::int32_t Imu::reset(bool blocking) const {
+    world().resetImu();
+    imus.at(_port) = {0, 0, sim::Scheduler::get().now() + IMU_CALIBRATION_TIME};
+    if (blocking) sim::Scheduler::get().sleepUntil(imus.at(_port).calibratedAt);
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t) const { return 1; }
+
+double Imu::get_rotation() const { return world().imuRotation() + imus.at(_port).rotationOffset; }
+
+double Imu::get_heading() const { return wrap(world().imuRotation() + imus.at(_port).headingOffset, 0, 360); }
+
+pros::quaternion_s_t Imu::get_quaternion() const {
+    const double yaw = -get_yaw() * M_PI / 180;
+    return {0, 0, std::sin(yaw / 2), std::cos(yaw / 2)};
+}
+
+pros::euler_s_t Imu::get_euler() const { return {0, 0, get_yaw()}; }
+
+double Imu::get_pitch() const { return 0; }
+
+double Imu::get_roll() const { return 0; }
+
+double Imu::get_yaw() const { return wrap(get_heading(), -180, 180); }
+
+pros::imu_gyro_s_t Imu::get_gyro_rate() const { return {0, 0, 0}; }
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return 1; }
+
+std::int32_t Imu::tare_yaw() const { return set_yaw(0); }
+
+std::int32_t Imu::tare_roll() const { return 1; }
+
+std::int32_t Imu::tare() const {
+    tare_rotation();
+    return tare_heading();
+}
+
+std::int32_t Imu::tare_euler() const { return tare_yaw(); }
+
+std::int32_t Imu::set_heading(const double target) const {
+    imus.at(_port).headingOffset = target - world().imuRotation();
+    return 1;
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+    imus.at(_port).rotationOffset = target - world().imuRotation();
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const { return set_heading(wrap(target, 0, 360)); }
+
+std::int32_t Imu::set_pitch(const double) const { return 1; }
+
+std::int32_t Imu::set_roll(const double) const { return 1; }
+
+std::int32_t Imu::set_euler(const pros::euler_s_t target) const { return set_yaw(target.yaw); }
+
+pros::imu_accel_s_t Imu::get_accel() const { return {0, 0, 1}; }
+
+pros::ImuStatus Imu::get_status() const {
+    return is_calibrating() ? pros::ImuStatus::calibrating : pros::ImuStatus::ready;
+}
+
+bool Imu::is_calibrating() const { return sim::Scheduler::get().now() < imus.at(_port).calibratedAt; }
+
+imu_orientation_e_t Imu::get_physical_orientation() const { return E_IMU_Z_UP; }
+
+// rotation sensor
+
+Rotation::Rotation(const std::int8_t port)
+    : Device(std::abs(port), DeviceType::rotation) {
+    rotations.at(_port).reversed = port < 0;
+}
+
+std::int32_t Rotation::reset() { return reset_position(); }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t) const { return 1; }
+
+std::int32_t Rotation::set_position(std::uint32_t position) const {
+    RotationState& state = rotations.at(_port);
+    const std::int32_t raw = world().rotationPosition(_port);
+    state.offset = std::int32_t(position) - (state.reversed ? -raw : raw);
+    return 1;
+}
+
+std::int32_t Rotation::reset_position() const { return set_position(0); }
+
+std::int32_t Rotation::get_position() const {
+    const RotationState& state = rotations.at(_port);
+    const std::int32_t raw = world().rotationPosition(_port);
+    return (state.reversed ? -raw : raw) + state.offset;
+}
+
+std::int32_t Rotation::get_velocity() const {
+    const std::int32_t raw = world().rotationVelocity(_port);
+    return rotations.at(_port).reversed ? -raw : raw;
+}
+
+std::int32_t Rotation::get_angle() const { return wrap(get_position(), 0, 36000); }
+
+std::int32_t Rotation::set_reversed(bool value) const {
+    rotations.at(_port).reversed = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() const { return set_reversed(!rotations.at(_port).reversed); }
+
+std::int32_t Rotation::get_reversed() const { return rotations.at(_port).reversed; }
+
+// distance sensor
+
+Distance::Distance(const std::uint8_t port)
+    : Device(port, DeviceType::distance) {}
+
+std::int32_t Distance::get() { return world().distance(_port); }
+
+std::int32_t Distance::get_distance() { return get(); }
+
+std::int32_t Distance::get_confidence() { return get() == 9999 ? 0 : 63; }
+
+std::int32_t Distance::get_object_size() { return get() == 9999 ? -1 : 200; }
+
+double Distance::get_object_velocity() { return 0; }
+
+// optical sensor
+
+Optical::Optical(const std::uint8_t port)
+    : Device(port, DeviceType::optical) {}
+
+double Optical::get_hue() {
+    const auto [proximity, r, g, b] = opticalReading(_port);
+    const double high = std::max({r, g, b});
+    const double low = std::min({r, g, b});
+    if (high == low) return 0;
+    double hue;
+    if (high == r) hue = (g - b) / (high - low);
+    else if (high == g) hue = 2 + (b - r) / (high - low);
+    else hue = 4 + (r - g) / (high - low);
+    return wrap(hue * 60, 0, 360);
+}
+
+double Optical::get_saturation() {
+    const auto [proximity, r, g, b] = opticalReading(_port);
+    const double high = std::max({r, g, b});
+    return high == 0 ? 0 : (high - std::min({r, g, b})) / high;
+}
+
+double Optical::get_brightness() {
+    const auto [proximity, r, g, b] = opticalReading(_port);
+    return std::max({r, g, b}) / 255;
+}
+
+std::int32_t Optical::get_proximity() { return std::lround(opticalReading(_port)[0]); }
+
+std::int32_t Optical::set_led_pwm(uint8_t value) {
+    ledPwm.at(_port) = value;
+    return 1;
+}
+
+std::int32_t Optical::get_led_pwm() { return ledPwm.at(_port); }
+
+pros::c::optical_rgb_s_t Optical::get_rgb() {
+    const auto [proximity, r, g, b] = opticalReading(_port);
+    return {r, g, b, std::max({r, g, b}) / 255};
+}
+
+pros::c::optical_raw_s_t Optical::get_raw() {
+    const auto [proximity, r, g, b] = opticalReading(_port);
+    return {std::uint32_t(r + g + b), std::uint32_t(r), std::uint32_t(g), std::uint32_t(b)};
+}
+
+pros::c::optical_direction_e_t Optical::get_gesture() { return pros::c::NO_GESTURE; }
+
+pros::c::optical_gesture_s_t Optical::get_gesture_raw() { return {}; }
+
+std::int32_t Optical::enable_gesture() { return 1; }
+
+std::int32_t Optical::disable_gesture() { return 1; }
+
+double Optical::get_integration_time() { return opticals.at(_port).integrationTime; }
+
+std::int32_t Optical::set_integration_time(double time) {
+    opticals.at(_port).integrationTime = std::clamp(time, 3.0, 712.0);
+    return 1;
+}
+} // namespace v5
+
+namespace adi {
+Port::Port(std::uint8_t adi_port, adi_port_config_e_t)
+    : _smart_port(INTERNAL_ADI_PORT),
+      _adi_port(adiIndex(adi_port)) {}
+
+std::int32_t Port::get_value() const { return world().adi(_adi_port); }
+
+std::int32_t Port::set_value(std::int32_t value) const {
+    world().setAdi(_adi_port, value);
+    return 1;
+}
+
+ext_adi_port_tuple_t Port::get_port() const { return {_smart_port, _adi_port, 0}; }
+
+AnalogIn::AnalogIn(std::uint8_t adi_port)
+    : Port(adi_port, E_ADI_ANALOG_IN) {}
+
+DigitalIn::DigitalIn(std::uint8_t adi_port)
+    : Port(adi_port, E_ADI_DIGITAL_IN) {}
+
+DigitalOut::DigitalOut(std::uint8_t adi_port, bool init_state)
+    : Port(adi_port, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+Encoder::Encoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom, bool)
+    : Port(adi_port_top, E_ADI_LEGACY_ENCODER),
+      _port_pair(adiIndex(adi_port_top), adiIndex(adi_port_bottom)) {}
+
+std::int32_t Encoder::reset() const { return set_value(0); }
+
+std::int32_t Encoder::get_value() const { return Port::get_value(); }
+
+ext_adi_port_tuple_t Encoder::get_port() const { return {_smart_port, _port_pair.first, _port_pair.second}; }
+} // namespace adi
+} // namespace pros
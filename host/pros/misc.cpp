@@ -0,0 +1,172 @@
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include "pros/error.h"
+#include "pros/misc.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// Host implementation of the controller, competition and battery APIs, backed by sim::World.
+
+namespace {
+// the controller accepts a screen or rumble write at most this often, in microseconds. Faster writes are dropped
+constexpr std::uint64_t CONTROLLER_WRITE_PERIOD = 50000;
+
+std::array<std::array<bool, 12>, 2> previousDigital {};
+std::array<std::uint64_t, 2> lastWrite {};
+std::array<bool, 2> written {};
+
+sim::ControllerState& controller(pros::controller_id_e_t id) {
+    sim::Scheduler::get().charge();
+    return sim::World::get().controller(id == pros::E_CONTROLLER_MASTER ? 0 : 1);
+}
+
+/**
+ * @brief Check whether the controller accepts a write now, and if it does, record it
+ */
+bool acceptWrite(pros::controller_id_e_t id) {
+    const int index = id == pros::E_CONTROLLER_MASTER ? 0 : 1;
+    const std::uint64_t now = sim::Scheduler::get().now();
+    if (written[index] && now - lastWrite[index] < CONTROLLER_WRITE_PERIOD) {
+        errno = EAGAIN;
+        return false;
+    }
+    written[index] = true;
+    lastWrite[index] = now;
+    controller(id).writes++;
+    return true;
+}
+} // namespace
+
+namespace pros {
+namespace c {
+int32_t controller_is_connected(controller_id_e_t) { return 1; }
+
+int32_t controller_get_analog(controller_id_e_t id, controller_analog_e_t channel) {
+    return controller(id).analog.at(channel);
+}
+
+int32_t controller_get_battery_capacity(controller_id_e_t) { return 100; }
+
+int32_t controller_get_battery_level(controller_id_e_t) { return 100; }
+
+int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t button) {
+    return controller(id).digital.at(button - E_CONTROLLER_DIGITAL_L1);
+}
+
+int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
+    const int index = button - E_CONTROLLER_DIGITAL_L1;
+    bool& previous = previousDigital.at(id == E_CONTROLLER_MASTER ? 0 : 1).at(index);
+    const bool pressed = controller(id).digital.at(index);
+    const bool newPress = pressed && !previous;
+    previous = pressed;
+    return newPress;
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+    if (!acceptWrite(id)) return PROS_ERR;
+    std::string& text = controller(id).screen.at(line);
+    if (text.size() < col) text.resize(col, ' ');
+    text.replace(col, std::string::npos, str);
+    return 1;
+}
+
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+    char buffer[64];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    return controller_set_text(id, line, col, buffer);
+}
+
+int32_t controller_clear_line(controller_id_e_t id, uint8_t line) {
+    if (!acceptWrite(id)) return PROS_ERR;
+    controller(id).screen.at(line).clear();
+    return 1;
+}
+
+int32_t controller_clear(controller_id_e_t id) {
+    if (!acceptWrite(id)) return PROS_ERR;
+    for (std::string& text : controller(id).screen) text.clear();
+    return 1;
+}
+
+int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern) {
+    if (!acceptWrite(id)) return PROS_ERR;
+    controller(id).rumble = rumble_pattern;
+    controller(id).rumbles++;
+    return 1;
+}
+
+int32_t battery_get_voltage(void) { return sim::World::get().disturbances().batteryVoltage * 1000; }
+
+int32_t battery_get_current(void) { return 0; }
+
+double battery_get_temperature(void) { return 25; }
+
+double battery_get_capacity(void) { return 100; }
+
+uint8_t competition_get_status(void) {
+    sim::Scheduler::get().charge();
+    return sim::World::get().competitionStatus();
+}
+} // namespace c
+
+inline namespace v5 {
+Controller::Controller(controller_id_e_t id)
+    : _id(id) {}
+
+std::int32_t Controller::is_connected() { return c::controller_is_connected(_id); }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) { return c::controller_get_analog(_id, channel); }
+
+std::int32_t Controller::get_battery_capacity() { return c::controller_get_battery_capacity(_id); }
+
+std::int32_t Controller::get_battery_level() { return c::controller_get_battery_level(_id); }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) { return c::controller_get_digital(_id, button); }
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) { return c::controller_clear_line(_id, line); }
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return c::controller_rumble(_id, rumble_pattern); }
+
+std::int32_t Controller::clear() { return c::controller_clear(_id); }
+} // namespace v5
+
+namespace battery {
+double get_capacity() { return c::battery_get_capacity(); }
+
+int32_t get_current() { return c::battery_get_current(); }
+
+double get_temperature() { return c::battery_get_temperature(); }
+
+int32_t get_voltage() { return c::battery_get_voltage(); }
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status() { return c::competition_get_status(); }
+
+std::uint8_t is_autonomous() { return (get_status() & COMPETITION_AUTONOMOUS) != 0; }
+
+std::uint8_t is_connected() { return (get_status() & COMPETITION_CONNECTED) != 0; }
+
+std::uint8_t is_disabled() { return (get_status() & COMPETITION_DISABLED) != 0; }
+
+std::uint8_t is_field_control() { return (get_status() & COMPETITION_SYSTEM) != 0; }
+
+std::uint8_t is_competition_switch() { return 0; }
+} // namespace competition
+} // namespace pros
@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/motor_group.hpp"
+#include "pros/motors.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// Host implementation of pros::Motor and pros::MotorGroup. Both classes forward every call to the functions below,
+// which operate on a single signed port. Negative ports are reversed, exactly like on the brain.
+
+namespace {
+using pros::MotorBrake;
+using pros::MotorGears;
+using pros::MotorUnits;
+using sim::MotorState;
+
+MotorState& state(std::int8_t port) {
+    sim::Scheduler::get().charge();
+    return sim::World::get().motor(port);
+}
+
+int sign(std::int8_t port) { return port < 0 ? -1 : 1; }
+
+double toRpm(MotorGears gears) {
+    switch (gears) {
+        case MotorGears::red: return 100;
+        case MotorGears::blue: return 600;
+        default: return 200;
+    }
+}
+
+MotorGears toGears(double rpm) {
+    if (rpm == 100) return MotorGears::red;
+    if (rpm == 600) return MotorGears::blue;
+    return MotorGears::green;
+}
+
+// encoder units per degree
+double unitScale(const MotorState& motor) {
+    switch (motor.encoderUnits) {
+        case 1: return 1.0 / 360;
+        case 2: return 1800 * 100 / motor.gearing / 360; // 1800 ticks per revolution on a 100 rpm cartridge
+        default: return 1;
+    }
+}
+
+void write(MotorState& motor, MotorState::Mode mode) {
+    motor.mode = mode;
+    motor.writes++;
+}
+
+std::int32_t moveVoltage(std::int8_t port, std::int32_t voltage) {
+    MotorState& motor = state(port);
+    write(motor, MotorState::Mode::VOLTAGE);
+    motor.voltage = std::clamp(voltage, -12000, 12000) * sign(port);
+    return 1;
+}
+
+std::int32_t move(std::int8_t port, std::int32_t voltage) {
+    return moveVoltage(port, std::clamp(voltage, -127, 127) * 12000 / 127);
+}
+
+std::int32_t moveVelocity(std::int8_t port, std::int32_t velocity) {
+    MotorState& motor = state(port);
+    write(motor, MotorState::Mode::VELOCITY);
+    motor.targetVelocity = velocity * sign(port);
+    return 1;
+}
+
+std::int32_t moveAbsolute(std::int8_t port, double position, std::int32_t velocity) {
+    MotorState& motor = state(port);
+    write(motor, MotorState::Mode::POSITION);
+    motor.targetPosition = position / unitScale(motor) * sign(port) + motor.zero;
+    motor.profileVelocity = std::abs(velocity);
+    return 1;
+}
+
+std::int32_t moveRelative(std::int8_t port, double position, std::int32_t velocity) {
+    MotorState& motor = state(port);
+    const double target = motor.mode == MotorState::Mode::POSITION ? motor.targetPosition : motor.position;
+    return moveAbsolute(port, ((target - motor.zero) * sign(port)) * unitScale(motor) + position, velocity);
+}
+
+std::int32_t brake(std::int8_t port) {
+    write(state(port), MotorState::Mode::BRAKE);
+    return 1;
+}
+
+std::int32_t modifyProfiledVelocity(std::int8_t port, std::int32_t velocity) {
+    state(port).profileVelocity = std::abs(velocity);
+    return 1;
+}
+
+double getTargetPosition(std::int8_t port) {
+    MotorState& motor = state(port);
+    return (motor.targetPosition - motor.zero) * sign(port) * unitScale(motor);
+}
+
+std::int32_t getTargetVelocity(std::int8_t port) { return std::lround(state(port).targetVelocity * sign(port)); }
+
+double getActualVelocity(std::int8_t port) { return state(port).velocity * sign(port); }
+
+std::int32_t getCurrentDraw(std::int8_t port) {
+    MotorState& motor = state(port);
+    const double stall = 2.1 * 100 / motor.gearing;
+    return std::min<std::int32_t>(std::lround(motor.torque / stall * 2500), motor.currentLimit);
+}
+
+std::int32_t getDirection(std::int8_t port) { return getActualVelocity(port) < 0 ? -1 : 1; }
+
+double getEfficiency(std::int8_t port) {
+    MotorState& motor = state(port);
+    if (motor.torque == 0) return 0;
+    return 100 * std::min(1.0, std::fabs(motor.velocity) / motor.gearing);
+}
+
+double getPosition(std::int8_t port) {
+    MotorState& motor = state(port);
+    return (motor.position - motor.zero) * sign(port) * unitScale(motor);
+}
+
+double getPower(std::int8_t port) {
+    MotorState& motor = state(port);
+    return std::fabs(motor.torque * motor.velocity * 2 * M_PI / 60);
+}
+
+std::int32_t getRawPosition(std::int8_t port, std::uint32_t* const timestamp) {
+    MotorState& motor = state(port);
+    if (timestamp != nullptr) *timestamp = sim::Scheduler::get().now() / 1000;
+    return std::lround(motor.position * sign(port) * 1800 * 100 / motor.gearing / 360);
+}
+
+double getTemperature(std::int8_t port) {
+    state(port);
+    return 25;
+}
+
+double getTorque(std::int8_t port) { return state(port).torque; }
+
+std::int32_t getVoltage(std::int8_t port) {
+    MotorState& motor = state(port);
+    if (motor.mode != MotorState::Mode::VOLTAGE) return 0;
+    return std::lround(motor.voltage * sign(port));
+}
+
+std::int32_t zero(std::int8_t port) {
+    state(port);
+    return 0;
+}
+
+std::uint32_t noFlags(std::int8_t port) {
+    state(port);
+    return 0;
+}
+
+MotorBrake getBrakeMode(std::int8_t port) { return static_cast<MotorBrake>(state(port).brakeMode); }
+
+std::int32_t getCurrentLimit(std::int8_t port) { return state(port).currentLimit; }
+
+MotorUnits getEncoderUnits(std::int8_t port) { return static_cast<MotorUnits>(state(port).encoderUnits); }
+
+MotorGears getGearing(std::int8_t port) { return toGears(state(port).gearing); }
+
+std::int32_t getVoltageLimit(std::int8_t port) { return state(port).voltageLimit; }
+
+std::int32_t isReversed(std::int8_t port) { return port < 0; }
+
+std::int32_t setBrakeMode(std::int8_t port, MotorBrake mode) {
+    state(port).brakeMode = static_cast<int>(mode);
+    return 1;
+}
+
+std::int32_t setCurrentLimit(std::int8_t port, std::int32_t limit) {
+    state(port).currentLimit = limit;
+    return 1;
+}
+
+std::int32_t setEncoderUnits(std::int8_t port, MotorUnits units) {
+    state(port).encoderUnits = static_cast<int>(units);
+    return 1;
+}
+
+std::int32_t setGearing(std::int8_t port, MotorGears gears) {
+    state(port).gearing = toRpm(gears);
+    return 1;
+}
+
+std::int32_t setVoltageLimit(std::int8_t port, std::int32_t limit) {
+    state(port).voltageLimit = limit;
+    return 1;
+}
+
+std::int32_t setZeroPosition(std::int8_t port, double position) {
+    MotorState& motor = state(port);
+    motor.zero = position / unitScale(motor) * sign(port);
+    return 1;
+}
+
+std::int32_t tarePosition(std::int8_t port) {
+    MotorState& motor = state(port);
+    motor.zero = motor.position;
+    return 1;
+}
+
+void configure(std::int8_t port, MotorGears gearset, MotorUnits units) {
+    if (gearset != MotorGears::invalid) setGearing(port, gearset);
+    if (units != MotorUnits::invalid) setEncoderUnits(port, units);
+}
+} // namespace
+
+// commands sent to every motor
+#define SIM_MOTOR_COMMAND(name, impl, params, args)                                                                    \
+    std::int32_t Motor::name params const { return impl(_port, args); }                                               \
+    std::int32_t MotorGroup::name params const {                                                                       \
+        std::int32_t result = 1;                                                                                       \
+        for (std::int8_t port : _ports) result = impl(port, args);                                                     \
+        return result;                                                                                                 \
+    }
+
+// getters with an index and an _all variant
+#define SIM_MOTOR_GETTER(type, name, impl)                                                                             \
+    type Motor::name(const std::uint8_t) const { return impl(_port); }                                                \
+    std::vector<type> Motor::name##_all() const { return {impl(_port)}; }                                             \
+    type MotorGroup::name(const std::uint8_t index) const { return impl(_ports.at(index)); }                          \
+    std::vector<type> MotorGroup::name##_all() const {                                                                 \
+        std::vector<type> out;                                                                                         \
+        for (std::int8_t port : _ports) out.push_back(impl(port));                                                     \
+        return out;                                                                                                    \
+    }
+
+// setters with an index and an _all variant
+#define SIM_MOTOR_SETTER(name, type, impl)                                                                             \
+    std::int32_t Motor::name(const type value, const std::uint8_t) const { return impl(_port, value); }               \
+    std::int32_t Motor::name##_all(const type value) const { return impl(_port, value); }                             \
+    std::int32_t MotorGroup::name(const type value, const std::uint8_t index) const {                                  \
+        return impl(_ports.at(index), value);                                                                          \
+    }                                                                                                                  \
+    std::int32_t MotorGroup::name##_all(const type value) const {                                                      \
+        for (std::int8_t port : _ports) impl(port, value);                                                             \
+        return 1;                                                                                                      \
+    }
+
+#define SIM_COMMA ,
+
+namespace pros {
+inline namespace v5 {
+Motor::Motor(const std::int8_t port, const MotorGears gearset, const MotorUnits encoder_units)
+    : Device(std::abs(port), DeviceType::motor),
+      _port(port) {
+    configure(port, gearset, encoder_units);
+}
+
+MotorGroup::MotorGroup(const std::initializer_list<std::int8_t> ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : MotorGroup(std::vector<std::int8_t>(ports), gearset, encoder_units) {}
+
+MotorGroup::MotorGroup(const std::vector<std::int8_t>& ports, const MotorGears gearset, const MotorUnits encoder_units)
+    : _ports(ports) {
+    for (std::int8_t port : _ports) configure(port, gearset, encoder_units);
+}
+
+MotorGroup::MotorGroup(AbstractMotor& motor_group)
+    : _ports(motor_group.get_port_all()) {}
+
+SIM_MOTOR_COMMAND(move, ::move, (std::int32_t voltage), voltage)
+SIM_MOTOR_COMMAND(move_absolute, moveAbsolute, (const double position, const std::int32_t velocity),
+                  position SIM_COMMA velocity)
+SIM_MOTOR_COMMAND(move_relative, moveRelative, (const double position, const std::int32_t velocity),
+                  position SIM_COMMA velocity)
+SIM_MOTOR_COMMAND(move_velocity, moveVelocity, (const std::int32_t velocity), velocity)
+SIM_MOTOR_COMMAND(move_voltage, moveVoltage, (const std::int32_t voltage), voltage)
+SIM_MOTOR_COMMAND(modify_profiled_velocity, modifyProfiledVelocity, (const std::int32_t velocity), velocity)
+
+std::int32_t Motor::brake() const { return ::brake(_port); }
+
+std::int32_t MotorGroup::brake() const {
+    for (std::int8_t port : _ports) ::brake(port);
+    return 1;
+}
+
+SIM_MOTOR_GETTER(double, get_target_position, getTargetPosition)
+SIM_MOTOR_GETTER(std::int32_t, get_target_velocity, getTargetVelocity)
+SIM_MOTOR_GETTER(double, get_actual_velocity, getActualVelocity)
+SIM_MOTOR_GETTER(std::int32_t, get_current_draw, getCurrentDraw)
+SIM_MOTOR_GETTER(std::int32_t, get_direction, getDirection)
+SIM_MOTOR_GETTER(double, get_efficiency, getEfficiency)
+SIM_MOTOR_GETTER(std::uint32_t, get_faults, noFlags)
+SIM_MOTOR_GETTER(std::uint32_t, get_flags, noFlags)
+SIM_MOTOR_GETTER(double, get_position, getPosition)
+SIM_MOTOR_GETTER(double, get_power, getPower)
+SIM_MOTOR_GETTER(double, get_temperature, getTemperature)
+SIM_MOTOR_GETTER(double, get_torque, getTorque)
+SIM_MOTOR_GETTER(std::int32_t, get_voltage, getVoltage)
+SIM_MOTOR_GETTER(std::int32_t, is_over_current, zero)
+SIM_MOTOR_GETTER(std::int32_t, is_over_temp, zero)
+SIM_MOTOR_GETTER(MotorBrake, get_brake_mode, getBrakeMode)
+SIM_MOTOR_GETTER(std::int32_t, get_current_limit, getCurrentLimit)
+SIM_MOTOR_GETTER(MotorUnits, get_encoder_units, getEncoderUnits)
+SIM_MOTOR_GETTER(MotorGears, get_gearing, getGearing)
+SIM_MOTOR_GETTER(std::int32_t, get_voltage_limit, getVoltageLimit)
+SIM_MOTOR_GETTER(std::int32_t, is_reversed, isReversed)
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t) const {
+    return getRawPosition(_port, timestamp);
+}
+
+std::vector<std::int32_t> Motor::get_raw_position_all(std::uint32_t* const timestamp) const {
+    return {getRawPosition(_port, timestamp)};
+}
+
+std::int32_t MotorGroup::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+    return getRawPosition(_ports.at(index), timestamp);
+}
+
+std::vector<std::int32_t> MotorGroup::get_raw_position_all(std::uint32_t* const timestamp) const {
+    std::vector<std::int32_t> out;
+    for (std::int8_t port : _ports) out.push_back(getRawPosition(port, timestamp));
+    return out;
+}
+
+SIM_MOTOR_SETTER(set_brake_mode, MotorBrake, setBrakeMode)
+SIM_MOTOR_SETTER(set_current_limit, std::int32_t, setCurrentLimit)
+SIM_MOTOR_SETTER(set_encoder_units, MotorUnits, setEncoderUnits)
+SIM_MOTOR_SETTER(set_gearing, MotorGears, setGearing)
+SIM_MOTOR_SETTER(set_voltage_limit, std::int32_t, setVoltageLimit)
+SIM_MOTOR_SETTER(set_zero_position, double, setZeroPosition)
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return set_brake_mode(static_cast<MotorBrake>(mode), index);
+}
+
+std::int32_t Motor::set_brake_mode_all(const motor_brake_mode_e_t mode) const {
+    return set_brake_mode_all(static_cast<MotorBrake>(mode));
+}
+
+std::int32_t MotorGroup::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return set_brake_mode(static_cast<MotorBrake>(mode), index);
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const motor_brake_mode_e_t mode) const {
+    return set_brake_mode_all(static_cast<MotorBrake>(mode));
+}
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return set_encoder_units(static_cast<MotorUnits>(units), index);
+}
+
+std::int32_t Motor::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    return set_encoder_units_all(static_cast<MotorUnits>(units));
+}
+
+std::int32_t MotorGroup::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return set_encoder_units(static_cast<MotorUnits>(units), index);
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    return set_encoder_units_all(static_cast<MotorUnits>(units));
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return set_gearing(static_cast<MotorGears>(gearset), index);
+}
+
+std::int32_t Motor::set_gearing_all(const motor_gearset_e_t gearset) const {
+    return set_gearing_all(static_cast<MotorGears>(gearset));
+}
+
+std::int32_t MotorGroup::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return set_gearing(static_cast<MotorGears>(gearset), index);
+}
+
+std::int32_t MotorGroup::set_gearing_all(const motor_gearset_e_t gearset) const {
+    return set_gearing_all(static_cast<MotorGears>(gearset));
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<motor_gearset_e_t> gearsets) const {
+    for (std::size_t i = 0; i < gearsets.size() && i < _ports.size(); i++)
+        setGearing(_ports[i], static_cast<MotorGears>(gearsets[i]));
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<MotorGears> gearsets) const {
+    for (std::size_t i = 0; i < gearsets.size() && i < _ports.size(); i++) setGearing(_ports[i], gearsets[i]);
+    return 1;
+}
+
+std::int32_t Motor::tare_position(const std::uint8_t) const { return tarePosition(_port); }
+
+std::int32_t Motor::tare_position_all() const { return tarePosition(_port); }
+
+std::int32_t MotorGroup::tare_position(const std::uint8_t index) const { return tarePosition(_ports.at(index)); }
+
+std::int32_t MotorGroup::tare_position_all() const {
+    for (std::int8_t port : _ports) tarePosition(port);
+    return 1;
+}
+
+std::int32_t Motor::set_reversed(const bool reverse, const std::uint8_t) {
+    _port = reverse ? -std::abs(_port) : std::abs(_port);
+    return 1;
+}
+
+std::int32_t Motor::set_reversed_all(const bool reverse) { return set_reversed(reverse); }
+
+std::int32_t MotorGroup::set_reversed(const bool reverse, const std::uint8_t index) {
+    _ports.at(index) = reverse ? -std::abs(_ports.at(index)) : std::abs(_ports.at(index));
+    return 1;
+}
+
+std::int32_t MotorGroup::set_reversed_all(const bool reverse) {
+    for (std::size_t i = 0; i < _ports.size(); i++) set_reversed(reverse, i);
+    return 1;
+}
+
+std::int8_t Motor::get_port(const std::uint8_t) const { return _port; }
+
+std::vector<std::int8_t> Motor::get_port_all() const { return {_port}; }
+
+std::int8_t Motor::size() const { return 1; }
+
+std::int8_t MotorGroup::get_port(const std::uint8_t index) const { return _ports.at(index); }
+
+std::vector<std::int8_t> MotorGroup::get_port_all() const { return _ports; }
+
+std::int8_t MotorGroup::size() const { return _ports.size(); }
+
+void MotorGroup::operator+=(AbstractMotor& other) { append(other); }
+
+void MotorGroup::append(AbstractMotor& other) {
+    for (std::int8_t port : other.get_port_all()) _ports.push_back(port);
+}
+
+void MotorGroup::erase_port(std::int8_t port) { std::erase(_ports, port); }
+} // namespace v5
+} // namespace pros
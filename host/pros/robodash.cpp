@@ -0,0 +1,130 @@
+#include <iostream>
+#include <memory>
+#include "robodash/api.h"
+#include "sim/selector.hpp"
+
+// Host implementation of the robodash views used by this project, and of the LVGL calls of lemlib::FieldView. Nothing
+// is drawn; the selector is driven by sim::selectRoutine and the console prints to stdout.
+
+namespace {
+rd::Selector* lastSelector = nullptr;
+std::vector<std::string> routineNames;
+// views and objects created, kept for the whole run
+std::vector<std::unique_ptr<rd_view_t>> views;
+std::vector<std::unique_ptr<lv_obj_t>> objects;
+
+lv_obj_t* createObject(lv_obj_t* parent) {
+    objects.push_back(std::make_unique<lv_obj_t>());
+    objects.back()->parent = parent;
+    return objects.back().get();
+}
+} // namespace
+
+extern "C" {
+rd_view_t* rd_view_create(const char* name) {
+    views.push_back(std::make_unique<rd_view_t>());
+    views.back()->name = name;
+    views.back()->obj = createObject(nullptr);
+    return views.back().get();
+}
+
+void rd_view_focus(rd_view_t*) {}
+
+lv_obj_t* rd_view_obj(rd_view_t* view) { return view->obj; }
+
+lv_obj_t* lv_canvas_create(lv_obj_t* parent) { return createObject(parent); }
+
+void lv_canvas_set_buffer(lv_obj_t* canvas, void*, lv_coord_t w, lv_coord_t h, lv_img_cf_t) {
+    canvas->coords = {0, 0, lv_coord_t(w - 1), lv_coord_t(h - 1)};
+}
+
+void lv_obj_align(lv_obj_t*, lv_align_t, lv_coord_t, lv_coord_t) {}
+
+void lv_obj_get_coords(const lv_obj_t* obj, lv_area_t* coords) { *coords = obj->coords; }
+
+void lv_obj_invalidate_area(const lv_obj_t*, const lv_area_t*) {}
+}
+
+namespace rd {
+Selector::Selector(std::string name, std::vector<routine_t> autons)
+    : view(nullptr),
+      routine_list(nullptr),
+      selected_cont(nullptr),
+      selected_label(nullptr),
+      selected_img(nullptr),
+      name(std::move(name)),
+      routines(std::move(autons)),
+      selected_routine(nullptr) {
+    lastSelector = this;
+    routineNames.clear();
+    for (const routine_t& routine : routines) routineNames.push_back(routine.name);
+}
+
+Selector::Selector(std::vector<routine_t> autons)
+    : Selector("Auton Selector", std::move(autons)) {}
+
+void Selector::run_auton() {
+    if (selected_routine != nullptr && selected_routine->action) selected_routine->action();
+}
+
+std::optional<Selector::routine_t> Selector::get_auton() {
+    if (selected_routine == nullptr) return std::nullopt;
+    return *selected_routine;
+}
+
+void Selector::on_select(select_action_t callback) { select_callbacks.push_back(std::move(callback)); }
+
+void Selector::next_auton(bool wrap_around) {
+    if (routines.empty()) return;
+    if (selected_routine == nullptr) selected_routine = &routines.front();
+    else if (selected_routine != &routines.back()) selected_routine++;
+    else if (wrap_around) selected_routine = &routines.front();
+    run_callbacks();
+}
+
+void Selector::prev_auton(bool wrap_around) {
+    if (routines.empty()) return;
+    if (selected_routine == nullptr) {
+        if (wrap_around) selected_routine = &routines.back();
+    } else if (selected_routine != &routines.front()) selected_routine--;
+    else selected_routine = wrap_around ? &routines.back() : nullptr;
+    run_callbacks();
+}
+
+void Selector::focus() {}
+
+void Selector::run_callbacks() {
+    for (select_action_t& callback : select_callbacks) callback(get_auton());
+}
+
+Console::Console(std::string)
+    : view(nullptr),
+      output(nullptr),
+      output_cont(nullptr) {}
+
+void Console::clear() { stream.str(""); }
+
+void Console::print(std::string str) {
+    stream << str;
+    std::cout << str;
+}
+
+void Console::println(std::string str) { print(str + "\n"); }
+
+void Console::focus() {}
+} // namespace rd
+
+namespace sim {
+std::vector<std::string> routines() { return routineNames; }
+
+bool selectRoutine(const std::string& name) {
+    if (lastSelector == nullptr) return false;
+    for (std::size_t i = 0; i < routineNames.size(); i++) {
+        if (routineNames[i] != name) continue;
+        while (lastSelector->get_auton()) lastSelector->prev_auton(false);
+        for (std::size_t j = 0; j <= i; j++) lastSelector->next_auton(false);
+        return true;
+    }
+    return false;
+}
+} // namespace sim
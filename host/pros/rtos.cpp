@@ -0,0 +1,194 @@
+#include <cstdint>
+#include <deque>
+#include <map>
+#include "pros/rtos.hpp"
+#include "sim/scheduler.hpp"
+
+// Host implementation of the PROS RTOS API on top of sim::Scheduler.
+// Task handles are the scheduler id plus one, so a null handle is never a valid task.
+
+namespace {
+sim::Scheduler& scheduler() { return sim::Scheduler::get(); }
+
+int toId(pros::task_t task) { return static_cast<int>(reinterpret_cast<std::intptr_t>(task)) - 1; }
+
+pros::task_t toHandle(int id) { return reinterpret_cast<pros::task_t>(static_cast<std::intptr_t>(id) + 1); }
+
+std::uint64_t toMicros(std::uint32_t timeout) { return timeout == TIMEOUT_MAX ? UINT64_MAX : timeout * 1000ull; }
+
+struct Notification {
+        std::uint32_t value = 0;
+        bool pending = false;
+        bool waiting = false;
+};
+
+std::map<int, Notification> notifications;
+
+struct HostMutex {
+        int owner = -1;
+        std::deque<int> waiters;
+};
+} // namespace
+
+namespace pros {
+namespace c {
+uint32_t millis(void) {
+    scheduler().charge();
+    return scheduler().now() / 1000;
+}
+
+uint64_t micros(void) {
+    scheduler().charge();
+    return scheduler().now();
+}
+
+void task_delay(const uint32_t milliseconds) { scheduler().sleepUntil(scheduler().now() + milliseconds * 1000ull); }
+
+void delay(const uint32_t milliseconds) { task_delay(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+    *prev_time += delta;
+    scheduler().sleepUntil(*prev_time * 1000ull);
+}
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                   const char* const name) {
+    return toHandle(scheduler().spawn([function, parameters]() { function(parameters); }, prio, name ? name : ""));
+}
+} // namespace c
+
+inline namespace rtos {
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name) {
+    task = c::task_create(function, parameters, prio, stack_depth, name);
+}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task)
+    : task(task) {}
+
+Task Task::current() { return Task(toHandle(scheduler().current())); }
+
+Task& Task::operator=(task_t in) {
+    task = in;
+    return *this;
+}
+
+void Task::remove() { scheduler().remove(toId(task)); }
+
+std::uint32_t Task::get_priority() { return scheduler().priority(toId(task)); }
+
+void Task::set_priority(std::uint32_t prio) { scheduler().setPriority(toId(task), prio); }
+
+std::uint32_t Task::get_state() {
+    const int id = toId(task);
+    if (!scheduler().alive(id)) return E_TASK_STATE_DELETED;
+    if (id == scheduler().current()) return E_TASK_STATE_RUNNING;
+    return E_TASK_STATE_READY;
+}
+
+void Task::suspend() { scheduler().suspend(toId(task)); }
+
+void Task::resume() { scheduler().resume(toId(task)); }
+
+const char* Task::get_name() { return scheduler().name(toId(task)).c_str(); }
+
+std::uint32_t Task::notify() { return notify_ext(0, E_NOTIFY_ACTION_INCR, nullptr); }
+
+void Task::join() {
+    while (scheduler().alive(toId(task))) c::delay(1);
+}
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    Notification& notification = notifications[toId(task)];
+    if (prev_value != nullptr) *prev_value = notification.value;
+    switch (action) {
+        case E_NOTIFY_ACTION_NONE: break;
+        case E_NOTIFY_ACTION_BITS: notification.value |= value; break;
+        case E_NOTIFY_ACTION_INCR: notification.value++; break;
+        case E_NOTIFY_ACTION_OWRITE: notification.value = value; break;
+        case E_NOTIFY_ACTION_NO_OWRITE:
+            if (notification.pending) return 0;
+            notification.value = value;
+            break;
+    }
+    notification.pending = true;
+    if (notification.waiting) scheduler().wake(toId(task));
+    return 1;
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    Notification& notification = notifications[scheduler().current()];
+    if (notification.value == 0 && timeout != 0) {
+        notification.waiting = true;
+        scheduler().block(toMicros(timeout));
+        notification.waiting = false;
+    }
+    const std::uint32_t value = notification.value;
+    if (value != 0) notification.value = clear_on_exit ? 0 : value - 1;
+    notification.pending = notification.value != 0;
+    return value;
+}
+
+bool Task::notify_clear() {
+    Notification& notification = notifications[toId(task)];
+    const bool pending = notification.pending;
+    notification.pending = false;
+    return pending;
+}
+
+void Task::delay(const std::uint32_t milliseconds) { c::delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return 0; }
+
+Clock::time_point Clock::now() { return time_point {duration {c::millis()}}; }
+
+Mutex::Mutex()
+    : mutex(new HostMutex, [](void* pointer) { delete static_cast<HostMutex*>(pointer); }) {}
+
+bool Mutex::take() { return take(TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) {
+    const int self = scheduler().current();
+    // outside of the scheduler there is only one thread, so nothing can contend
+    if (self == -1) return true;
+    scheduler().charge();
+    HostMutex& state = *static_cast<HostMutex*>(mutex.get());
+    if (state.owner == -1 || !scheduler().alive(state.owner)) {
+        state.owner = self;
+        return true;
+    }
+    if (timeout == 0) return false;
+    state.waiters.push_back(self);
+    if (scheduler().block(toMicros(timeout))) return true; // give() handed ownership over
+    std::erase(state.waiters, self);
+    return false;
+}
+
+bool Mutex::give() {
+    if (scheduler().current() == -1) return true;
+    HostMutex& state = *static_cast<HostMutex*>(mutex.get());
+    state.owner = -1;
+    while (!state.waiters.empty()) {
+        const int next = state.waiters.front();
+        state.waiters.pop_front();
+        if (!scheduler().alive(next)) continue;
+        state.owner = next;
+        scheduler().wake(next);
+        break;
+    }
+    return true;
+}
+
+void Mutex::lock() { take(); }
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+} // namespace rtos
+} // namespace pros
@@ -0,0 +1,78 @@
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "sim/parallel.hpp"
+
+namespace sim {
+namespace {
+struct Worker {
+        int job;
+        pid_t pid;
+        int fd;
+        std::string output;
+};
+
+Worker start(int job, const std::function<std::string(int)>& function) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        std::exit(1);
+    }
+    std::fflush(nullptr);
+    const pid_t pid = fork();
+    if (pid < 0) {
+        std::perror("fork");
+        std::exit(1);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        const std::string result = function(job);
+        for (std::size_t written = 0; written < result.size();) {
+            const ssize_t n = write(fds[1], result.data() + written, result.size() - written);
+            if (n <= 0) _exit(1);
+            written += n;
+        }
+        close(fds[1]);
+        std::fflush(nullptr);
+        // skip static destructors, the simulation is abandoned mid-flight
+        _exit(0);
+    }
+    close(fds[1]);
+    return {job, pid, fds[0], ""};
+}
+} // namespace
+
+std::vector<std::string> parallelMap(int count, int workers, const std::function<std::string(int)>& job) {
+    if (workers <= 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> results(count);
+    std::vector<Worker> running;
+    int next = 0;
+    while (next < count || !running.empty()) {
+        while (next < count && int(running.size()) < workers) running.push_back(start(next++, job));
+        std::vector<pollfd> fds;
+        for (const Worker& worker : running) fds.push_back({worker.fd, POLLIN, 0});
+        poll(fds.data(), fds.size(), -1);
+        for (std::size_t i = running.size(); i-- > 0;) {
+            if (fds[i].revents == 0) continue;
+            Worker& worker = running[i];
+            char buffer[4096];
+            const ssize_t n = read(worker.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                worker.output.append(buffer, n);
+                continue;
+            }
+            // end of file, the job is done
+            close(worker.fd);
+            int status = 0;
+            waitpid(worker.pid, &status, 0);
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0) results[worker.job] = std::move(worker.output);
+            else std::fprintf(stderr, "sim: job %d failed\n", worker.job);
+            running.erase(running.begin() + i);
+        }
+    }
+    return results;
+}
+} // namespace sim
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Run independent simulations in parallel, one process per job
+ *
+ * The simulator, LemLib and the robot code all keep global state, so instead of resetting it between runs each job
+ * runs in a freshly forked child process and sends its result back over a pipe. Results are returned in job order,
+ * so the output only depends on the jobs, never on the number of workers or on how the host schedules them.
+ *
+ * @param count number of jobs
+ * @param workers maximum number of jobs to run at once. 0 uses every core
+ * @param job function that runs job i and returns its result. Runs in the child process
+ * @return std::vector<std::string> the result of each job, empty if the job crashed
+ */
+std::vector<std::string> parallelMap(int count, int workers, const std::function<std::string(int)>& job);
+} // namespace sim
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include "sim/robot.hpp"
+
+namespace sim {
+// intake motor that feeds the lady brown, and the lady brown motor the arm rotation sensor follows 1:1
+constexpr std::int8_t INTAKE_PORT = 11;
+constexpr std::int8_t LADY_BROWN_PORT = 21;
+// hard stops the lady brown arm rests against, in degrees from where it starts
+constexpr double ARM_LOW = -2;
+constexpr double ARM_HIGH = 260;
+// arm angle at which it is balanced upright, and how fast it falls away from there when nothing holds it, in degrees
+// and degrees per second
+constexpr double ARM_UPRIGHT = 90;
+constexpr double ARM_FALL_SPEED = 120;
+// how fast gravity accelerates the arm while the motor drives it, when it is horizontal, in degrees per second squared.
+// Against the motor's time constant it takes about 600mV to hold the arm there, and less as it comes upright
+constexpr double ARM_GRAVITY = 1200;
+// arm angles between which a ring is fed into the lady brown instead of up the intake, in degrees
+constexpr double LOADING_LOW = 15;
+constexpr double LOADING_HIGH = 40;
+// time the intake has to run forwards into the loaded arm before the ring jams, in seconds
+constexpr double FEED_TIME = 0.5;
+// torque a jammed ring resists the intake with, in Nm. Well above the stall torque of a blue cartridge
+constexpr double JAM_LOAD = 2;
+
+RobotModel robotModel() {
+    RobotModel model;
+    // 11" track width, new 2.75" omnis, 600 rpm
+    model.drive.leftPorts = {-10, 2, 9};
+    model.drive.rightPorts = {8, -1, -7};
+    model.drive.trackWidth = 11;
+    model.drive.wheelDiameter = 2.75;
+    model.drive.rpm = 600;
+    // motors act on a command about one 10ms device cycle after it is sent
+    model.drive.commandDelay = 0.01;
+    // vertical tracking wheel on port 15, reversed, 1.5" left. Horizontal tracking wheel on port 16
+    model.trackingWheels.push_back({-15, 2.75, -1.5, false});
+    model.trackingWheels.push_back({16, 2.75, 1.5, true});
+    // lady brown rotation sensor on port 17, geared 1:1 to the arm motor on port 21
+    model.shaftSensors.push_back({17, 21, 1});
+    model.imuPort = 6;
+    return model;
+}
+
+void addMechanismModels() {
+    struct Intake {
+            double fed = 0;
+            bool jammed = false;
+    };
+
+    auto intake = std::make_shared<Intake>();
+    World::get().addStepHook([intake](float dt) {
+        World& world = World::get();
+        MotorState& ladyBrown = world.motor(LADY_BROWN_PORT);
+        bool coasting = ladyBrown.mode == MotorState::Mode::VOLTAGE && ladyBrown.voltage == 0;
+        if (ladyBrown.mode == MotorState::Mode::BRAKE) coasting = ladyBrown.brakeMode == 0;
+        if (coasting) ladyBrown.position += (ladyBrown.position < ARM_UPRIGHT ? -1 : 1) * ARM_FALL_SPEED * dt;
+        else if (ladyBrown.mode == MotorState::Mode::VOLTAGE)
+            ladyBrown.velocity += std::sin((ladyBrown.position - ARM_UPRIGHT) * M_PI / 180) * ARM_GRAVITY / 6 * dt;
+        if (ladyBrown.position < ARM_LOW || ladyBrown.position > ARM_HIGH) {
+            ladyBrown.position = std::clamp(ladyBrown.position, ARM_LOW, ARM_HIGH);
+            ladyBrown.velocity = 0;
+        }
+        MotorState& motor = world.motor(INTAKE_PORT);
+        const double arm = ladyBrown.position;
+        // intake1 is reversed in main.cpp, so positive shaft velocity pulls rings in
+        if (arm < LOADING_LOW || arm > LOADING_HIGH) {
+            *intake = {};
+        } else if (intake->jammed) {
+            const bool reversing = motor.mode == MotorState::Mode::VOLTAGE && motor.voltage < 0;
+            if (reversing) *intake = {};
+        } else if (motor.velocity > 100) {
+            intake->fed += dt;
+            intake->jammed = intake->fed > FEED_TIME;
+        }
+        motor.load = intake->jammed ? JAM_LOAD : 0;
+    });
+}
+} // namespace sim
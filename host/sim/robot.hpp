@@ -0,0 +1,21 @@
+#pragma once
+
+#include "sim/world.hpp"
+
+namespace sim {
+/**
+ * @brief Get the simulated model of the robot configured in src/main.cpp
+ *
+ * Keep this in sync with the ports, wheels and gearing in main.cpp.
+ */
+RobotModel robotModel();
+
+/**
+ * @brief Model the mechanisms of the robot in src/main.cpp that the drivetrain model doesn't cover
+ *
+ * The lady brown arm travels between two hard stops and falls against one when unpowered. A ring fed into the lady
+ * brown while the arm waits in its loading position jams the intake, which stalls until it is reversed. Once the arm
+ * holds a ring, every ring fed behind it jams the same way. Call after World::configure.
+ */
+void addMechanismModels();
+} // namespace sim
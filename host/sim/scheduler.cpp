@@ -0,0 +1,189 @@
+#include <ucontext.h>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include "sim/scheduler.hpp"
+
+namespace sim {
+// time slice given to a task that spins without sleeping, in microseconds
+constexpr std::uint64_t TIME_SLICE = 1000;
+// number of API calls a task may make without sleeping before it is preempted
+constexpr std::uint32_t CALLS_PER_SLICE = 2000;
+// stack size of each task. Generous, since fmt formatting is stack hungry
+constexpr std::size_t STACK_SIZE = 256 * 1024;
+constexpr std::uint64_t FOREVER = std::numeric_limits<std::uint64_t>::max();
+
+struct Scheduler::Task {
+        int id;
+        int parent;
+        std::string name;
+        std::uint32_t priority;
+        std::function<void()> function;
+        std::vector<char> stack;
+        ucontext_t context;
+        std::uint64_t start;
+        std::uint64_t wake = 0;
+        std::uint64_t order = 0;
+        std::uint32_t calls = 0;
+        bool blocked = false;
+        bool woken = false;
+        bool suspended = false;
+        bool done = false;
+};
+
+Scheduler::Scheduler()
+    : schedulerContext(new ucontext_t) {}
+
+Scheduler::~Scheduler() { delete static_cast<ucontext_t*>(schedulerContext); }
+
+Scheduler& Scheduler::get() {
+    static Scheduler scheduler;
+    return scheduler;
+}
+
+int Scheduler::spawn(std::function<void()> function, std::uint32_t priority, const std::string& name) {
+    auto task = std::make_unique<Task>();
+    task->id = tasks.size();
+    task->parent = running;
+    task->name = name;
+    task->priority = priority;
+    task->function = std::move(function);
+    task->stack.resize(STACK_SIZE);
+    task->start = time;
+    task->wake = time;
+    task->order = sequence++;
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->stack.data();
+    task->context.uc_stack.ss_size = task->stack.size();
+    task->context.uc_link = static_cast<ucontext_t*>(schedulerContext);
+    makecontext(&task->context, &Scheduler::trampoline, 0);
+    tasks.push_back(std::move(task));
+    return tasks.size() - 1;
+}
+
+void Scheduler::trampoline() {
+    Scheduler& scheduler = get();
+    Task& task = *scheduler.tasks.at(scheduler.running);
+    task.function();
+    task.done = true;
+    scheduler.records.push_back({task.id, task.parent, task.name, task.start, scheduler.time});
+    for (auto& hook : scheduler.finishHooks) hook(scheduler.records.back());
+    // returning switches to uc_link, the scheduler context
+}
+
+bool Scheduler::run(std::function<void()> root, std::uint64_t timeLimit) {
+    const int rootId = spawn(std::move(root), 0, "root");
+    ucontext_t* context = static_cast<ucontext_t*>(schedulerContext);
+    while (!tasks.at(rootId)->done) {
+        // find the next task to run
+        Task* next = nullptr;
+        for (auto& task : tasks) {
+            if (task->done || task->suspended || task->wake == FOREVER) continue;
+            if (next == nullptr || task->wake < next->wake ||
+                (task->wake == next->wake &&
+                 (task->priority > next->priority ||
+                  (task->priority == next->priority && task->order < next->order))))
+                next = task.get();
+        }
+        // every task is blocked forever, nothing can ever happen again
+        if (next == nullptr) return false;
+        if (next->wake > timeLimit) {
+            advanceTo(timeLimit);
+            return false;
+        }
+        advanceTo(next->wake);
+        running = next->id;
+        swapcontext(context, &next->context);
+        running = -1;
+    }
+    return true;
+}
+
+void Scheduler::advanceTo(std::uint64_t target) {
+    // run the tick hooks in time order for every period boundary crossed
+    while (true) {
+        TickHook* due = nullptr;
+        for (TickHook& hook : hooks) {
+            if (hook.next <= target && (due == nullptr || hook.next < due->next)) due = &hook;
+        }
+        if (due == nullptr) break;
+        time = due->next;
+        due->next += due->period;
+        due->function(time);
+    }
+    if (target > time) time = target;
+}
+
+std::uint64_t Scheduler::now() const { return time; }
+
+void Scheduler::switchToScheduler() {
+    Task& task = *tasks.at(running);
+    task.order = sequence++;
+    task.calls = 0;
+    swapcontext(&task.context, static_cast<ucontext_t*>(schedulerContext));
+}
+
+void Scheduler::sleepUntil(std::uint64_t wake) {
+    if (running == -1) {
+        std::fprintf(stderr, "sim: pros::delay called outside of a task\n");
+        std::abort();
+    }
+    tasks.at(running)->wake = wake < time ? time : wake;
+    switchToScheduler();
+}
+
+bool Scheduler::block(std::uint64_t timeout) {
+    Task& task = *tasks.at(running);
+    task.blocked = true;
+    task.woken = false;
+    task.wake = timeout == FOREVER || time + timeout < time ? FOREVER : time + timeout;
+    switchToScheduler();
+    task.blocked = false;
+    return task.woken;
+}
+
+void Scheduler::wake(int id) {
+    Task& task = *tasks.at(id);
+    if (!task.blocked || task.done) return;
+    task.woken = true;
+    task.blocked = false;
+    task.wake = time;
+}
+
+void Scheduler::charge() {
+    if (running == -1) return;
+    if (++tasks.at(running)->calls >= CALLS_PER_SLICE) sleepUntil(time + TIME_SLICE);
+}
+
+int Scheduler::current() const { return running; }
+
+const std::string& Scheduler::name(int id) const { return tasks.at(id)->name; }
+
+std::uint32_t Scheduler::priority(int id) const { return tasks.at(id)->priority; }
+
+void Scheduler::setPriority(int id, std::uint32_t priority) { tasks.at(id)->priority = priority; }
+
+void Scheduler::suspend(int id) {
+    tasks.at(id)->suspended = true;
+    if (id == running) switchToScheduler();
+}
+
+void Scheduler::resume(int id) { tasks.at(id)->suspended = false; }
+
+void Scheduler::remove(int id) {
+    Task& task = *tasks.at(id);
+    if (task.done) return;
+    task.done = true;
+    if (id == running) switchToScheduler();
+}
+
+bool Scheduler::alive(int id) const { return id >= 0 && id < int(tasks.size()) && !tasks.at(id)->done; }
+
+void Scheduler::addTickHook(std::uint64_t period, std::function<void(std::uint64_t)> hook) {
+    hooks.push_back({period, time + period, std::move(hook)});
+}
+
+const std::vector<Scheduler::TaskRecord>& Scheduler::finished() const { return records; }
+
+void Scheduler::onFinish(std::function<void(const TaskRecord&)> hook) { finishHooks.push_back(std::move(hook)); }
+} // namespace sim
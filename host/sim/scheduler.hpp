@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Deterministic cooperative scheduler with a virtual clock
+ *
+ * Every pros::Task created on the host becomes a coroutine owned by this scheduler. Only one coroutine runs at a
+ * time, and the virtual clock only advances when every runnable task is sleeping, so a simulation produces the same
+ * result every time it is run with the same inputs, no matter how fast or loaded the host is.
+ *
+ * Tasks are ordered by wake time, then by priority (higher first), then by the order they went to sleep. This
+ * mirrors FreeRTOS closely enough for the control loops in LemLib and main.cpp, which all block in pros::delay.
+ */
+class Scheduler {
+    public:
+        /**
+         * @brief Information about a task that has run to completion
+         */
+        struct TaskRecord {
+                /** id of the task */
+                int id;
+                /** id of the task that created it, -1 for the root task */
+                int parent;
+                /** name given when the task was created */
+                std::string name;
+                /** virtual time the task was created, in microseconds */
+                std::uint64_t start;
+                /** virtual time the task returned, in microseconds */
+                std::uint64_t end;
+        };
+
+        /**
+         * @brief Get the scheduler for this process
+         */
+        static Scheduler& get();
+
+        /**
+         * @brief Create a new task
+         *
+         * The task becomes runnable at the current virtual time, after any task that is already runnable.
+         *
+         * @param function function the task runs
+         * @param priority task priority, higher runs first when tasks wake at the same time
+         * @param name task name
+         * @return int id of the new task
+         */
+        int spawn(std::function<void()> function, std::uint32_t priority, const std::string& name);
+
+        /**
+         * @brief Run the simulation
+         *
+         * Runs root as the first task and keeps scheduling until root returns or the virtual clock reaches the time
+         * limit. Tasks which are still alive when this returns are abandoned; each simulation is expected to run in
+         * its own process (see sim::parallelMap).
+         *
+         * @param root the function to run as the root task
+         * @param timeLimit maximum virtual time to run for, in microseconds
+         * @return true root returned before the time limit
+         * @return false the time limit was reached first
+         */
+        bool run(std::function<void()> root, std::uint64_t timeLimit);
+
+        /**
+         * @brief Get the virtual time, in microseconds
+         */
+        std::uint64_t now() const;
+
+        /**
+         * @brief Suspend the current task until the given virtual time
+         *
+         * @param wake virtual time to wake up at, in microseconds
+         */
+        void sleepUntil(std::uint64_t wake);
+
+        /**
+         * @brief Block the current task until it is woken by wake() or the timeout expires
+         *
+         * @param timeout maximum time to block for, in microseconds. UINT64_MAX blocks forever
+         * @return true the task was woken by wake()
+         * @return false the timeout expired
+         */
+        bool block(std::uint64_t timeout);
+
+        /**
+         * @brief Wake a task that is blocked in block()
+         *
+         * @param id id of the task
+         */
+        void wake(int id);
+
+        /**
+         * @brief Count a device or RTOS call made by the current task
+         *
+         * FreeRTOS preempts a task that spins without blocking; a coroutine can't be preempted, so the PROS shim calls
+         * this on every API call and the task is put to sleep for one time slice once it has made too many calls
+         * without sleeping.
+         */
+        void charge();
+
+        /**
+         * @brief Get the id of the running task, -1 outside of run()
+         */
+        int current() const;
+
+        /**
+         * @brief Get the name of a task
+         */
+        const std::string& name(int id) const;
+
+        /**
+         * @brief Get the priority of a task
+         */
+        std::uint32_t priority(int id) const;
+
+        /**
+         * @brief Set the priority of a task
+         */
+        void setPriority(int id, std::uint32_t priority);
+
+        /**
+         * @brief Suspend a task until resume() is called
+         */
+        void suspend(int id);
+
+        /**
+         * @brief Resume a suspended task
+         */
+        void resume(int id);
+
+        /**
+         * @brief Remove a task. Removing the running task does not return
+         */
+        void remove(int id);
+
+        /**
+         * @brief Get whether a task is still alive
+         */
+        bool alive(int id) const;
+
+        /**
+         * @brief Register a function to be called at a fixed virtual period
+         *
+         * The hook runs outside of any task, every time the clock crosses a multiple of the period. The world model
+         * uses this to integrate physics.
+         *
+         * @param period period in microseconds
+         * @param hook function called with the current virtual time
+         */
+        void addTickHook(std::uint64_t period, std::function<void(std::uint64_t)> hook);
+
+        /**
+         * @brief Get every task that has returned so far, in the order they returned
+         */
+        const std::vector<TaskRecord>& finished() const;
+
+        /**
+         * @brief Register a function to be called whenever a task returns
+         *
+         * The hook runs on the returning task, before the scheduler switches away from it.
+         */
+        void onFinish(std::function<void(const TaskRecord&)> hook);
+    private:
+        struct Task;
+        struct TickHook {
+                std::uint64_t period;
+                std::uint64_t next;
+                std::function<void(std::uint64_t)> function;
+        };
+
+        Scheduler();
+        ~Scheduler();
+
+        static void trampoline();
+        void switchToScheduler();
+        void advanceTo(std::uint64_t time);
+
+        std::vector<std::unique_ptr<Task>> tasks;
+        std::vector<TickHook> hooks;
+        std::vector<TaskRecord> records;
+        std::vector<std::function<void(const TaskRecord&)>> finishHooks;
+        std::uint64_t time = 0;
+        std::uint64_t sequence = 0;
+        int running = -1;
+        void* schedulerContext;
+};
+} // namespace sim
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Get the names of the routines in the most recently created rd::Selector
+ */
+std::vector<std::string> routines();
+
+/**
+ * @brief Select a routine in the most recently created rd::Selector, as if it was tapped on the screen
+ *
+ * @param name name of the routine
+ * @return true the routine was found and selected
+ * @return false there is no routine with that name
+ */
+bool selectRoutine(const std::string& name);
+} // namespace sim
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/util.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+namespace sim {
+// physics step, in microseconds
+constexpr std::uint64_t STEP = 1000;
+// stall torque of a 100 rpm cartridge, in Nm. Faster cartridges scale down linearly
+constexpr double STALL_TORQUE_100 = 2.1;
+// time constant of a free spinning motor, in seconds
+constexpr double MOTOR_TIME_CONSTANT = 0.05;
+
+World& World::get() {
+    static World world;
+    return world;
+}
+
+void World::configure(const RobotModel& model, const Disturbances& disturbances, std::uint64_t seed) {
+    this->model = model;
+    this->dist = disturbances;
+    rng.seed(seed);
+    for (std::int8_t port : model.drive.leftPorts) motor(port).drive = true;
+    for (std::int8_t port : model.drive.rightPorts) motor(port).drive = true;
+    teleport(disturbances.startOffset);
+    if (!configured) Scheduler::get().addTickHook(STEP, [this](std::uint64_t) { step(STEP / 1e6); });
+    configured = true;
+}
+
+void World::teleport(lemlib::Pose pose) {
+    x = pose.x;
+    y = pose.y;
+    theta = lemlib::degToRad(pose.theta);
+    leftSpeed = 0;
+    rightSpeed = 0;
+    pendingVoltages.clear();
+}
+
+lemlib::Pose World::pose() const { return lemlib::Pose(x, y, lemlib::radToDeg(theta)); }
+
+std::array<float, 2> World::sideSpeeds() const { return {float(leftSpeed), float(rightSpeed)}; }
+
+MotorState& World::motor(std::int8_t port) { return motors.at(std::abs(port)); }
+
+float World::noise(float stddev) {
+    if (stddev == 0) return 0;
+    return std::normal_distribution<float>(0, stddev)(rng);
+}
+
+std::int32_t World::rotationPosition(std::uint8_t port) {
+    for (const ShaftSensorModel& sensor : model.shaftSensors) {
+        if (std::abs(sensor.port) != port) continue;
+        MotorState& shaft = motor(sensor.motorPort);
+        return std::lround(shaft.position * sensor.ratio * lemlib::sgn(sensor.port) * 100) - rotationZero.at(port);
+    }
+    return std::lround(rotationTravel.at(port) - rotationZero.at(port) + noise(dist.trackingNoise));
+}
+
+std::int32_t World::rotationVelocity(std::uint8_t port) {
+    for (const ShaftSensorModel& sensor : model.shaftSensors) {
+        if (std::abs(sensor.port) != port) continue;
+        return std::lround(motor(sensor.motorPort).velocity * 6 * sensor.ratio * lemlib::sgn(sensor.port) * 100);
+    }
+    return std::lround(rotationSpeed.at(port));
+}
+
+void World::resetRotation(std::uint8_t port) {
+    rotationZero.at(port) = 0;
+    rotationZero.at(port) = rotationPosition(port);
+}
+
+double World::imuRotation() { return imuTravel + imuError + noise(dist.imuNoise); }
+
+void World::resetImu() {
+    imuTravel = 0;
+    imuError = 0;
+}
+
+void World::setDistanceModel(std::uint8_t port, std::function<std::int32_t()> model) {
+    distanceModels.at(port) = std::move(model);
+}
+
+std::int32_t World::distance(std::uint8_t port) {
+    if (!distanceModels.at(port)) return 9999;
+    return distanceModels.at(port)();
+}
+
+void World::setOpticalModel(std::uint8_t port, std::function<std::array<double, 4>()> model) {
+    opticalModels.at(port) = std::move(model);
+}
+
+std::array<double, 4> World::optical(std::uint8_t port) {
+    if (!opticalModels.at(port)) return {0, 0, 0, 0};
+    return opticalModels.at(port)();
+}
+
+void World::setAdi(std::uint8_t port, std::int32_t value) { adiValues.at(port) = value; }
+
+std::int32_t World::adi(std::uint8_t port) { return adiValues.at(port); }
+
+ControllerState& World::controller(int id) { return controllers.at(id); }
+
+void World::setCompetitionStatus(std::uint8_t status) { competition = status; }
+
+std::uint8_t World::competitionStatus() const { return competition; }
+
+void World::addStepHook(std::function<void(float dt)> hook) { stepHooks.push_back(std::move(hook)); }
+
+std::mt19937_64& World::random() { return rng; }
+
+const Disturbances& World::disturbances() const { return dist; }
+
+/**
+ * @brief Get the voltage a motor applies, in millivolts, emulating the built-in velocity and position controllers
+ *
+ * Returns NAN if the motor is braking.
+ */
+static double commandVoltage(const MotorState& state) {
+    double voltage = 0;
+    auto velocityControl = [&](double target) {
+        return (target + 3 * (target - state.velocity)) / state.gearing * 12000;
+    };
+    switch (state.mode) {
+        case MotorState::Mode::VOLTAGE: voltage = state.voltage; break;
+        case MotorState::Mode::VELOCITY: voltage = velocityControl(state.targetVelocity); break;
+        case MotorState::Mode::POSITION: {
+            const double limit = state.profileVelocity;
+            voltage = velocityControl(std::clamp((state.targetPosition - state.position) * 3, -limit, limit));
+            break;
+        }
+        case MotorState::Mode::BRAKE: return NAN;
+    }
+    if (state.voltageLimit > 0) voltage = std::clamp<double>(voltage, -state.voltageLimit, state.voltageLimit);
+    return voltage;
+}
+
+/**
+ * @brief Get the voltage the motors on one side of the drivetrain push forwards with, in millivolts
+ *
+ * Returns NAN if the side is braking.
+ */
+float World::sideVoltage(const std::vector<std::int8_t>& ports) const {
+    if (ports.empty()) return 0;
+    float sum = 0;
+    for (std::int8_t port : ports) sum += commandVoltage(motors.at(std::abs(port))) * lemlib::sgn(port);
+    return sum / ports.size();
+}
+
+void World::stepMotor(MotorState& state, float dt) {
+    const double limit = std::min(12000.0, (dist.batteryVoltage - 0.8) * 1000);
+    const double stall = STALL_TORQUE_100 * 100 / state.gearing;
+    const double command = commandVoltage(state);
+    double target = 0;
+    double tau = MOTOR_TIME_CONSTANT;
+    double drive = NAN;
+    if (std::isnan(command)) {
+        tau = state.brakeMode == 0 ? MOTOR_TIME_CONSTANT * 4 : 0.01;
+        state.torque = state.brakeMode == 0 ? 0 : state.load;
+    } else {
+        const double requested = std::min(std::fabs(command) / 12000, 1.0);
+        const double available = std::min(std::fabs(command), limit) / 12000;
+        // the load eats into the available torque, and stalls the motor once it exceeds it. Stall torque is set by the
+        // current limit, so a low battery costs speed but not torque
+        const double loss = std::min(requested, state.load / stall);
+        target = state.gearing * lemlib::sgn(command) * std::max(0.0, available - loss);
+        drive = lemlib::sgn(command) * available;
+    }
+    state.velocity += (target - state.velocity) * std::min(1.0, dt / tau);
+    state.position += state.velocity * 6 * dt;
+    // the motor pushes with what its voltage leaves after the back EMF of its speed, up to the stall torque. That is
+    // the load at a steady speed, and more while it speeds up or slows down
+    if (!std::isnan(drive)) state.torque = std::min(stall, std::fabs(drive - state.velocity / state.gearing) * stall);
+}
+
+void World::step(float dt) {
+    const DriveModel& drive = model.drive;
+    const double maxSpeed = drive.rpm / 60 * M_PI * drive.wheelDiameter;
+    const double limit = std::min(12000.0, (dist.batteryVoltage - 0.8) * 1000);
+
+    // drive sides, acting on the voltages commanded commandDelay ago
+    pendingVoltages.push_back({sideVoltage(drive.leftPorts), sideVoltage(drive.rightPorts)});
+    const std::size_t delaySteps = std::lround(drive.commandDelay / dt);
+    while (pendingVoltages.size() > delaySteps + 1) pendingVoltages.pop_front();
+    const std::array<float, 2> voltages = pendingVoltages.front();
+    auto stepSide = [&](double& speed, float voltage, const std::vector<std::int8_t>& ports) {
+        if (std::isnan(voltage)) {
+            const int brakeMode = motors.at(std::abs(ports.at(0))).brakeMode;
+            const double tau = brakeMode == 0 ? drive.timeConstant * 4 : drive.brakeTimeConstant;
+            speed -= speed * std::min(1.0, dt / tau);
+        } else {
+            const double target = std::clamp(double(voltage), -limit, limit) / 12000 * maxSpeed;
+            speed += (target - speed) * std::min(1.0, dt / double(drive.timeConstant));
+        }
+    };
+    if (!drive.leftPorts.empty()) stepSide(leftSpeed, voltages[0], drive.leftPorts);
+    if (!drive.rightPorts.empty()) stepSide(rightSpeed, voltages[1], drive.rightPorts);
+
+    // wheel travel, before slip
+    const double leftTravel = leftSpeed * dt;
+    const double rightTravel = rightSpeed * dt;
+    // chassis travel, after slip
+    const double left = leftTravel * (1 - dist.leftSlip);
+    const double right = rightTravel * (1 - dist.rightSlip);
+    const double forward = (left + right) / 2;
+    const double deltaTheta = drive.trackWidth == 0 ? 0 : (left - right) / drive.trackWidth;
+    const double avgHeading = theta + deltaTheta / 2;
+    x += forward * std::sin(avgHeading);
+    y += forward * std::cos(avgHeading);
+    theta += deltaTheta;
+
+    // drive motor encoders follow the wheels
+    auto stepDriveMotors = [&](double travel, double speed, const std::vector<std::int8_t>& ports) {
+        for (std::int8_t port : ports) {
+            MotorState& state = motors.at(std::abs(port));
+            const double ratio = state.gearing / drive.rpm * 360 / (M_PI * drive.wheelDiameter);
+            state.position += travel * ratio * lemlib::sgn(port);
+            state.velocity = speed * ratio / 6 * lemlib::sgn(port);
+        }
+    };
+    stepDriveMotors(leftTravel, leftSpeed, drive.leftPorts);
+    stepDriveMotors(rightTravel, rightSpeed, drive.rightPorts);
+
+    // every other motor
+    for (MotorState& state : motors) {
+        if (!state.drive) stepMotor(state, dt);
+    }
+
+    // tracking wheels
+    for (const TrackingWheelModel& wheel : model.trackingWheels) {
+        const double travel = (wheel.horizontal ? 0 : forward) - wheel.offset * deltaTheta;
+        const double centidegrees = travel / (M_PI * wheel.diameter) * 36000 * wheel.gearRatio;
+        rotationTravel.at(std::abs(wheel.port)) += centidegrees * lemlib::sgn(wheel.port);
+        rotationSpeed.at(std::abs(wheel.port)) = centidegrees * lemlib::sgn(wheel.port) / dt;
+    }
+
+    // inertial sensor
+    imuTravel += lemlib::radToDeg(deltaTheta) * (1 + dist.imuScale);
+    imuError += dist.imuDrift * dt;
+
+    for (auto& hook : stepHooks) hook(dt);
+}
+} // namespace sim
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "lemlib/pose.hpp"
+
+namespace sim {
+/**
+ * @brief Physical description of a differential drivetrain
+ */
+struct DriveModel {
+        /** ports of the motors on the left side. Negative ports are reversed */
+        std::vector<std::int8_t> leftPorts;
+        /** ports of the motors on the right side. Negative ports are reversed */
+        std::vector<std::int8_t> rightPorts;
+        /** distance between the left and right wheels, in inches */
+        float trackWidth = 11;
+        /** wheel diameter, in inches */
+        float wheelDiameter = 2.75;
+        /** wheel rpm at full voltage */
+        float rpm = 600;
+        /** time constant of the first order response of each side, in seconds */
+        float timeConstant = 0.12;
+        /** time constant of a side coming to rest when braked, in seconds */
+        float brakeTimeConstant = 0.04;
+        /** time from a command to the motors acting on it, in seconds. Rounded to the physics step */
+        float commandDelay = 0;
+};
+
+/**
+ * @brief A tracking wheel attached to a rotation sensor
+ */
+struct TrackingWheelModel {
+        /** rotation sensor port. Negative ports are reversed */
+        std::int8_t port;
+        /** wheel diameter, in inches */
+        float diameter;
+        /** offset from the tracking center, using the same convention as lemlib::TrackingWheel */
+        float offset;
+        /** true if the wheel measures sideways motion */
+        bool horizontal;
+        /** gear ratio between the wheel and the sensor */
+        float gearRatio = 1;
+};
+
+/**
+ * @brief A rotation sensor that measures the shaft of a motor, e.g. an arm
+ */
+struct ShaftSensorModel {
+        /** rotation sensor port. Negative ports are reversed */
+        std::int8_t port;
+        /** motor port the sensor is geared to. The sign is ignored, motor state is stored per shaft */
+        std::int8_t motorPort;
+        /** sensor degrees per motor degree */
+        float ratio = 1;
+};
+
+/**
+ * @brief Everything that is plugged into the simulated brain
+ */
+struct RobotModel {
+        DriveModel drive;
+        std::vector<TrackingWheelModel> trackingWheels;
+        std::vector<ShaftSensorModel> shaftSensors;
+        /** inertial sensor port, 0 if there is no inertial sensor */
+        std::uint8_t imuPort = 0;
+};
+
+/**
+ * @brief Imperfections of the real world, all zero by default
+ *
+ * Tools sample these once per simulation, so each run is a different robot on a different field.
+ */
+struct Disturbances {
+        /** battery voltage, in volts. Motors can't output more than this */
+        float batteryVoltage = 12.8;
+        /** fraction of commanded wheel travel that is lost to slip on each side */
+        float leftSlip = 0;
+        float rightSlip = 0;
+        /** standard deviation of the noise added to each tracking wheel reading, in centidegrees */
+        float trackingNoise = 0;
+        /** standard deviation of the noise added to each inertial sensor reading, in degrees */
+        float imuNoise = 0;
+        /** inertial sensor drift, in degrees per second */
+        float imuDrift = 0;
+        /** inertial sensor scale error, e.g. 0.01 reports 1% too much rotation */
+        float imuScale = 0;
+        /** actual starting pose relative to the pose the routine assumes, heading in degrees */
+        lemlib::Pose startOffset = {0, 0, 0};
+};
+
+/**
+ * @brief State of a smart motor, as seen from its shaft
+ */
+struct MotorState {
+        enum class Mode { VOLTAGE, VELOCITY, POSITION, BRAKE };
+
+        Mode mode = Mode::VOLTAGE;
+        /** commanded voltage in millivolts, when in VOLTAGE mode */
+        double voltage = 0;
+        /** commanded velocity in rpm, when in VELOCITY mode */
+        double targetVelocity = 0;
+        /** commanded position in degrees, when in POSITION mode */
+        double targetPosition = 0;
+        /** velocity limit in rpm, when in POSITION mode */
+        double profileVelocity = 0;
+        /** free speed of the cartridge, in rpm */
+        double gearing = 200;
+        /** 0 coast, 1 brake, 2 hold */
+        int brakeMode = 0;
+        /** 0 degrees, 1 rotations, 2 counts */
+        int encoderUnits = 0;
+        /** shaft position, in degrees */
+        double position = 0;
+        /** position reported as zero, in degrees */
+        double zero = 0;
+        /** shaft velocity, in rpm */
+        double velocity = 0;
+        /** external load torque, in Nm. Set by a load model */
+        double load = 0;
+        /** torque the motor is producing, in Nm */
+        double torque = 0;
+        /** current limit, in mA */
+        std::int32_t currentLimit = 2500;
+        /** voltage limit, in mV. 0 is no limit */
+        std::int32_t voltageLimit = 0;
+        /** number of commands sent to the motor */
+        std::uint64_t writes = 0;
+        /** true if the motor is part of the drivetrain, whose motion is driven by the chassis model */
+        bool drive = false;
+};
+
+/**
+ * @brief State of a V5 controller, as scripted by a tool
+ */
+struct ControllerState {
+        /** joystick channels, -127 to 127, indexed by controller_analog_e_t */
+        std::array<std::int32_t, 4> analog {};
+        /** buttons, indexed by controller_digital_e_t - E_CONTROLLER_DIGITAL_L1 */
+        std::array<bool, 12> digital {};
+        /** text last written to each line of the screen */
+        std::array<std::string, 3> screen;
+        /** last rumble pattern sent */
+        std::string rumble;
+        /** number of rumbles sent */
+        std::uint64_t rumbles = 0;
+        /** number of screen and rumble writes */
+        std::uint64_t writes = 0;
+};
+
+/**
+ * @brief The simulated robot and field
+ *
+ * The world integrates the drivetrain and every motor at 1 kHz from a tick hook on the scheduler, and the PROS shim
+ * reads sensors and writes motor commands through it. All randomness comes from one seeded generator, so a run is
+ * fully determined by the model, the disturbances and the seed.
+ */
+class World {
+    public:
+        /**
+         * @brief Get the world for this process
+         */
+        static World& get();
+
+        /**
+         * @brief Set up the robot and start integrating
+         *
+         * @param model the robot
+         * @param disturbances imperfections to apply
+         * @param seed seed for sensor noise
+         */
+        void configure(const RobotModel& model, const Disturbances& disturbances = {}, std::uint64_t seed = 0);
+
+        /**
+         * @brief Move the robot without it noticing, like picking it up and putting it down
+         *
+         * @param pose the new pose, heading in degrees
+         */
+        void teleport(lemlib::Pose pose);
+
+        /**
+         * @brief Get the true pose of the robot, heading in degrees
+         */
+        lemlib::Pose pose() const;
+
+        /**
+         * @brief Get the true speed of each side of the drivetrain, in inches per second
+         */
+        std::array<float, 2> sideSpeeds() const;
+
+        /**
+         * @brief Get a motor by port. Ports are 1-21, the sign is ignored
+         */
+        MotorState& motor(std::int8_t port);
+
+        /**
+         * @brief Get the reading of a rotation sensor, in centidegrees
+         */
+        std::int32_t rotationPosition(std::uint8_t port);
+
+        /**
+         * @brief Get the velocity of a rotation sensor, in centidegrees per second
+         */
+        std::int32_t rotationVelocity(std::uint8_t port);
+
+        /**
+         * @brief Zero a rotation sensor
+         */
+        void resetRotation(std::uint8_t port);
+
+        /**
+         * @brief Get the inertial sensor rotation, in degrees, clockwise positive
+         */
+        double imuRotation();
+
+        /**
+         * @brief Zero the inertial sensor, as calibration does
+         */
+        void resetImu();
+
+        /**
+         * @brief Set how a distance sensor responds. The function returns a reading in mm
+         */
+        void setDistanceModel(std::uint8_t port, std::function<std::int32_t()> model);
+
+        /**
+         * @brief Read a distance sensor, in mm. 9999 if no model is set
+         */
+        std::int32_t distance(std::uint8_t port);
+
+        /**
+         * @brief Set how an optical sensor responds. The function returns {proximity, red, green, blue}
+         */
+        void setOpticalModel(std::uint8_t port, std::function<std::array<double, 4>()> model);
+
+        /**
+         * @brief Read an optical sensor as {proximity, red, green, blue}. Nothing in front of it by default
+         */
+        std::array<double, 4> optical(std::uint8_t port);
+
+        /**
+         * @brief Set the state of an ADI port
+         */
+        void setAdi(std::uint8_t port, std::int32_t value);
+
+        /**
+         * @brief Get the state of an ADI port
+         */
+        std::int32_t adi(std::uint8_t port);
+
+        /**
+         * @brief Get the state of a controller. 0 is the master controller, 1 the partner controller
+         */
+        ControllerState& controller(int id);
+
+        /**
+         * @brief Set the competition status, a combination of the COMPETITION_* flags
+         */
+        void setCompetitionStatus(std::uint8_t status);
+
+        /**
+         * @brief Get the competition status
+         */
+        std::uint8_t competitionStatus() const;
+
+        /**
+         * @brief Register a function called every physics step, after the robot has moved
+         *
+         * Used by tools to model mechanisms and game objects, e.g. loads on the intake.
+         */
+        void addStepHook(std::function<void(float dt)> hook);
+
+        /**
+         * @brief Get the random number generator used for noise
+         */
+        std::mt19937_64& random();
+
+        /**
+         * @brief Get the disturbances the world was configured with
+         */
+        const Disturbances& disturbances() const;
+    private:
+        World() = default;
+        void step(float dt);
+        void stepMotor(MotorState& motor, float dt);
+        float sideVoltage(const std::vector<std::int8_t>& ports) const;
+        float noise(float stddev);
+
+        RobotModel model;
+        Disturbances dist;
+        std::mt19937_64 rng;
+        std::array<MotorState, 22> motors;
+        std::array<double, 22> rotationTravel {};
+        std::array<double, 22> rotationZero {};
+        std::array<double, 22> rotationSpeed {};
+        std::array<std::int32_t, 27> adiValues {};
+        std::array<std::function<std::int32_t()>, 22> distanceModels;
+        std::array<std::function<std::array<double, 4>()>, 22> opticalModels;
+        std::array<ControllerState, 2> controllers;
+        std::uint8_t competition = 0;
+        std::vector<std::function<void(float)>> stepHooks;
+        // true pose, heading in radians clockwise from +y
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+        // side voltages commanded in the last commandDelay, oldest first
+        std::deque<std::array<float, 2>> pendingVoltages;
+        // speed of each side, in inches per second
+        double leftSpeed = 0;
+        double rightSpeed = 0;
+        // heading travelled since the inertial sensor was zeroed, in degrees
+        double imuTravel = 0;
+        double imuError = 0;
+        bool configured = false;
+};
+} // namespace sim
@@ -0,0 +1,148 @@
+// Lady brown arm moves, before and after lemlib::Mechanism.
+//
+// Runs every move the routines and the driver make with the arm on the simulated arm from sim/robot, once with the
+// PID and exit range controller main.cpp used before, and once with a lemlib::Mechanism with the settings in main.cpp.
+// For each move this prints when the arm first gets within 2 degrees of the target, how far it overshoots, where it is
+// 1.5s after the move started, and for the mechanism when it reports the target reached, which is what the routines
+// now wait for instead of a fixed delay.
+//
+// usage: arm
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// settings of the lady brown, from src/main.cpp
+extern lemlib::MechanismSettings armSettings;
+
+namespace {
+// lady brown motor and rotation sensor ports, from src/main.cpp
+constexpr std::int8_t MOTOR_PORT = 21;
+constexpr std::int8_t SENSOR_PORT = 17;
+// distance from the target that counts as there, in degrees
+constexpr float TOLERANCE = 2;
+// length of each move, in seconds
+constexpr float MOVE_TIME = 1.5;
+
+struct Move {
+        const char* name;
+        float from;
+        float to;
+        // whether the arm is held at the target, and the exit range of the old controller
+        bool hold;
+        float exitRange;
+};
+
+// the moves of the routines and the controller buttons, with the brake modes and exit ranges they used
+const std::vector<Move> MOVES = {
+    {"rest -> load", 0, 26, true, 0.2},       {"load -> wall stake", 26, 210, false, 40},
+    {"wall stake -> rest", 210, 0, false, 30}, {"rest -> preload", 0, 220, false, 5},
+    {"rest -> alliance stake", 0, 250, true, 10}, {"rest -> descore", 0, 180, true, 2},
+    {"load -> 60", 26, 60, true, 0.2},         {"rest -> hang", 0, 41, true, 1},
+};
+
+struct Result {
+        float arrival = -1; // seconds, -1 if never
+        float reached = -1;
+        float overshoot = 0; // degrees
+        float final = 0;
+};
+
+/**
+ * @brief The arm controller main.cpp used before: a P controller on the angle, and the motor's brake mode once the arm
+ * is within the exit range
+ */
+void oldUpdate(pros::Motor& motor, pros::Rotation& sensor, lemlib::PID& pid, const Move& move) {
+    float currentTheta = float(sensor.get_angle()) / 100;
+    if (currentTheta > 350) currentTheta = currentTheta - 360;
+    const float error = move.to - currentTheta;
+    if (std::fabs(error) > move.exitRange) motor.move_voltage(pid.update(error) * 100);
+    else motor.brake();
+}
+
+Result runMove(const Move& move, bool mechanism) {
+    sim::World& world = sim::World::get();
+    world.motor(MOTOR_PORT) = {};
+    world.motor(MOTOR_PORT).position = move.from;
+    pros::Motor motor(MOTOR_PORT, pros::MotorGearset::green);
+    pros::Rotation sensor(SENSOR_PORT);
+    motor.set_brake_mode(move.hold ? pros::E_MOTOR_BRAKE_HOLD : pros::E_MOTOR_BRAKE_COAST);
+    lemlib::MotorOutput output(&motor);
+    lemlib::Mechanism arm("arm", output.writer("arm", 0), &sensor, armSettings, 10);
+    lemlib::PID pid(1.6, 0, 0);
+    if (mechanism) {
+        motor.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
+        arm.moveTo(move.to, move.hold);
+    }
+
+    Result result;
+    const float direction = move.to > move.from ? 1 : -1;
+    const std::uint32_t start = pros::millis();
+    while (pros::millis() - start < MOVE_TIME * 1000) {
+        if (mechanism) arm.update();
+        else oldUpdate(motor, sensor, pid, move);
+        // sample between updates
+        for (int i = 0; i < 10; i++) {
+            const float time = (pros::millis() - start) / 1000.0f;
+            const float position = sensor.get_position() / 100.0f;
+            if (result.arrival < 0 && std::fabs(position - move.to) <= TOLERANCE) result.arrival = time;
+            if (result.reached < 0 && mechanism && arm.isReached()) result.reached = time;
+            result.overshoot = std::max(result.overshoot, (position - move.to) * direction);
+            pros::delay(1);
+        }
+    }
+    result.final = sensor.get_position() / 100.0f;
+    return result;
+}
+
+std::string seconds(float time) {
+    char text[16];
+    if (time < 0) return "never";
+    std::snprintf(text, sizeof(text), "%.2fs", time);
+    return text;
+}
+
+std::string run() {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    world.configure(sim::robotModel(), {}, 1);
+    sim::addMechanismModels();
+    std::ostringstream out;
+    sim::Scheduler::get().run(
+        [&] {
+            char line[200];
+            std::snprintf(line, sizeof(line), "%-24s %-10s %8s %8s %10s %8s\n", "move", "controller", "within",
+                          "reached", "overshoot", "at 1.5s");
+            out << line;
+            for (const Move& move : MOVES) {
+                for (bool mechanism : {false, true}) {
+                    const Result result = runMove(move, mechanism);
+                    std::snprintf(line, sizeof(line), "%-24s %-10s %8s %8s %9.1f° %7.1f°\n", mechanism ? "" : move.name,
+                                  mechanism ? "mechanism" : "old", seconds(result.arrival).c_str(),
+                                  mechanism ? seconds(result.reached).c_str() : "-", result.overshoot, result.final);
+                    out << line;
+                }
+            }
+        },
+        UINT64_MAX);
+    return out.str();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        std::fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+    const std::string result = sim::parallelMap(1, 1, [](int) { return run(); })[0];
+    std::printf("%s", result.c_str());
+    return result.empty();
+}
@@ -0,0 +1,320 @@
+// Microbenchmarks of LemLib hot paths.
+//
+// Times odometry updates, PID::update, ExpoDriveCurve::curve, angleError and sanitizeAngle, getCurvature, the pure
+// pursuit helpers on paths of 1000 and 10000 points, parsing a path asset with getData, and log calls, in nanoseconds
+// of host time per call. Each benchmark runs for about 50ms, 7 times, and reports the median and the fastest run.
+//
+// --json FILE writes the results as JSON, one benchmark per line, with the commit they were measured on. --compare
+// FILE reads an earlier result and prints the change of the fastest run of each benchmark, which is steadier than the
+// median on a busy computer; the exit code is 1 if one got slower by more than --threshold percent, 10 by default.
+// --repeat N runs the whole suite N times, one after the other, and reports the median of each benchmark over them,
+// which rides out the computer being busy for a few seconds. make bench-check compares against tools/bench.json.
+//
+// usage: bench [--filter TEXT] [--repeat N] [--json FILE] [--compare FILE] [--threshold PERCENT]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "lemlib/asset.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/logger/baseSink.hpp"
+#include "sim/parallel.hpp"
+#include "sim/scheduler.hpp"
+
+// the chassis of src/main.cpp
+extern lemlib::Chassis chassis;
+
+// pure pursuit helpers of src/lemlib/chassis/motions/pursuit.cpp
+std::vector<lemlib::Pose> getData(const asset& path);
+int findClosest(lemlib::Pose pose, std::vector<lemlib::Pose> path);
+float circleIntersect(lemlib::Pose p1, lemlib::Pose p2, lemlib::Pose pose, float lookaheadDist);
+lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, std::vector<lemlib::Pose> path, int closest,
+                            float lookaheadDist);
+
+namespace {
+// host time each run of a benchmark takes, in nanoseconds
+constexpr double RUN_TIME = 50e6;
+// runs of each benchmark
+constexpr int RUNS = 7;
+// calls between letting the logger task catch up
+constexpr int LOG_BATCH = 32;
+
+struct Result {
+        std::string name;
+        double median = 0; // nanoseconds per call
+        double fastest = 0;
+        long calls = 0; // calls per run
+};
+
+/**
+ * @brief Keep the compiler from optimizing a value away
+ */
+template <typename T> void keep(const T& value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+/**
+ * @brief Time a function, in nanoseconds per call
+ *
+ * @param call the function, called with the index of the call
+ */
+Result measure(const std::string& name, const std::function<void(long)>& call) {
+    auto time = [&](long calls) {
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < calls; i++) call(i);
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    };
+    // find how many calls take about RUN_TIME
+    long calls = 1;
+    double elapsed = time(calls);
+    while (elapsed < RUN_TIME / 10) {
+        calls *= 2;
+        elapsed = time(calls);
+    }
+    calls = std::max<long>(1, calls * RUN_TIME / elapsed);
+    std::vector<double> runs;
+    for (int i = 0; i < RUNS; i++) runs.push_back(time(calls) / calls);
+    std::sort(runs.begin(), runs.end());
+    return {name, runs[RUNS / 2], runs[0], calls};
+}
+
+/**
+ * @brief A sink that keeps the last message it was sent
+ */
+class CaptureSink : public lemlib::BaseSink {
+    public:
+        CaptureSink() {
+            setFormat("[LemLib] {level}: {message}");
+            setLowestLevel(lemlib::Level::INFO);
+        }
+
+        ~CaptureSink() { flush(); }
+
+        std::string last;
+    private:
+        void sendMessage(const lemlib::Message& message) override { last = message.message; }
+};
+
+/**
+ * @brief A path along a sine wave, half an inch between points
+ */
+std::vector<lemlib::Pose> wavePath(int points) {
+    std::vector<lemlib::Pose> path;
+    for (int i = 0; i < points; i++) path.push_back({i * 0.5f, 10 * std::sin(i * 0.05f), 60});
+    return path;
+}
+
+/**
+ * @brief A path file, as the path generator writes it
+ */
+std::string pathFile(const std::vector<lemlib::Pose>& path) {
+    std::string text;
+    char line[64];
+    for (const lemlib::Pose& point : path) {
+        std::snprintf(line, sizeof(line), "%.3f, %.3f, %.3f\n", point.x, point.y, point.theta);
+        text += line;
+    }
+    return text + "endData\n";
+}
+
+std::vector<Result> runAll(const std::string& filter) {
+    std::vector<Result> results;
+    auto add = [&](const std::string& name, const std::function<void(long)>& call) {
+        if (name.find(filter) != std::string::npos) results.push_back(measure(name, call));
+    };
+    sim::Scheduler::get().run(
+        [&] {
+            // odometry with the sensor layout of src/main.cpp, driving forwards and turning slowly. The odometry task
+            // starts too, but only runs when the logger benchmark sleeps
+            chassis.calibrate(false);
+            lemlib::resetOdom({0, 0, 0}, {});
+            lemlib::OdomSample sample {};
+            add("odom/update", [&](long i) {
+                sample.vertical1 += 0.1;
+                sample.vertical2 += 0.1;
+                sample.horizontal1 += 0.01;
+                sample.imu += 0.05;
+                lemlib::update(sample);
+            });
+
+            lemlib::PID pid(10, 0.1, 30, 5, true);
+            add("pid/update", [&](long i) { keep(pid.update(std::sin(i * 0.01f) * 20)); });
+
+            lemlib::ExpoDriveCurve curve(3, 10, 1.019);
+            add("driveCurve/expo", [&](long i) { keep(curve.curve(i % 255 - 127)); });
+
+            add("util/angleError", [&](long i) { keep(lemlib::angleError(i * 0.37f, i * -0.21f)); });
+            add("util/sanitizeAngle", [&](long i) { keep(lemlib::sanitizeAngle(i * 0.37f - 1000)); });
+            add("util/getCurvature", [&](long i) {
+                keep(lemlib::getCurvature({0, 0, i * 0.001f}, {10.0f + (i & 15), 20, 0}));
+            });
+
+            const std::vector<lemlib::Pose> segments = wavePath(1000);
+            add("pursuit/circleIntersect", [&](long i) {
+                keep(circleIntersect(segments[i % 999], segments[i % 999 + 1], {250, 2, 0}, 15));
+            });
+            for (int points : {1000, 10000}) {
+                const std::vector<lemlib::Pose> path = wavePath(points);
+                const std::string suffix = "/" + std::to_string(points);
+                // the robot halfway along the path, a little off to the side
+                const lemlib::Pose pose(points * 0.25f, 2, 0);
+                add("pursuit/findClosest" + suffix, [&](long i) { keep(findClosest(pose, path)); });
+                const int closest = findClosest(pose, path);
+                add("pursuit/lookaheadPoint" + suffix, [&](long i) {
+                    keep(lookaheadPoint({0, 0, float(closest)}, pose, path, closest, 15));
+                });
+                std::string file = pathFile(path);
+                const asset data {reinterpret_cast<std::uint8_t*>(file.data()), file.size()};
+                add("pursuit/getData" + suffix, [&](long i) { keep(getData(data).size()); });
+            }
+
+            // log calls and the logger task formatting and handing them to the sink, and a call filtered out by level
+            CaptureSink sink;
+            const float angularOut = 12.5;
+            const float lateralOut = -80.25;
+            add("logger/info", [&](long i) {
+                sink.info("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+                if (i % LOG_BATCH == LOG_BATCH - 1) pros::delay(60);
+            });
+            add("logger/filtered", [&](long i) { sink.debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut); });
+        },
+        UINT64_MAX);
+    return results;
+}
+
+std::string commit() {
+    std::string hash;
+    if (std::FILE* git = popen("git rev-parse --short HEAD 2>/dev/null", "r")) {
+        char line[64];
+        if (std::fgets(line, sizeof(line), git)) hash = line;
+        pclose(git);
+    }
+    hash.erase(std::remove(hash.begin(), hash.end(), '\n'), hash.end());
+    return hash.empty() ? "unknown" : hash;
+}
+
+std::string toJson(const std::vector<Result>& results) {
+    std::ostringstream out;
+    out << "{\"commit\": \"" << commit() << "\", \"unit\": \"ns\", \"benchmarks\": [\n";
+    char line[256];
+    for (std::size_t i = 0; i < results.size(); i++) {
+        std::snprintf(line, sizeof(line), "  {\"name\": \"%s\", \"median\": %.3f, \"fastest\": %.3f, \"calls\": %ld}%s\n",
+                      results[i].name.c_str(), results[i].median, results[i].fastest, results[i].calls,
+                      i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "]}\n";
+    return out.str();
+}
+
+/**
+ * @brief Read the fastest runs back from a file toJson wrote
+ */
+std::map<std::string, double> fromJson(const std::string& path) {
+    std::ifstream file(path);
+    std::map<std::string, double> fastest;
+    std::string line;
+    while (std::getline(file, line)) {
+        const std::size_t name = line.find("\"name\": \"");
+        const std::size_t time = line.find("\"fastest\": ");
+        if (name == std::string::npos || time == std::string::npos) continue;
+        const std::size_t start = name + 9;
+        fastest[line.substr(start, line.find('"', start) - start)] = std::stod(line.substr(time + 11));
+    }
+    return fastest;
+}
+
+std::string serialize(const std::vector<Result>& results) {
+    std::ostringstream out;
+    for (const Result& result : results)
+        out << result.name << ' ' << result.median << ' ' << result.fastest << ' ' << result.calls << '\n';
+    return out.str();
+}
+
+std::vector<Result> deserialize(const std::string& text) {
+    std::istringstream in(text);
+    std::vector<Result> results;
+    Result result;
+    while (in >> result.name >> result.median >> result.fastest >> result.calls) results.push_back(result);
+    return results;
+}
+
+/**
+ * @brief Combine repeats of the suite, taking the median of each benchmark over them
+ */
+std::vector<Result> combine(const std::vector<std::vector<Result>>& repeats) {
+    std::vector<Result> results = repeats.front();
+    for (std::size_t i = 0; i < results.size(); i++) {
+        std::vector<double> medians;
+        std::vector<double> fastest;
+        for (const std::vector<Result>& repeat : repeats) {
+            if (i >= repeat.size()) continue;
+            medians.push_back(repeat[i].median);
+            fastest.push_back(repeat[i].fastest);
+        }
+        std::sort(medians.begin(), medians.end());
+        std::sort(fastest.begin(), fastest.end());
+        results[i].median = medians[medians.size() / 2];
+        results[i].fastest = fastest[fastest.size() / 2];
+    }
+    return results;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string json;
+    std::string compare;
+    double threshold = 10;
+    int repeat = 1;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--json" && i + 1 < argc) json = argv[++i];
+        else if (arg == "--compare" && i + 1 < argc) compare = argv[++i];
+        else if (arg == "--threshold" && i + 1 < argc) threshold = std::stod(argv[++i]);
+        else {
+            std::fprintf(stderr,
+                         "usage: %s [--filter TEXT] [--repeat N] [--json FILE] [--compare FILE] [--threshold PERCENT]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    // the robot code prints while it is set up, keep it out of the results. One repeat at a time, so they don't
+    // compete for the computer
+    std::vector<std::vector<Result>> repeats;
+    for (const std::string& output : sim::parallelMap(repeat, 1, [&](int) {
+             std::freopen("/dev/null", "w", stdout);
+             return serialize(runAll(filter));
+         })) {
+        repeats.push_back(deserialize(output));
+        if (repeats.back().empty()) {
+            std::fprintf(stderr, "no benchmarks ran\n");
+            return 1;
+        }
+    }
+    const std::vector<Result> results = combine(repeats);
+
+    const std::map<std::string, double> previous = compare.empty() ? std::map<std::string, double>() : fromJson(compare);
+    bool slower = false;
+    std::printf("%-32s %12s %12s %12s\n", "benchmark", "median ns", "fastest ns", "calls");
+    for (const Result& result : results) {
+        std::printf("%-32s %12.2f %12.2f %12ld", result.name.c_str(), result.median, result.fastest, result.calls);
+        const auto before = previous.find(result.name);
+        if (before != previous.end() && before->second > 0) {
+            const double change = (result.fastest / before->second - 1) * 100;
+            std::printf("  %+6.1f%%%s", change, change > threshold ? "  slower" : "");
+            slower |= change > threshold;
+        }
+        std::printf("\n");
+    }
+    if (!json.empty()) std::ofstream(json) << toJson(results);
+    return slower;
+}
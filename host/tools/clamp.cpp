@@ -0,0 +1,155 @@
+// Clamping a goal, before and after lemlib::Trigger.
+//
+// Backs the simulated robot into a goal at the speeds the routines use, once with the clamp main.cpp used before (the
+// goal in reach on the clamp sensor, then 250ms to settle) and once with clampTrigger and the Clamp subsystem in
+// main.cpp. For each this prints how long after the goal came in reach the clamp closed, and how far the robot had
+// driven on by then, pushing the goal ahead of it.
+//
+// usage: clamp
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// robot, from src/main.cpp
+extern lemlib::Chassis chassis;
+extern lemlib::Trigger clampTrigger;
+extern pros::adi::DigitalOut clamp;
+extern lemlib::State<bool> clampOn;
+
+namespace {
+// distance sensor on the clamp, how close the robot has to get to a goal for it to see the goal, and how close it reads
+// the goal in reach, from sweep.cpp and the clamp main.cpp used before
+constexpr std::uint8_t CLAMP_SENSOR_PORT = 5;
+constexpr float CLAMP_RANGE = 3; // inches
+constexpr std::int32_t IN_REACH = 25; // mm
+// ADI port of the clamp piston, 'F'
+constexpr std::uint8_t CLAMP_PORT = 6;
+// time initialize() takes to calibrate, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+// where the goal is, straight behind the robot
+constexpr float GOAL_DISTANCE = 24; // inches
+
+// maximum speeds the routines back into goals with
+const std::vector<int> SPEEDS = {40, 60, 110};
+
+struct Result {
+        float closed = -1; // seconds from in reach, -1 if never
+        float travel = 0; // inches driven from in reach to closed
+};
+
+/**
+ * @brief The clamp main.cpp used before: once the goal is in reach, wait 250ms and close
+ */
+void oldClamp(pros::Distance& sensor, bool& closed) {
+    bool closing = false;
+    std::uint32_t closingSince = 0;
+    while (true) {
+        const std::uint32_t now = pros::millis();
+        if (closing && now - closingSince >= 250) {
+            clamp.set_value(true);
+            closed = true;
+            return;
+        }
+        if (!closing && sensor.get_distance() < IN_REACH) {
+            closing = true;
+            closingSince = now;
+        }
+        pros::delay(10);
+    }
+}
+
+Result simulate(int speed, bool trigger) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, 1);
+    world.setDistanceModel(CLAMP_SENSOR_PORT, [&world] {
+        const float distance = world.pose().distance({0, -GOAL_DISTANCE});
+        return std::int32_t(std::max(0.0f, distance - CLAMP_RANGE) * 25.4f);
+    });
+
+    Result result;
+    // when the goal came in reach and the clamp closed, and where the robot was
+    std::uint64_t inReach = 0;
+    float inReachY = 0;
+    std::uint64_t closedAt = 0;
+    float closedY = 0;
+    world.addStepHook([&](float) {
+        if (inReach == 0 && world.distance(CLAMP_SENSOR_PORT) < IN_REACH) {
+            inReach = scheduler.now();
+            inReachY = world.pose().y;
+        }
+        if (closedAt == 0 && world.adi(CLAMP_PORT)) {
+            closedAt = scheduler.now();
+            closedY = world.pose().y;
+        }
+    });
+
+    scheduler.run(
+        [&] {
+            pros::Distance sensor(CLAMP_SENSOR_PORT);
+            bool closed = false;
+            if (trigger) initialize();
+            else pros::delay(CALIBRATION_TIME * 1000);
+            chassis.setPose(0, 0, 0);
+            chassis.moveToPoint(0, -GOAL_DISTANCE, 3000, {.forwards = false, .maxSpeed = float(speed)});
+            if (trigger) {
+                clampOn = true;
+                clampTrigger.waitUntilFired();
+            } else {
+                scheduler.spawn([&] { oldClamp(sensor, closed); }, TASK_PRIORITY_DEFAULT, "old clamp");
+                while (!closed) pros::delay(10);
+            }
+            chassis.cancelMotion();
+            if (inReach == 0 || closedAt == 0) return;
+            result.closed = (closedAt - inReach) / 1e6f;
+            result.travel = std::fabs(closedY - inReachY);
+        },
+        (CALIBRATION_TIME + 5) * 1e6);
+    return result;
+}
+
+std::string serialize(const Result& result) {
+    std::ostringstream out;
+    out << result.closed << ' ' << result.travel;
+    return out.str();
+}
+
+Result deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Result result;
+    in >> result.closed >> result.travel;
+    return result;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        std::fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+    const int jobs = SPEEDS.size() * 2;
+    const std::vector<std::string> output =
+        sim::parallelMap(jobs, jobs, [](int job) { return serialize(simulate(SPEEDS[job / 2], job % 2)); });
+
+    std::printf("%-6s %-8s %10s %10s\n", "speed", "clamp", "closed", "travel");
+    bool failed = false;
+    for (int job = 0; job < jobs; job++) {
+        const Result result = deserialize(output[job]);
+        if (output[job].empty() || result.closed < 0) failed = true;
+        char speed[8];
+        std::snprintf(speed, sizeof(speed), "%d", SPEEDS[job / 2]);
+        std::printf("%-6s %-8s %8.0fms %8.1fin\n", job % 2 ? "" : speed, job % 2 ? "trigger" : "old",
+                    result.closed * 1000, result.travel);
+    }
+    return failed;
+}
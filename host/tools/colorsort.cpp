@@ -0,0 +1,273 @@
+// Color sort accuracy and cycle time.
+//
+// Feeds a stream of red and blue rings up the simulated intake, past the optical sensor to the top of intake1's hooks.
+// A ring at the top goes into the goal, unless intake1 reverses while the ring is at the top, which throws it off.
+// Each run is sorted either by the ColorSort subsystem in src/main.cpp, or by the fixed 150ms delay and 200ms reversal
+// it replaced, which is reproduced here with the optical sensor at its default integration time. The intake runs at
+// full speed, slowed by a constant load, or with the load pulsing on and off like rings dragging in the intake.
+//
+// For each condition and sorter this prints how many blue rings were thrown off, how many red ones were thrown off
+// by mistake, and the time each blue ring adds to the stream compared to the same rings all red.
+//
+// usage: colorsort [--runs N] [--rings N] [--seed N] [--workers N]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// robot state, from src/main.cpp
+extern lemlib::State<char> team_color;
+extern lemlib::State<bool> intake_on;
+
+namespace {
+constexpr std::uint8_t OPTICAL_PORT = 18;
+constexpr std::int8_t INTAKE1_PORT = 11;
+constexpr std::int8_t INTAKE2_PORT = 20;
+// time initialize() takes to calibrate, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+// longest a run may take, in seconds
+constexpr float RUN_LIMIT = 60;
+
+// where rings are on the hooks, in degrees of intake1 travel from where the optical sensor first sees them: where they
+// are picked up from the first stage, how far apart, how long the sensor sees them for, the top where they are thrown
+// off if intake1 reverses, and how far past the top they drop into the goal
+constexpr double ENTRY = -200;
+constexpr double SPACING = 450;
+constexpr double VIEW = 80;
+constexpr double TOP = 540;
+constexpr double THROW_WINDOW = 60;
+constexpr double RELEASE = 60;
+// how far a ring sits from where it should on its hook, in degrees of travel
+constexpr double SEATING = 10;
+
+enum class Sorter { OLD, NEW };
+enum class Condition { FULL_SPEED, SLOWED, PULSING };
+
+constexpr const char* CONDITION_NAMES[] = {"full speed", "slowed", "pulsing"};
+
+struct Ring {
+        double position;
+        double seating;
+        bool blue;
+};
+
+struct Stream {
+        std::vector<bool> colors; // true for blue, in the order they are fed
+        std::size_t fed = 0;
+        std::vector<Ring> onHooks;
+        int blueThrown = 0;
+        int redThrown = 0;
+        int scored = 0;
+        double lastVelocity = 0;
+        bool done = false;
+        std::uint64_t finishedAt = 0;
+};
+
+struct Result {
+        int blue = 0;
+        int blueThrown = 0;
+        int redThrown = 0;
+        float time = 0; // seconds from the first ring to the last leaving the hooks
+};
+
+/**
+ * @brief The color sort main.cpp used before: on a blue ring wait 150ms, then reverse intake1 for 200ms
+ */
+void oldSorter(pros::Motor& intake1, pros::Motor& intake2, pros::Optical& optical) {
+    bool rejecting = false;
+    bool flicked = false;
+    std::uint32_t rejectSince = 0;
+    while (true) {
+        const std::uint32_t now = pros::millis();
+        if (rejecting) {
+            const std::uint32_t elapsed = now - rejectSince;
+            if (elapsed >= 150 && !flicked) {
+                intake1.move(120);
+                flicked = true;
+            }
+            if (elapsed < 350) {
+                pros::delay(10);
+                continue;
+            }
+            rejecting = false;
+        }
+        const auto k = optical.get_proximity();
+        const auto c = optical.get_rgb();
+        if ((k > 100 && c.brightness > 0.05) && (c.red > c.blue) == (team_color == 'B')) {
+            rejecting = true;
+            flicked = false;
+            rejectSince = now;
+        } else {
+            intake1.move(-127);
+            intake2.move(127);
+        }
+        pros::delay(10);
+    }
+}
+
+Result simulate(Sorter sorter, Condition condition, bool mixed, int rings, std::uint64_t seed) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, seed);
+
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution color(0.5);
+    std::normal_distribution<double> seating(0, SEATING);
+    auto stream = std::make_shared<Stream>();
+    for (int i = 0; i < rings; i++) stream->colors.push_back(mixed && color(rng));
+    std::vector<double> seatings;
+    for (int i = 0; i < rings; i++) seatings.push_back(seating(rng));
+
+    world.setOpticalModel(OPTICAL_PORT, [stream] {
+        for (const Ring& ring : stream->onHooks) {
+            if (ring.position + ring.seating < 0 || ring.position + ring.seating > VIEW) continue;
+            if (ring.blue) return std::array<double, 4> {200, 40, 60, 200};
+            return std::array<double, 4> {200, 200, 40, 40};
+        }
+        return std::array<double, 4> {0, 0, 0, 0};
+    });
+    // the load slows intake1 to about 70%, the pulses come every 400ms and last 150ms
+    const double load = condition == Condition::FULL_SPEED ? 0 : 0.1;
+    world.addStepHook([stream, seatings, condition, load, &world, &scheduler](float dt) {
+        sim::MotorState& motor = world.motor(INTAKE1_PORT);
+        const std::uint64_t now = scheduler.now();
+        motor.load = condition == Condition::PULSING && now / 1000 % 400 >= 150 ? 0 : load;
+        if (stream->done) return;
+        // positive shaft velocity carries rings up
+        const double travel = motor.velocity * 6 * dt;
+        const bool reversed = stream->lastVelocity > 0 && motor.velocity < 0;
+        stream->lastVelocity = motor.velocity;
+        for (Ring& ring : stream->onHooks) ring.position += travel;
+        auto leaving = [&](const Ring& ring) {
+            if (reversed && std::fabs(ring.position - TOP) <= THROW_WINDOW) {
+                (ring.blue ? stream->blueThrown : stream->redThrown)++;
+                return true;
+            }
+            if (ring.position > TOP + RELEASE) {
+                stream->scored++;
+                return true;
+            }
+            return false;
+        };
+        stream->onHooks.erase(std::remove_if(stream->onHooks.begin(), stream->onHooks.end(), leaving),
+                              stream->onHooks.end());
+        // the first stage hands the next ring over once there is room on the hooks
+        const bool room = stream->onHooks.empty() || stream->onHooks.back().position >= ENTRY + SPACING;
+        if (stream->fed < stream->colors.size() && room && travel > 0) {
+            stream->onHooks.push_back({ENTRY, seatings[stream->fed], stream->colors[stream->fed]});
+            stream->fed++;
+        }
+        if (stream->fed == stream->colors.size() && stream->onHooks.empty()) {
+            stream->done = true;
+            stream->finishedAt = now;
+        }
+    });
+
+    Result result;
+    scheduler.run(
+        [&] {
+            team_color = 'R';
+            pros::Motor intake1(-INTAKE1_PORT, pros::MotorGearset::blue);
+            pros::Motor intake2(-INTAKE2_PORT, pros::MotorGearset::green);
+            pros::Optical optical(OPTICAL_PORT);
+            if (sorter == Sorter::NEW) {
+                initialize();
+                intake_on = true;
+            } else {
+                pros::delay(CALIBRATION_TIME * 1000);
+                scheduler.spawn([&] { oldSorter(intake1, intake2, optical); }, TASK_PRIORITY_DEFAULT, "old sorter");
+            }
+            const std::uint64_t start = scheduler.now();
+            while (!stream->done && scheduler.now() - start < RUN_LIMIT * 1e6) pros::delay(10);
+            result.time = ((stream->done ? stream->finishedAt : scheduler.now()) - start) / 1e6;
+        },
+        (CALIBRATION_TIME + RUN_LIMIT + 1) * 1e6);
+    for (bool blue : stream->colors) result.blue += blue;
+    result.blueThrown = stream->blueThrown;
+    result.redThrown = stream->redThrown;
+    return result;
+}
+
+std::string serialize(const Result& result) {
+    std::ostringstream out;
+    out << result.blue << ' ' << result.blueThrown << ' ' << result.redThrown << ' ' << result.time;
+    return out.str();
+}
+
+Result deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Result result;
+    in >> result.blue >> result.blueThrown >> result.redThrown >> result.time;
+    return result;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int runs = 4;
+    int rings = 40;
+    std::uint64_t seed = 1;
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) runs = std::stoi(argv[++i]);
+        else if (arg == "--rings" && i + 1 < argc) rings = std::stoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i]);
+        else if (arg == "--workers" && i + 1 < argc) workers = std::stoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--runs N] [--rings N] [--seed N] [--workers N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // every condition and sorter, each run once with mixed rings and once with the same rings all red
+    constexpr int CONDITIONS = 3;
+    constexpr int SORTERS = 2;
+    const int jobs = CONDITIONS * SORTERS * runs * 2;
+    const std::vector<std::string> output = sim::parallelMap(jobs, workers, [&](int job) {
+        const bool mixed = job % 2 == 0;
+        const int run = job / 2 % runs;
+        const auto sorter = Sorter(job / 2 / runs % SORTERS);
+        const auto condition = Condition(job / 2 / runs / SORTERS);
+        return serialize(simulate(sorter, condition, mixed, rings, seed + run));
+    });
+
+    std::printf("%-12s %-8s %12s %14s %16s\n", "intake", "sorter", "blue thrown", "red thrown", "ms per blue");
+    bool failed = false;
+    for (int condition = 0; condition < CONDITIONS; condition++) {
+        for (int sorter = 0; sorter < SORTERS; sorter++) {
+            Result mixed;
+            Result red;
+            for (int run = 0; run < runs; run++) {
+                const int job = ((condition * SORTERS + sorter) * runs + run) * 2;
+                if (output[job].empty() || output[job + 1].empty()) failed = true;
+                const Result a = deserialize(output[job]);
+                const Result b = deserialize(output[job + 1]);
+                mixed.blue += a.blue;
+                mixed.blueThrown += a.blueThrown;
+                mixed.redThrown += a.redThrown;
+                mixed.time += a.time;
+                red.time += b.time;
+            }
+            const int redRings = runs * rings - mixed.blue;
+            char thrown[32];
+            std::snprintf(thrown, sizeof(thrown), "%d/%d", mixed.redThrown, redRings);
+            std::printf("%-12s %-8s %6.1f%% %5d %14s %16.0f\n", CONDITION_NAMES[condition], sorter ? "new" : "old",
+                        mixed.blue ? 100.0 * mixed.blueThrown / mixed.blue : 0.0, mixed.blue, thrown,
+                        mixed.blue ? (mixed.time - red.time) * 1000 / mixed.blue : 0.0);
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,169 @@
+// Controller screen and rumble, before and after lemlib::ControllerScreen.
+//
+// For 20s, a display loop shows three lines on the simulated controller every 20ms: one that changes every second,
+// one every 100ms and one every 500ms. Rumbles come every 2s or so, some of them two at once, like calibration ending
+// as something else rumbles. Once with the loop and the rumbles writing to the controller straight away, and once
+// through a lemlib::ControllerScreen. Prints the writes sent and refused by the controller, the rumbles that got
+// through, and for each line how much of the time the controller showed old text, and for how long at most.
+//
+// usage: controllerscreen
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+namespace {
+// how long to run, in seconds
+constexpr float DURATION = 20;
+// time between updates of the display loop, in milliseconds
+constexpr std::uint32_t DISPLAY_PERIOD = 20;
+// time between changes of each line, in milliseconds
+const std::vector<std::uint32_t> LINE_PERIODS = {1000, 100, 500};
+// time between rumbles, in milliseconds
+constexpr int MIN_RUMBLE_GAP = 1000;
+constexpr int MAX_RUMBLE_GAP = 3000;
+
+struct Result {
+        int attempted = 0; // writes sent to the controller
+        int refused = 0;
+        int rumbles = 0; // rumbles asked for
+        int rumbled = 0; // rumbles the controller got
+        std::vector<float> staleTime = std::vector<float>(3, 0); // seconds each line showed old text
+        std::vector<float> maxStale = std::vector<float>(3, 0); // longest stretch, in ms
+};
+
+/**
+ * @brief The text of a line at a time: a counter that goes up every period
+ */
+std::string lineText(int line, std::uint32_t now) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "line %d: %u", line, now / LINE_PERIODS[line]);
+    return text;
+}
+
+std::string trimmed(std::string text) {
+    text.erase(text.find_last_not_of(' ') + 1);
+    return text;
+}
+
+Result simulate(bool screen) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, 1);
+
+    Result result;
+    // when each line last started showing old text, 0 if it shows the latest
+    std::vector<std::uint64_t> staleSince(3, 0);
+    world.addStepHook([&](float dt) {
+        const std::uint64_t now = scheduler.now();
+        for (int line = 0; line < 3; line++) {
+            const bool stale = trimmed(world.controller(0).screen[line]) != lineText(line, now / 1000);
+            if (!stale) {
+                staleSince[line] = 0;
+                continue;
+            }
+            if (staleSince[line] == 0) staleSince[line] = now;
+            result.staleTime[line] += dt;
+            result.maxStale[line] = std::max(result.maxStale[line], (now - staleSince[line]) / 1000.0f);
+        }
+    });
+
+    scheduler.run(
+        [&] {
+            lemlib::ControllerScreen controllerScreen("controller screen");
+            lemlib::SubsystemScheduler subsystems(5);
+            if (screen) subsystems.add(controllerScreen);
+            const std::uint64_t start = scheduler.now();
+            auto rumble = [&](const char* pattern) {
+                result.rumbles++;
+                if (screen) lemlib::rumbleController(pattern);
+                else {
+                    result.attempted++;
+                    if (pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, pattern) == PROS_ERR) result.refused++;
+                }
+            };
+            scheduler.spawn(
+                [&] {
+                    std::uniform_int_distribution<int> gap(MIN_RUMBLE_GAP, MAX_RUMBLE_GAP);
+                    while (true) {
+                        pros::delay(gap(world.random()));
+                        rumble("-");
+                        // every other rumble comes with another
+                        if (world.random()() % 2) {
+                            pros::delay(10);
+                            rumble(".");
+                        }
+                    }
+                },
+                TASK_PRIORITY_DEFAULT, "rumbles");
+            while (scheduler.now() - start < DURATION * 1e6) {
+                for (int line = 0; line < 3; line++) {
+                    const std::string text = lineText(line, pros::millis());
+                    if (screen) controllerScreen.setText(line, text);
+                    else {
+                        result.attempted++;
+                        if (pros::c::controller_set_text(pros::E_CONTROLLER_MASTER, line, 0, text.c_str()) ==
+                            PROS_ERR)
+                            result.refused++;
+                    }
+                }
+                pros::delay(DISPLAY_PERIOD);
+            }
+            if (screen) {
+                result.attempted = controllerScreen.getWrites() + controllerScreen.getRefused();
+                result.refused = controllerScreen.getRefused();
+            }
+            result.rumbled = world.controller(0).rumbles;
+        },
+        (DURATION + 1) * 1e6);
+    return result;
+}
+
+std::string serialize(const Result& result) {
+    std::ostringstream out;
+    out << result.attempted << ' ' << result.refused << ' ' << result.rumbles << ' ' << result.rumbled;
+    for (int line = 0; line < 3; line++) out << ' ' << result.staleTime[line] << ' ' << result.maxStale[line];
+    return out.str();
+}
+
+Result deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Result result;
+    in >> result.attempted >> result.refused >> result.rumbles >> result.rumbled;
+    for (int line = 0; line < 3; line++) in >> result.staleTime[line] >> result.maxStale[line];
+    return result;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        std::fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+    const std::vector<std::string> output =
+        sim::parallelMap(2, 2, [](int job) { return serialize(simulate(job == 1)); });
+
+    std::printf("%-8s %8s %8s %9s   %-14s %-14s %-14s\n", "writes", "sent", "refused", "rumbles", "line 0 stale",
+                "line 1 stale", "line 2 stale");
+    bool failed = false;
+    for (int job = 0; job < 2; job++) {
+        if (output[job].empty()) failed = true;
+        const Result result = deserialize(output[job]);
+        std::printf("%-8s %8d %8d %4d/%-4d", job ? "screen" : "direct", result.attempted, result.refused,
+                    result.rumbled, result.rumbles);
+        for (int line = 0; line < 3; line++)
+            std::printf("   %4.1f%% %5.0fms", 100 * result.staleTime[line] / DURATION, result.maxStale[line]);
+        std::printf("\n");
+    }
+    return failed;
+}
@@ -0,0 +1,130 @@
+// Field view cost report.
+//
+// Runs the skills routine, or another with --routine, on the robot in sim/robot for 60 seconds with the
+// lemlib::FieldView in main.cpp drawing it, and prints the frames drawn, how many redrew the whole field and how much of
+// the canvas each frame invalidated, next to the whole canvas a view redrawing everything every frame would. Then
+// replays the poses of the run into a new pose history and field view, on a lemlib::VirtualClock, and times a frame in
+// host time, drawn incrementally and drawn whole. The LVGL calls do nothing on the host, so only the drawing into the
+// canvas buffer is timed, not LVGL flushing the invalidated area to the screen.
+//
+// usage: fieldview [--routine NAME]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "lemlib/fieldView.hpp"
+#include "main.h"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/selector.hpp"
+#include "sim/world.hpp"
+
+extern lemlib::Chassis chassis;
+extern lemlib::PoseHistory poseHistory;
+extern lemlib::FieldView fieldView;
+
+namespace {
+// time initialize() takes to calibrate before autonomous starts, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+// length of the run, in seconds
+constexpr float PERIOD = 60;
+// time between poses recorded for the replay, and between frames of the replay, in milliseconds. The periods of the
+// pose history and the field view in main.cpp
+constexpr std::uint32_t SAMPLE_PERIOD = 20;
+constexpr std::uint32_t FRAME_PERIOD = 100;
+
+/**
+ * @brief Replay poses into a new history and view, and time each frame in host time, in microseconds on average
+ *
+ * @param whole redraw the whole field every frame
+ */
+double replay(const std::vector<lemlib::Pose>& poses, bool whole) {
+    lemlib::VirtualClock clock;
+    lemlib::setClock(&clock);
+    std::size_t next = 0;
+    lemlib::PoseHistory history("replay history", [&] { return poses[next]; }, 1);
+    lemlib::FieldView view("replay", &history);
+    std::chrono::duration<double, std::micro> time(0);
+    int frames = 0;
+    while (next < poses.size()) {
+        for (std::uint32_t t = 0; t < FRAME_PERIOD && next < poses.size(); t += SAMPLE_PERIOD, next++) {
+            clock.advance(SAMPLE_PERIOD * 1000);
+            history.update();
+        }
+        // an empty path changes nothing drawn, but makes the next frame draw the whole field
+        if (whole) view.setPath({});
+        const auto start = std::chrono::steady_clock::now();
+        view.update();
+        time += std::chrono::steady_clock::now() - start;
+        frames++;
+    }
+    lemlib::setClock(nullptr);
+    return time.count() / frames;
+}
+
+std::string run(const std::string& routine) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, 1);
+    sim::addMechanismModels();
+    std::ostringstream out;
+    scheduler.run(
+        [&] {
+            initialize();
+            world.setCompetitionStatus(COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED);
+            sim::selectRoutine(routine);
+            const std::uint32_t frames = fieldView.getFrames();
+            const std::uint64_t dirty = fieldView.getDirtyPixels();
+            const std::uint32_t fullRedraws = fieldView.getFullRedraws();
+            const std::uint32_t samples = poseHistory.getSamples();
+            const std::uint32_t kept = poseHistory.getSequence();
+            const std::uint64_t start = scheduler.now();
+            scheduler.spawn([&] { autonomous(); }, TASK_PRIORITY_DEFAULT, "autonomous");
+            std::vector<lemlib::Pose> poses;
+            while (scheduler.now() - start < PERIOD * 1e6) {
+                poses.push_back(chassis.getPose());
+                pros::delay(SAMPLE_PERIOD);
+            }
+            out << fieldView.getFrames() - frames << ' ' << fieldView.getDirtyPixels() - dirty << ' '
+                << fieldView.getFullRedraws() - fullRedraws << ' ' << poseHistory.getSamples() - samples << ' '
+                << poseHistory.getSequence() - kept << ' ' << replay(poses, false) << ' ' << replay(poses, true);
+        },
+        (CALIBRATION_TIME + PERIOD + 1) * 1e6);
+    return out.str();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string routine = "Skills Auto";
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--routine" && i + 1 < argc) routine = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--routine NAME]\n", argv[0]);
+            return 1;
+        }
+    }
+    const std::string output = sim::parallelMap(1, 1, [&](int) { return run(routine); })[0];
+    if (output.empty()) return 1;
+    std::istringstream in(output);
+    std::uint32_t frames, fullRedraws, samples, kept;
+    std::uint64_t dirty;
+    double incremental, whole;
+    in >> frames >> dirty >> fullRedraws >> samples >> kept >> incremental >> whole;
+
+    const double canvas = double(lemlib::FieldView::SIZE) * lemlib::FieldView::SIZE;
+    std::printf("%s, %.0fs:\n", routine.c_str(), PERIOD);
+    std::printf("pose history  %u samples, %u poses kept\n", samples, kept);
+    std::printf("frames        %u, %u of them redrawing the whole field\n", frames, fullRedraws);
+    std::printf("invalidated   %.1f%% of the canvas per frame, %.0f pixels (whole field every frame: 100%%, %.0f)\n",
+                100 * dirty / (canvas * std::max<std::uint32_t>(frames, 1)),
+                double(dirty) / std::max<std::uint32_t>(frames, 1), canvas);
+    std::printf("frame time    %.1fus incremental, %.1fus whole, host time\n", incremental, whole);
+    return 0;
+}
@@ -0,0 +1,252 @@
+// Controller input, before and after lemlib::ControllerInput.
+//
+// Taps buttons on the simulated controller, 200 taps each of 15, 30 and 60ms, and has them read by the loops that read
+// buttons on the robot: the driver loop every 10ms, the hang every 20ms, and a button watched by both. Once with each
+// loop calling get_digital_new_press itself, as main.cpp used to, and once with a lemlib::ControllerInput sampling the
+// controller every 5ms into a queue for each loop. For each loop this prints how many taps it missed, and how long
+// after the tap started the loop saw it.
+//
+// Then runs driver control in main.cpp, taps Y to work the clamp, and prints how many taps worked it and how long the
+// clamp took to move, with the latency the sampler's queue measured itself.
+//
+// usage: input
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// robot, from src/main.cpp
+extern pros::Controller controller;
+extern lemlib::ControllerInput controllerInput;
+lemlib::InputQueue& driverButtons();
+
+namespace {
+// length of the taps, in milliseconds
+const std::vector<int> TAPS = {15, 30, 60};
+// taps of each length
+constexpr int TAP_COUNT = 200;
+// time between the end of a tap and the start of the next, in milliseconds
+constexpr int MIN_GAP = 100;
+constexpr int MAX_GAP = 300;
+// ADI port of the clamp piston, 'F'
+constexpr std::uint8_t CLAMP_PORT = 6;
+// time initialize() takes to calibrate, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+
+// a loop reading a button, and how often it runs
+struct Loop {
+        const char* name;
+        pros::controller_digital_e_t button;
+        std::uint32_t period;
+};
+
+// the driver loop, the hang, and both of them watching the same button
+const std::vector<Loop> LOOPS = {{"driver, Y", pros::E_CONTROLLER_DIGITAL_Y, 10},
+                                 {"hang, X", pros::E_CONTROLLER_DIGITAL_X, 20},
+                                 {"driver, A", pros::E_CONTROLLER_DIGITAL_A, 10},
+                                 {"hang, A", pros::E_CONTROLLER_DIGITAL_A, 20}};
+
+struct Result {
+        int taps = 0;
+        int seen = 0;
+        float totalLatency = 0; // ms, from the start of the tap to the loop seeing it
+        float maxLatency = 0;
+        // for driver control, the latency the queue measured, from the sample to the driver loop
+        float queueLatency = 0;
+        float queueMaxLatency = 0;
+        int dropped = 0;
+
+        void record(float latency) {
+            seen++;
+            totalLatency += latency;
+            maxLatency = std::max(maxLatency, latency);
+        }
+};
+
+int buttonIndex(pros::controller_digital_e_t button) { return button - pros::E_CONTROLLER_DIGITAL_L1; }
+
+/**
+ * @brief Tap buttons on the controller with random gaps, recording when each tap of each button started
+ */
+void tap(const std::vector<pros::controller_digital_e_t>& buttons, int length, int count, std::uint64_t* started) {
+    sim::World& world = sim::World::get();
+    std::uniform_int_distribution<int> gap(MIN_GAP, MAX_GAP);
+    for (int i = 0; i < count; i++) {
+        pros::delay(gap(world.random()));
+        for (auto button : buttons) world.controller(0).digital[buttonIndex(button)] = true;
+        started[i] = sim::Scheduler::get().now();
+        pros::delay(length);
+        for (auto button : buttons) world.controller(0).digital[buttonIndex(button)] = false;
+    }
+}
+
+/**
+ * @brief Tap every button the loops read, and read them with the loops
+ */
+std::vector<Result> simulate(int length, bool sampler) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, length);
+
+    std::vector<Result> results(LOOPS.size());
+    std::vector<std::uint64_t> started(TAP_COUNT, 0);
+    scheduler.run(
+        [&] {
+            lemlib::InputSettings settings(400, 250);
+            lemlib::ControllerInput input("input", &controller, settings, 5);
+            lemlib::SubsystemScheduler subsystems(5);
+            if (sampler) subsystems.add(input);
+            for (std::size_t i = 0; i < LOOPS.size(); i++) {
+                const Loop loop = LOOPS[i];
+                Result& result = results[i];
+                lemlib::InputQueue* queue = sampler ? &input.subscribe({loop.button}) : nullptr;
+                // the loops don't run in step with each other or the sampler
+                const int phase = std::uniform_int_distribution<int>(0, loop.period - 1)(world.random());
+                scheduler.spawn(
+                    [&, loop, queue, phase] {
+                        pros::delay(phase);
+                        while (true) {
+                            bool pressed = false;
+                            if (queue) {
+                                lemlib::InputEvent event;
+                                while (queue->pop(event)) pressed |= event.type == lemlib::InputEventType::PRESS;
+                            } else pressed = controller.get_digital_new_press(loop.button);
+                            const std::uint64_t now = scheduler.now();
+                            // the tap being seen is the last one started
+                            auto tap = std::upper_bound(started.begin(), started.end(), now,
+                                                        [](std::uint64_t now, std::uint64_t at) {
+                                                            return at == 0 || now < at;
+                                                        });
+                            if (pressed && tap != started.begin()) result.record((now - *(tap - 1)) / 1000.0f);
+                            pros::delay(loop.period);
+                        }
+                    },
+                    TASK_PRIORITY_DEFAULT, loop.name);
+            }
+            tap({pros::E_CONTROLLER_DIGITAL_Y, pros::E_CONTROLLER_DIGITAL_X, pros::E_CONTROLLER_DIGITAL_A}, length,
+                TAP_COUNT, started.data());
+            pros::delay(100);
+        },
+        TAP_COUNT * (MAX_GAP + length + 10) * 1000);
+    for (Result& result : results) result.taps = TAP_COUNT;
+    return results;
+}
+
+/**
+ * @brief Tap Y in driver control in main.cpp, and watch the clamp
+ */
+Result driverControl() {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, 1);
+    sim::addMechanismModels();
+
+    Result result;
+    std::vector<std::uint64_t> started(TAP_COUNT, 0);
+    int tapped = 0;
+    bool clamped = false;
+    world.addStepHook([&](float) {
+        if (world.adi(CLAMP_PORT) == clamped) return;
+        clamped = !clamped;
+        // the clamp moves once per tap, for the last tap started
+        while (tapped < TAP_COUNT && started[tapped] != 0 && started[tapped] <= scheduler.now()) tapped++;
+        if (tapped > 0) result.record((scheduler.now() - started[tapped - 1]) / 1000.0f);
+    });
+    scheduler.run(
+        [&] {
+            initialize();
+            world.setCompetitionStatus(COMPETITION_CONNECTED);
+            scheduler.spawn([&] { opcontrol(); }, TASK_PRIORITY_DEFAULT, "opcontrol");
+            pros::delay(500);
+            std::uniform_int_distribution<int> length(15, 80);
+            for (int i = 0; i < TAP_COUNT; i++)
+                tap({pros::E_CONTROLLER_DIGITAL_Y}, length(world.random()), 1, &started[i]);
+            pros::delay(100);
+            result.taps = TAP_COUNT;
+            result.queueLatency = driverButtons().getMeanLatency();
+            result.queueMaxLatency = driverButtons().getMaxLatency();
+            result.dropped = driverButtons().getDropped();
+        },
+        (CALIBRATION_TIME + 1 + TAP_COUNT * (MAX_GAP + 80 + 10) / 1000.0f) * 1e6);
+    return result;
+}
+
+std::string serialize(const std::vector<Result>& results) {
+    std::ostringstream out;
+    for (const Result& result : results) {
+        out << result.taps << ' ' << result.seen << ' ' << result.totalLatency << ' ' << result.maxLatency << ' '
+            << result.queueLatency << ' ' << result.queueMaxLatency << ' ' << result.dropped << ' ';
+    }
+    return out.str();
+}
+
+std::vector<Result> deserialize(const std::string& text) {
+    std::istringstream in(text);
+    std::vector<Result> results;
+    Result result;
+    while (in >> result.taps >> result.seen >> result.totalLatency >> result.maxLatency >> result.queueLatency >>
+           result.queueMaxLatency >> result.dropped)
+        results.push_back(result);
+    return results;
+}
+
+void printLatency(const Result& result) {
+    std::printf(" %6.1f%% %6.1fms %6.0fms", 100.0f * (result.taps - result.seen) / result.taps,
+                result.seen ? result.totalLatency / result.seen : 0.0f, result.maxLatency);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        std::fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+    const int jobs = TAPS.size() * 2 + 1;
+    const std::vector<std::string> output = sim::parallelMap(jobs, jobs, [](int job) {
+        if (job == int(TAPS.size() * 2)) return serialize({driverControl()});
+        return serialize(simulate(TAPS[job / 2], job % 2));
+    });
+
+    bool failed = false;
+    std::printf("%-6s %-10s %-26s %-26s\n", "tap", "loop", "new_press: missed mean max",
+                "sampler: missed mean max");
+    for (std::size_t i = 0; i < TAPS.size(); i++) {
+        const std::vector<Result> old = deserialize(output[i * 2]);
+        const std::vector<Result> sampled = deserialize(output[i * 2 + 1]);
+        if (old.size() != LOOPS.size() || sampled.size() != LOOPS.size()) {
+            failed = true;
+            continue;
+        }
+        for (std::size_t loop = 0; loop < LOOPS.size(); loop++) {
+            char length[8];
+            std::snprintf(length, sizeof(length), "%dms", TAPS[i]);
+            std::printf("%-6s %-10s", loop == 0 ? length : "", LOOPS[loop].name);
+            printLatency(old[loop]);
+            std::printf("  ");
+            printLatency(sampled[loop]);
+            std::printf("\n");
+        }
+    }
+
+    const std::vector<Result> driver = deserialize(output.back());
+    if (driver.size() != 1) return 1;
+    const Result& clamp = driver[0];
+    std::printf("\ndriver control, %d taps of Y from 15 to 80ms:\n", clamp.taps);
+    std::printf("  clamp moved %d times, missed %.1f%%, %.1fms mean and %.0fms max after the tap\n", clamp.seen,
+                100.0f * (clamp.taps - clamp.seen) / clamp.taps, clamp.seen ? clamp.totalLatency / clamp.seen : 0.0f,
+                clamp.maxLatency);
+    std::printf("  queue latency from the sample: %.1fms mean, %.0fms max, %d events dropped\n", clamp.queueLatency,
+                clamp.queueMaxLatency, clamp.dropped);
+    return failed || clamp.seen != clamp.taps;
+}
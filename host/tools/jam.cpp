@@ -0,0 +1,284 @@
+// Intake jam detection, before and after lemlib::JamDetector.
+//
+// Runs intake1 on the simulated robot for 20s per scenario, with rings loading it down now and then, and watches it
+// with the detector main.cpp used before (torque above 0.34Nm and under 1rpm on one sample, then 100ms backwards) and
+// with a lemlib::JamDetector with the settings and recovery in main.cpp. The scenarios add:
+//
+// - rings: nothing else, the intake runs forwards
+// - starts: the intake starts, stops and reverses like the color sort and the routines make it
+// - snags: a ring catches for 15 to 35ms and comes free on its own
+// - jams: a ring wedges, slowing the intake to a stop. Running backwards about 100 degrees frees it
+// - stubborn: a ring wedges hard, stopping the intake at once. It takes about 400 degrees backwards to free
+//
+// For each this prints the recoveries that weren't needed, how long after each jam the recovery started, how long until
+// the intake was running again, jams still stuck at the end, and how much of the time the intake was carrying rings.
+//
+// usage: jam [--seed N]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// jam detection of intake1, from src/main.cpp
+extern lemlib::JamSettings intakeJamSettings;
+extern std::vector<lemlib::RecoveryStep> intakeRecovery;
+
+namespace {
+constexpr std::int8_t INTAKE_PORT = 11;
+// length of each scenario, in seconds
+constexpr float RUN_TIME = 20;
+// speed above which the intake is carrying rings, in rpm
+constexpr double FLOWING = 300;
+// distance a jammed ring has to be run backwards to come free, in degrees
+constexpr double SOFT_CLEAR = 100;
+constexpr double HARD_CLEAR = 400;
+
+enum class Scenario { RINGS, STARTS, SNAGS, JAMS, STUBBORN };
+
+constexpr const char* SCENARIO_NAMES[] = {"rings", "starts", "snags", "jams", "stubborn"};
+
+struct Fault {
+        double start; // seconds
+        double length; // seconds for a snag, unused for a jam
+        bool hard; // stops the intake at once, instead of loading it down
+        double clear; // degrees backwards that free a jam, 0 for a snag
+};
+
+struct Intake {
+        std::vector<Fault> faults;
+        std::size_t next = 0;
+        // the fault happening now, if any
+        bool active = false;
+        Fault fault {};
+        double reversed = 0; // degrees run backwards since the fault started
+        std::mt19937_64 rng;
+        double ringLoad = 0;
+        double ringUntil = 0;
+};
+
+struct Result {
+        int falseRecoveries = 0;
+        int jams = 0;
+        int stuck = 0;
+        double detect = 0; // seconds, summed over detected jams
+        int detected = 0;
+        double cleared = 0; // seconds, summed over cleared jams
+        int clearedCount = 0;
+        double flowing = 0; // fraction of the time
+};
+
+/**
+ * @brief The jam detection main.cpp used before: a stall on one sample runs intake1 backwards for 100ms
+ */
+class OldUnjam {
+    public:
+        OldUnjam(pros::Motor* motor, lemlib::MotorOutput::Writer writer)
+            : motor(motor),
+              writer(writer) {}
+
+        bool update() {
+            const std::uint32_t now = pros::millis();
+            if (unjamming) {
+                if (now - since < 100) return true;
+                writer.release();
+                unjamming = false;
+            }
+            if (motor->get_torque() > 0.34 && std::fabs(motor->get_actual_velocity()) < 1) {
+                writer.move(90);
+                unjamming = true;
+                since = now;
+                return true;
+            }
+            return false;
+        }
+    private:
+        pros::Motor* motor;
+        lemlib::MotorOutput::Writer writer;
+        bool unjamming = false;
+        std::uint32_t since = 0;
+};
+
+std::vector<Fault> makeFaults(Scenario scenario, std::mt19937_64& rng) {
+    std::vector<Fault> faults;
+    std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+    std::uniform_real_distribution<double> snag(0.015, 0.035);
+    if (scenario == Scenario::SNAGS) {
+        for (double t = 1; t < RUN_TIME - 1; t += 1.2 + jitter(rng)) faults.push_back({t, snag(rng), true, 0});
+    } else if (scenario == Scenario::JAMS || scenario == Scenario::STUBBORN) {
+        const bool hard = scenario == Scenario::STUBBORN;
+        for (double t = 1; t < RUN_TIME - 2; t += 3 + jitter(rng))
+            faults.push_back({t, 0, hard, hard ? HARD_CLEAR : SOFT_CLEAR});
+    }
+    return faults;
+}
+
+/**
+ * @brief Power the routine asks intake1 for, like sortIntake1: negative carries rings up
+ */
+int command(Scenario scenario, double time) {
+    if (scenario != Scenario::STARTS) return -127;
+    // run, stop, run, flick backwards
+    const double phase = std::fmod(time, 1.0);
+    if (phase < 0.4) return -127;
+    if (phase < 0.55) return 0;
+    if (phase < 0.9) return -127;
+    return 120;
+}
+
+Result simulate(Scenario scenario, bool detector, std::uint64_t seed) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, seed);
+
+    std::mt19937_64 rng(seed);
+    auto intake = std::make_shared<Intake>();
+    intake->faults = makeFaults(scenario, rng);
+    intake->rng.seed(rng());
+    Result result;
+
+    // rings on the hooks load the intake down by up to 70% of its stall torque, for 100 to 300ms at a time
+    world.addStepHook([intake, &scheduler, &world, &result](float dt) {
+        sim::MotorState& motor = world.motor(INTAKE_PORT);
+        const double now = scheduler.now() / 1e6;
+        if (now >= intake->ringUntil) {
+            std::uniform_real_distribution<double> load(0, 0.25);
+            std::uniform_real_distribution<double> length(0.1, 0.3);
+            intake->ringLoad = load(intake->rng);
+            intake->ringUntil = now + length(intake->rng);
+        }
+        if (!intake->active && intake->next < intake->faults.size() && now >= intake->faults[intake->next].start) {
+            intake->fault = intake->faults[intake->next++];
+            intake->active = true;
+            intake->reversed = 0;
+            if (intake->fault.clear > 0) result.jams++;
+        }
+        motor.load = intake->ringLoad;
+        if (!intake->active) return;
+        const Fault& fault = intake->fault;
+        if (fault.clear == 0 && now >= fault.start + fault.length) {
+            intake->active = false;
+            return;
+        }
+        // positive shaft velocity carries rings up, into the jam
+        if (motor.velocity < 0) intake->reversed -= motor.velocity * 6 * dt;
+        if (fault.clear > 0 && intake->reversed >= fault.clear) {
+            intake->active = false;
+            return;
+        }
+        // the ring only resists the intake carrying it up
+        const bool reversing = motor.mode == sim::MotorState::Mode::VOLTAGE && motor.voltage < 0;
+        if (!reversing) motor.load = 2;
+        if (fault.hard && motor.velocity > 0) {
+            motor.position -= motor.velocity * 6 * dt;
+            motor.velocity = 0;
+        }
+    });
+
+    scheduler.run(
+        [&] {
+            pros::Motor motor(-INTAKE_PORT, pros::MotorGearset::blue);
+            lemlib::MotorOutput output(&motor);
+            lemlib::MotorOutput::Writer routine = output.writer("routine", 1);
+            lemlib::JamDetector jam(&motor, output.writer("unjam", 2), intakeJamSettings, intakeRecovery);
+            OldUnjam old(&motor, output.writer("unjam", 2));
+            bool recovering = false;
+            std::size_t lastFault = 0;
+            bool waitingForFlow = false;
+            int flowingTicks = 0;
+            int ticks = 0;
+            while (scheduler.now() < RUN_TIME * 1e6) {
+                const double now = scheduler.now() / 1e6;
+                routine.move(command(scenario, now));
+                const bool wasRecovering = recovering;
+                recovering = detector ? jam.update() : old.update();
+                const bool jamActive = intake->active && intake->fault.clear > 0;
+                if (recovering && !wasRecovering) {
+                    if (!jamActive) result.falseRecoveries++;
+                    else if (lastFault != intake->next) {
+                        // the first recovery for this jam
+                        lastFault = intake->next;
+                        result.detect += now - intake->fault.start;
+                        result.detected++;
+                        waitingForFlow = true;
+                    }
+                }
+                const double speed = world.motor(INTAKE_PORT).velocity;
+                if (waitingForFlow && !jamActive && speed > FLOWING) {
+                    result.cleared += now - intake->fault.start;
+                    result.clearedCount++;
+                    waitingForFlow = false;
+                }
+                if (speed > FLOWING) flowingTicks++;
+                ticks++;
+                pros::delay(10);
+            }
+            result.stuck = intake->active && intake->fault.clear > 0;
+            result.flowing = double(flowingTicks) / ticks;
+        },
+        (RUN_TIME + 1) * 1e6);
+    return result;
+}
+
+std::string serialize(const Result& result) {
+    std::ostringstream out;
+    out << result.falseRecoveries << ' ' << result.jams << ' ' << result.stuck << ' ' << result.detect << ' '
+        << result.detected << ' ' << result.cleared << ' ' << result.clearedCount << ' ' << result.flowing;
+    return out.str();
+}
+
+Result deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Result result;
+    in >> result.falseRecoveries >> result.jams >> result.stuck >> result.detect >> result.detected >>
+        result.cleared >> result.clearedCount >> result.flowing;
+    return result;
+}
+
+std::string milliseconds(double total, int count) {
+    if (count == 0) return "-";
+    char text[16];
+    std::snprintf(text, sizeof(text), "%.0fms", total / count * 1000);
+    return text;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    constexpr int SCENARIOS = 5;
+    const std::vector<std::string> output = sim::parallelMap(SCENARIOS * 2, SCENARIOS * 2, [&](int job) {
+        return serialize(simulate(Scenario(job / 2), job % 2, seed));
+    });
+
+    std::printf("%-10s %-10s %6s %6s %10s %10s %6s %8s\n", "scenario", "detector", "false", "jams", "detected",
+                "cleared", "stuck", "flowing");
+    bool failed = false;
+    for (int job = 0; job < SCENARIOS * 2; job++) {
+        if (output[job].empty()) failed = true;
+        const Result result = deserialize(output[job]);
+        std::printf("%-10s %-10s %6d %6d %10s %10s %6d %7.0f%%\n", job % 2 ? "" : SCENARIO_NAMES[job / 2],
+                    job % 2 ? "detector" : "old", result.falseRecoveries, result.jams,
+                    milliseconds(result.detect, result.detected).c_str(),
+                    milliseconds(result.cleared, result.clearedCount).c_str(), result.stuck, result.flowing * 100);
+    }
+    return failed;
+}
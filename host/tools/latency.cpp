@@ -0,0 +1,170 @@
+// Latency measurement and compensation check.
+//
+// First checks that Chassis::calibrate measures the latency the simulated drivetrain is given, for a range of command
+// delays. Then raises the gains of src/main.cpp step by step, and runs a turn and a straight drive on the robot in
+// sim/robot, with its own command delay and a slower one, with and without predict set, counting how many times each
+// motion crosses its target.
+//
+// usage: latency [--workers N]
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// robot configuration, from src/main.cpp
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern lemlib::ControllerSettings linearController;
+extern lemlib::ControllerSettings angularController;
+extern lemlib::ExpoDriveCurve throttleCurve;
+extern lemlib::ExpoDriveCurve steerCurve;
+
+namespace {
+// command delays the measurement is checked against, in milliseconds
+const std::vector<int> DELAYS = {0, 10, 20, 30};
+// factors kP is scaled by
+const std::vector<float> GAIN_SCALES = {1, 2, 3};
+// command delays the gains are tried with, in milliseconds: the robot's, and a slow one
+const std::vector<int> GAIN_DELAYS = {10, 30};
+// turn and drive distance of the two motions, in degrees and inches
+constexpr float TURN = 90;
+constexpr float DRIVE = 24;
+
+struct Result {
+        float time; // seconds the motion took
+        int crossings; // number of times the robot crossed the target
+        float overshoot; // furthest past the target, in degrees or inches
+        float error; // error after coming to rest, in degrees or inches
+};
+
+/**
+ * @brief Measure the latency of a drivetrain with the given command delay
+ */
+float measure(int delay) {
+    sim::RobotModel model = sim::robotModel();
+    model.drive.commandDelay = delay / 1000.0f;
+    sim::World::get().configure(model, {}, 1);
+    float latency = NAN;
+    sim::Scheduler::get().run(
+        [&] {
+            lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors, &throttleCurve,
+                                    &steerCurve);
+            chassis.calibrate(true, true);
+            latency = chassis.getLatency();
+        },
+        30000000);
+    return latency;
+}
+
+/**
+ * @brief Run a turn or a drive with scaled gains
+ */
+Result simulate(bool turn, int delay, float scale, bool predict) {
+    sim::World& world = sim::World::get();
+    sim::RobotModel model = sim::robotModel();
+    model.drive.commandDelay = delay / 1000.0f;
+    world.configure(model, {}, 1);
+    Result result {0, 0, 0, 0};
+    // signed error of the true robot, positive before the target
+    auto error = [&] {
+        const lemlib::Pose pose = world.pose();
+        return turn ? TURN - pose.theta : DRIVE - pose.y;
+    };
+    bool moving = false;
+    float prevError = turn ? TURN : DRIVE;
+    world.addStepHook([&](float) {
+        if (!moving) return;
+        const float e = error();
+        if (lemlib::sgn(e) != lemlib::sgn(prevError) && e != 0) result.crossings++;
+        result.overshoot = std::fmax(result.overshoot, -e);
+        prevError = e;
+    });
+    sim::Scheduler::get().run(
+        [&] {
+            lemlib::ControllerSettings linear = linearController;
+            lemlib::ControllerSettings angular = angularController;
+            lemlib::ControllerSettings& scaled = turn ? angular : linear;
+            scaled.kP *= scale;
+            lemlib::Chassis chassis(drivetrain, linear, angular, sensors, &throttleCurve, &steerCurve);
+            chassis.calibrate(true, predict);
+            // measuring the latency nudges the robot, start both runs from the same place
+            world.teleport({0, 0, 0});
+            chassis.setPose(0, 0, 0);
+            moving = true;
+            const std::uint64_t start = sim::Scheduler::get().now();
+            if (turn) chassis.turnToHeading(TURN, 3000, {.predict = predict}, false);
+            else chassis.moveToPoint(0, DRIVE, 3000, {.predict = predict}, false);
+            result.time = (sim::Scheduler::get().now() - start) / 1e6;
+            pros::delay(500);
+            result.error = std::fabs(error());
+        },
+        30000000);
+    return result;
+}
+
+std::string serialize(const Result& r) {
+    std::ostringstream out;
+    out << r.time << ' ' << r.crossings << ' ' << r.overshoot << ' ' << r.error;
+    return out.str();
+}
+
+Result deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Result r {NAN, -1, NAN, NAN};
+    in >> r.time >> r.crossings >> r.overshoot >> r.error;
+    return r;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int workers = 0;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc) workers = std::stoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--workers N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // one process per simulation, since a simulation can only run once per process
+    const std::vector<std::string> measured = sim::parallelMap(DELAYS.size(), workers, [&](int job) {
+        std::freopen("/dev/null", "w", stdout);
+        std::ostringstream out;
+        out << measure(DELAYS[job]);
+        return out.str();
+    });
+    std::printf("command delay  measured latency\n");
+    for (std::size_t i = 0; i < DELAYS.size(); i++) {
+        std::printf("%8dms      %8.1fms\n", DELAYS[i], std::stof(measured[i]));
+    }
+
+    const int scales = GAIN_SCALES.size();
+    const int delays = GAIN_DELAYS.size();
+    // job index, from slowest to fastest changing: motion, delay, gains, predict
+    const std::vector<std::string> outputs = sim::parallelMap(2 * delays * scales * 2, workers, [&](int job) {
+        std::freopen("/dev/null", "w", stdout);
+        const bool predict = job % 2;
+        const float scale = GAIN_SCALES[job / 2 % scales];
+        const int delay = GAIN_DELAYS[job / 2 / scales % delays];
+        const bool turn = job / 2 / scales / delays;
+        return serialize(simulate(turn, delay, scale, predict));
+    });
+    std::printf("\nmotion       delay  gains  predict  time   crossings  overshoot  error\n");
+    for (int job = 0; job < int(outputs.size()); job++) {
+        const Result r = deserialize(outputs[job]);
+        const bool turn = job / 2 / scales / delays;
+        const char* unit = turn ? "deg" : "in";
+        std::printf("%-11s  %3dms  x%-4.1f  %-7s  %4.2fs  %9d  %6.2f%-3s  %5.2f%s\n", turn ? "turn 90deg" : "drive 24in",
+                    GAIN_DELAYS[job / 2 / scales % delays], GAIN_SCALES[job / 2 % scales], job % 2 ? "on" : "off",
+                    r.time, r.crossings, r.overshoot, unit, r.error, unit);
+    }
+    return 0;
+}
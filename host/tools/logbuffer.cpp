@@ -0,0 +1,398 @@
+// Logger buffer benchmark.
+//
+// Compares lemlib::Buffer against a copy of the buffer it replaced, a std::deque of strings behind a mutex whose task
+// printed one message per wake. First times the host CPU cost per message, pushing and draining a steady stream of
+// log lines. Then logs several lines per 10ms control loop tick into a buffer set up like BufferedStdout, on the
+// virtual clock, and reports how long lines wait before they are printed, how many are dropped, and how many are
+// still waiting at the end. Then times a debug log call like the ones in the motion loops, formatted on the calling
+// task the way BaseSink::log used to, and deferred to the logger task. Last, times a debug call filtered out at run
+// time, and the same call through lemlib::log, which costs nothing when built with -DLEMLIB_LOG_LEVEL=WARN.
+//
+// usage: logbuffer [--workers N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/logger/baseSink.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/logger/buffer.hpp"
+#include "pros/rtos.hpp"
+#include "sim/parallel.hpp"
+#include "sim/scheduler.hpp"
+
+namespace {
+// messages timed for the CPU cost
+constexpr int COST_MESSAGES = 200000;
+// messages pushed per wake of the buffer task when timing the CPU cost
+constexpr int COST_BATCH = 20;
+// length of the simulated logging, in seconds
+constexpr int DURATION = 20;
+// lines logged per 10ms tick
+const std::vector<int> LOADS = {1, 5, 20};
+// log calls timed, in batches small enough for the logger to keep up
+constexpr int LOG_CALLS = 100000;
+constexpr int LOG_BATCH = 32;
+// rate, capacity and slot size of BufferedStdout
+constexpr std::uint32_t RATE = 50;
+constexpr std::uint32_t CAPACITY = 64;
+constexpr std::uint32_t SLOT_SIZE = 256;
+
+/**
+ * @brief The buffer lemlib::Buffer replaced
+ */
+class DequeBuffer {
+    public:
+        DequeBuffer(std::function<void(const std::string&)> bufferFunc, std::uint32_t rate)
+            : bufferFunc(bufferFunc),
+              rate(rate),
+              task([this]() { taskLoop(); }) {}
+
+        void pushToBuffer(const std::string& bufferData) {
+            mutex.take();
+            buffer.push_back(bufferData);
+            mutex.give();
+        }
+
+    private:
+        void taskLoop() {
+            while (true) {
+                mutex.take();
+                if (buffer.size() > 0) {
+                    bufferFunc(buffer.at(0));
+                    buffer.pop_front();
+                }
+                mutex.give();
+                pros::delay(rate);
+            }
+        }
+
+        std::function<void(const std::string&)> bufferFunc;
+        std::deque<std::string> buffer;
+        pros::Mutex mutex;
+        std::uint32_t rate;
+        pros::Task task;
+};
+
+enum class Kind { DEQUE, RING, RING_BLOCKING };
+
+const char* name(Kind kind) {
+    switch (kind) {
+        case Kind::DEQUE: return "deque+mutex";
+        case Kind::RING: return "ring, drop";
+        case Kind::RING_BLOCKING: return "ring, block";
+    }
+    return "";
+}
+
+/**
+ * @brief A log line like the ones the chassis prints while debugging, stamped with the time it was logged
+ */
+std::string line(std::uint64_t time, int index) {
+    return fmt::format("[{:>10}] [DEBUG] pose x: {:7.2f}, y: {:7.2f}, theta: {:7.2f}\n", time, index * 0.1,
+                       index * 0.2, index * 0.3);
+}
+
+/**
+ * @brief Count the lines and writes handed to the output
+ */
+struct Counter {
+        std::uint64_t lines = 0;
+        std::uint64_t writes = 0;
+
+        void operator()(const std::string& text) {
+            lines += std::count(text.begin(), text.end(), '\n');
+            writes++;
+        }
+};
+
+/**
+ * @brief Time the host CPU cost per message, in nanoseconds, pushed and end to end
+ *
+ * The old buffer can only print one message per wake, so it is fed one message per wake and the ring a batch per
+ * wake. End to end includes the scheduler, which is the same for both.
+ */
+std::string cost(Kind kind) {
+    Counter counter;
+    double push = 0;
+    double total = 0;
+    sim::Scheduler::get().run(
+        [&] {
+            const std::string message = line(0, 1);
+            const int batch = kind == Kind::DEQUE ? 1 : COST_BATCH;
+            DequeBuffer* deque = nullptr;
+            lemlib::Buffer* ring = nullptr;
+            auto output = [&](const std::string& text) { counter(text); };
+            if (kind == Kind::DEQUE) deque = new DequeBuffer(output, 1);
+            else {
+                ring = new lemlib::Buffer(output, CAPACITY, SLOT_SIZE);
+                ring->setRate(1);
+            }
+            const auto start = std::chrono::steady_clock::now();
+            for (int sent = 0; sent < COST_MESSAGES; sent += batch) {
+                const auto pushStart = std::chrono::steady_clock::now();
+                for (int i = 0; i < batch; i++) {
+                    if (deque) deque->pushToBuffer(message);
+                    else ring->pushToBuffer(message);
+                }
+                push += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - pushStart).count();
+                pros::delay(1);
+            }
+            while (counter.lines < COST_MESSAGES) pros::delay(1);
+            total = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        },
+        UINT64_MAX);
+    std::ostringstream out;
+    out << push / COST_MESSAGES << ' ' << total / COST_MESSAGES << ' ' << counter.writes;
+    return out.str();
+}
+
+struct Backlog {
+        std::uint64_t logged = 0; // lines logged
+        std::uint64_t printed = 0; // lines printed
+        std::uint64_t dropped = 0; // lines dropped
+        std::uint64_t pending = 0; // lines still waiting at the end
+        double meanLatency = 0; // mean time from logging to printing, in milliseconds
+        double p99Latency = 0;
+        double maxLatency = 0;
+        double maxStall = 0; // longest a single push held up the logging task, in milliseconds
+};
+
+/**
+ * @brief Log a number of lines every 10ms into a buffer set up like BufferedStdout
+ */
+Backlog backlog(Kind kind, int load) {
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    Backlog result;
+    std::vector<double> latencies;
+    // read the time each printed line was logged back from its stamp
+    auto output = [&](const std::string& text) {
+        const std::uint64_t now = scheduler.now();
+        for (std::size_t start = 0; start < text.size();) {
+            const std::size_t end = text.find('\n', start);
+            latencies.push_back((now - std::stoull(text.substr(start + 1, 10))) / 1000.0);
+            start = end + 1;
+        }
+    };
+    scheduler.run(
+        [&] {
+            DequeBuffer* deque = nullptr;
+            lemlib::Buffer* ring = nullptr;
+            if (kind == Kind::DEQUE) deque = new DequeBuffer(output, RATE);
+            else {
+                const lemlib::OverflowPolicy policy =
+                    kind == Kind::RING ? lemlib::OverflowPolicy::DROP : lemlib::OverflowPolicy::BLOCK;
+                ring = new lemlib::Buffer(output, CAPACITY, SLOT_SIZE, policy);
+            }
+            std::uint32_t now = pros::millis();
+            const std::uint32_t end = now + DURATION * 1000;
+            while (now < end) {
+                for (int i = 0; i < load; i++) {
+                    const std::uint64_t start = scheduler.now();
+                    if (deque) deque->pushToBuffer(line(start, result.logged));
+                    else ring->pushToBuffer(line(start, result.logged));
+                    result.maxStall = std::max(result.maxStall, (scheduler.now() - start) / 1000.0);
+                    result.logged++;
+                }
+                pros::Task::delay_until(&now, 10);
+            }
+            if (ring) result.dropped = ring->getDropped();
+        },
+        UINT64_MAX);
+    result.printed = latencies.size();
+    result.pending = result.logged - result.printed - result.dropped;
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        for (double latency : latencies) result.meanLatency += latency / latencies.size();
+        result.p99Latency = latencies[latencies.size() * 99 / 100];
+        result.maxLatency = latencies.back();
+    }
+    return result;
+}
+
+/**
+ * @brief A sink that keeps the last message it was sent
+ */
+class CaptureSink : public lemlib::BaseSink {
+    public:
+        CaptureSink() {
+            setFormat("[LemLib] {level}: {message}");
+            setLowestLevel(lemlib::Level::INFO);
+        }
+
+        ~CaptureSink() { flush(); }
+
+        std::string last;
+    private:
+        void sendMessage(const lemlib::Message& message) override { last = message.message; }
+};
+
+/**
+ * @brief Format a log call on the calling task, like BaseSink::log did before formatting was deferred
+ */
+template <typename... T> std::string formatNow(lemlib::Level level, fmt::format_string<T...> format, T&&... args) {
+    std::string messageString = fmt::format(format, std::forward<T>(args)...);
+    fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs;
+    formattingArgs.push_back(fmt::arg("time", pros::millis()));
+    formattingArgs.push_back(fmt::arg("level", level));
+    formattingArgs.push_back(fmt::arg("message", messageString));
+    return fmt::vformat("[LemLib] {level}: {message}", std::move(formattingArgs));
+}
+
+/**
+ * @brief Time a log call with two floats and one with a string, in nanoseconds, and get the line the first one logged
+ */
+std::string logCall(bool deferred) {
+    double numbers = 0;
+    double text = 0;
+    std::string line;
+    sim::Scheduler::get().run(
+        [&] {
+            CaptureSink sink;
+            float angularOut = 12.5;
+            float lateralOut = -80.25;
+            const std::string name = "intake";
+            std::size_t length = 0;
+            auto time = [&](auto call) {
+                double total = 0;
+                for (int sent = 0; sent < LOG_CALLS; sent += LOG_BATCH) {
+                    const auto start = std::chrono::steady_clock::now();
+                    for (int i = 0; i < LOG_BATCH; i++) call();
+                    total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                    // let the logger task catch up, outside of the timing
+                    pros::delay(60);
+                }
+                return total / LOG_CALLS;
+            };
+            numbers = time([&] {
+                if (deferred) sink.debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+                else length += formatNow(lemlib::Level::DEBUG, "Angular Out: {}, Lateral Out: {}", angularOut,
+                                         lateralOut)
+                                   .size();
+            });
+            line = sink.last;
+            text = time([&] {
+                if (deferred) sink.debug("{} jammed", name);
+                else length += formatNow(lemlib::Level::DEBUG, "{} jammed", name).size();
+            });
+            if (!deferred) line = formatNow(lemlib::Level::DEBUG, "Angular Out: {}, Lateral Out: {}", angularOut,
+                                            lateralOut);
+        },
+        UINT64_MAX);
+    std::ostringstream out;
+    out << numbers << ' ' << text << ' ' << line;
+    return out.str();
+}
+
+/**
+ * @brief Time a debug call below the lowest level of the info sink, in nanoseconds
+ *
+ * @param method 0 fetches the sink by value like infoSink used to, 1 by reference, 2 goes through lemlib::log
+ */
+double filteredCall(int method) {
+    double total = 0;
+    sim::Scheduler::get().run(
+        [&] {
+            float angularOut = 12.5;
+            float lateralOut = -80.25;
+            lemlib::infoSink()->setLowestLevel(lemlib::Level::WARN);
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < LOG_CALLS; i++) {
+                if (method == 0) {
+                    std::shared_ptr<lemlib::InfoSink> sink = lemlib::infoSink();
+                    sink->debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+                } else if (method == 1) {
+                    lemlib::infoSink()->debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+                } else {
+                    lemlib::log<lemlib::Module::MOTION, lemlib::Level::DEBUG>("Angular Out: {}, Lateral Out: {}",
+                                                                              angularOut, lateralOut);
+                }
+            }
+            total = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        },
+        UINT64_MAX);
+    return total / LOG_CALLS;
+}
+
+std::string serialize(const Backlog& b) {
+    std::ostringstream out;
+    out << b.logged << ' ' << b.printed << ' ' << b.dropped << ' ' << b.pending << ' ' << b.meanLatency << ' '
+        << b.p99Latency << ' ' << b.maxLatency << ' ' << b.maxStall;
+    return out.str();
+}
+
+Backlog deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Backlog b;
+    in >> b.logged >> b.printed >> b.dropped >> b.pending >> b.meanLatency >> b.p99Latency >> b.maxLatency >>
+        b.maxStall;
+    return b;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int workers = 0;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc) workers = std::stoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--workers N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const std::vector<Kind> kinds = {Kind::DEQUE, Kind::RING};
+    // one at a time, so the timings don't compete for the CPU
+    const std::vector<std::string> costs =
+        sim::parallelMap(kinds.size(), 1, [&](int job) { return cost(kinds[job]); });
+    std::printf("host CPU per message  push      end to end  writes\n");
+    for (std::size_t i = 0; i < kinds.size(); i++) {
+        double push = 0, total = 0;
+        long writes = 0;
+        std::istringstream(costs[i]) >> push >> total >> writes;
+        std::printf("%-20s  %6.0fns  %8.0fns  %6ld\n", name(kinds[i]), push, total, writes);
+    }
+
+    const std::vector<Kind> backlogKinds = {Kind::DEQUE, Kind::RING, Kind::RING_BLOCKING};
+    const int count = backlogKinds.size() * LOADS.size();
+    const std::vector<std::string> outputs = sim::parallelMap(count, workers, [&](int job) {
+        return serialize(backlog(backlogKinds[job / LOADS.size()], LOADS[job % LOADS.size()]));
+    });
+    std::printf("\n%ds of logging every 10ms, printed every %ums, %u slots\n", DURATION, RATE, CAPACITY);
+    std::printf("buffer        lines/tick  logged  printed  dropped  pending  latency mean    p99      max  "
+                "longest push\n");
+    for (int job = 0; job < count; job++) {
+        const Backlog b = deserialize(outputs[job]);
+        std::printf("%-12s  %10d  %6lu  %7lu  %7lu  %7lu  %10.0fms  %5.0fms  %5.0fms  %10.1fms\n",
+                    name(backlogKinds[job / LOADS.size()]), LOADS[job % LOADS.size()], b.logged, b.printed,
+                    b.dropped, b.pending, b.meanLatency, b.p99Latency, b.maxLatency, b.maxStall);
+    }
+
+    const std::vector<std::string> calls = sim::parallelMap(2, 1, [&](int job) { return logCall(job); });
+    std::printf("\nlog call               two floats  a string  logged\n");
+    for (int job = 0; job < 2; job++) {
+        std::istringstream in(calls[job]);
+        double numbers = 0, text = 0;
+        std::string line;
+        in >> numbers >> text >> std::ws;
+        std::getline(in, line);
+        std::printf("%-21s  %8.0fns  %6.0fns  %s\n", job ? "deferred" : "formatted by caller", numbers, text,
+                    line.c_str());
+    }
+
+    const std::vector<std::string> filtered = sim::parallelMap(3, 1, [&](int job) {
+        std::ostringstream out;
+        out << filteredCall(job);
+        return out.str();
+    });
+    const char* level = lemlib::compiledLevel(lemlib::Module::MOTION) <= lemlib::Level::DEBUG ? "compiled in"
+                                                                                              : "compiled out";
+    std::printf("\nfiltered debug call\n");
+    std::printf("sink by value          %6.1fns\n", std::stod(filtered[0]));
+    std::printf("sink by reference      %6.1fns\n", std::stod(filtered[1]));
+    std::printf("lemlib::log            %6.1fns  (%s)\n", std::stod(filtered[2]), level);
+    return 0;
+}
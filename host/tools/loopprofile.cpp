@@ -0,0 +1,140 @@
+// Loop timing report.
+//
+// First times lemlib::LoopProfile itself: marking the start and end of an iteration, on a lemlib::VirtualClock so only
+// the profile is measured, in host time. Then runs the skills routine, or driver control with --driver, on the robot
+// in sim/robot for 60 seconds and prints the execution time and wake up lateness histograms of every loop that ran, in
+// virtual time. Simulated code runs in no time, so execution times only count the sleeps inside an iteration, and
+// lateness comes from tasks that keep the others from running.
+//
+// usage: loopprofile [--routine NAME | --driver]
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include "lemlib/api.hpp"
+#include "main.h"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/selector.hpp"
+#include "sim/world.hpp"
+
+namespace {
+// time initialize() takes to calibrate before autonomous starts, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+// length of the run, in seconds
+constexpr float PERIOD = 60;
+
+/**
+ * @brief Time a loop marked by a profile, in nanoseconds of host time per iteration
+ */
+template <typename Body> double timeIterations(long iterations, Body body) {
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) body();
+    const std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+    return time.count() / iterations;
+}
+
+std::string overhead() {
+    constexpr long ITERATIONS = 10000000;
+    lemlib::VirtualClock clock;
+    lemlib::setClock(&clock);
+    lemlib::LoopProfile profile("overhead");
+    std::ostringstream out;
+    // the clock reads on their own, to tell them apart from the bookkeeping
+    const double reads = timeIterations(ITERATIONS, [&] {
+        [[maybe_unused]] volatile std::uint64_t time = lemlib::micros();
+        time = lemlib::micros();
+    });
+    const double marks = timeIterations(ITERATIONS, [&] {
+        profile.start();
+        clock.advance(137);
+        profile.end();
+    });
+    const double sleeps = timeIterations(ITERATIONS, [&] {
+        profile.start();
+        clock.advance(137);
+        profile.delay(1);
+    });
+    const double plain = timeIterations(ITERATIONS, [&] {
+        clock.advance(137);
+        lemlib::delay(1);
+    });
+    lemlib::setClock(nullptr);
+    char line[160];
+    std::snprintf(line, sizeof(line), "two clock reads: %.1fns\nstart() and end(): %.1fns per iteration\n", reads,
+                  marks);
+    out << line;
+    std::snprintf(line, sizeof(line), "start() and delay(): %.1fns per iteration, %.1fns more than lemlib::delay\n",
+                  sleeps, sleeps - plain);
+    out << line;
+    return out.str();
+}
+
+void printHistogram(std::ostringstream& out, const char* title, const lemlib::Histogram& histogram) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "  %s: %u, mean %.0fus, p50 %uus, p99 %uus, max %uus\n", title,
+                  histogram.count, histogram.mean(), histogram.percentile(50), histogram.percentile(99),
+                  histogram.max);
+    out << line;
+    for (int i = 0; i < lemlib::Histogram::BUCKETS; i++) {
+        if (histogram.buckets[i] == 0) continue;
+        const unsigned low = i == 0 ? 0 : 1u << (i - 1);
+        if (i == lemlib::Histogram::BUCKETS - 1) std::snprintf(line, sizeof(line), "    %8u+      us", low);
+        else std::snprintf(line, sizeof(line), "    %8u-%-8uus", low, (1u << i) - 1);
+        out << line << ' ' << histogram.buckets[i] << '\n';
+    }
+}
+
+std::string run(const std::string& routine, bool driver) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, 1);
+    sim::addMechanismModels();
+    std::ostringstream out;
+    scheduler.run(
+        [&] {
+            initialize();
+            if (driver) world.setCompetitionStatus(COMPETITION_CONNECTED);
+            else {
+                world.setCompetitionStatus(COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED);
+                sim::selectRoutine(routine);
+            }
+            // only time the routine, not calibration
+            lemlib::LoopProfile::forEach([](lemlib::LoopProfile& profile) { profile.reset(); });
+            const std::uint64_t start = scheduler.now();
+            if (driver) scheduler.spawn([&] { opcontrol(); }, TASK_PRIORITY_DEFAULT, "opcontrol");
+            else scheduler.spawn([&] { autonomous(); }, TASK_PRIORITY_DEFAULT, "autonomous");
+            while (scheduler.now() - start < PERIOD * 1e6) pros::delay(10);
+            out << (driver ? "driver control" : routine) << ", " << PERIOD << "s:\n";
+            lemlib::LoopProfile::forEach([&](lemlib::LoopProfile& profile) {
+                if (profile.getExecution().count == 0) return;
+                out << profile.getName() << '\n';
+                printHistogram(out, "execution", profile.getExecution());
+                printHistogram(out, "late", profile.getLateness());
+            });
+        },
+        (CALIBRATION_TIME + PERIOD + 1) * 1e6);
+    return out.str();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string routine = "Skills Auto";
+    bool driver = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--routine" && i + 1 < argc) routine = argv[++i];
+        else if (arg == "--driver") driver = true;
+        else {
+            std::fprintf(stderr, "usage: %s [--routine NAME | --driver]\n", argv[0]);
+            return 1;
+        }
+    }
+    std::printf("%s\n", overhead().c_str());
+    const std::string result = sim::parallelMap(1, 1, [&](int) { return run(routine, driver); })[0];
+    std::printf("%s", result.c_str());
+    return result.empty();
+}
@@ -0,0 +1,199 @@
+// Model predictive controller benchmark and comparison against the boomerang controller.
+//
+// The benchmark times MPC::update on problems sampled around every target, and reports the mean and worst case solve
+// time on this machine along with the number of model steps simulated per solve, which doesn't depend on the machine.
+// The comparison runs every moveToPose from the autonomous routines in src/main.cpp with both controllers, from the
+// pose the routine starts it at, on a nominal robot and on a tired robot that slips.
+//
+// usage: mpc [--workers N] [--samples N]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// robot configuration, from src/main.cpp
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern lemlib::ControllerSettings linearController;
+extern lemlib::ControllerSettings angularController;
+extern lemlib::ExpoDriveCurve throttleCurve;
+extern lemlib::ExpoDriveCurve steerCurve;
+
+namespace {
+/**
+ * @brief A moveToPose call from an autonomous routine, and the pose the routine starts it from
+ */
+struct Case {
+        const char* name;
+        lemlib::Pose start; // heading in degrees
+        lemlib::Pose target; // heading in degrees
+        int timeout;
+        lemlib::MoveToPoseParams params;
+};
+
+// start poses are where the robot is when the routine reaches the motion, in the nominal sweep
+const std::vector<Case> CASES = {
+    {"red SAWP", {1.7, -40.4, 37.4}, {2.15, -13, -30}, 1000, {.minSpeed = 50, .earlyExitRange = 5}},
+    {"blue SAWP", {-2.0, -40.6, -39.9}, {-0.4, -11.84, 45.24}, 1000, {.minSpeed = 70, .earlyExitRange = 8}},
+    {"red goal", {16.7, -32.9, -31.6}, {-26.85, -20.7, -117}, 1000, {.lead = 0.4, .minSpeed = 30}},
+    {"blue goal",
+     {27.2, -26.2, -31.4},
+     {-2.76, -44.25, -185},
+     3000,
+     {.lead = 0.2, .minSpeed = 50, .earlyExitRange = 8}},
+    {"red ring 1",
+     {-17.7, -34.1, 195},
+     {-21.3, -49.33, 145},
+     900,
+     {.lead = 0.2, .maxSpeed = 50, .minSpeed = 32, .earlyExitRange = 9}},
+    {"red ring 2", {-10.6, -61.4, 151.7}, {-18.66, -28, 2000}, 1000, {.forwards = false, .lead = 0.3}},
+    {"red ring 3", {29.2, -31.2, -39.7}, {9.1, 0.26, -45}, 2000, {.lead = 0.15, .maxSpeed = 50}},
+    {"suite pose", {0, 0, 0}, {24, 36, 90}, 4000, {}},
+};
+
+const std::vector<sim::Disturbances> SCENARIOS = {
+    {},
+    {.batteryVoltage = 11.8, .leftSlip = 0.02, .rightSlip = 0.04, .trackingNoise = 20, .imuNoise = 0.05},
+};
+
+struct Result {
+        float time; // seconds
+        float error; // inches
+        float headingError; // degrees
+        float peakLateral; // peak sideways acceleration, in inches per second squared
+};
+
+/**
+ * @brief Run one case with one controller in one scenario
+ */
+Result simulate(const Case& c, bool mpc, const sim::Disturbances& scenario) {
+    sim::World& world = sim::World::get();
+    world.configure(sim::robotModel(), scenario, 1);
+    Result result {0, 0, 0, 0};
+    // sideways acceleration is speed times turn rate, measured on the true robot
+    world.addStepHook([&](float) {
+        const auto [left, right] = world.sideSpeeds();
+        const float lateral = std::fabs((left + right) / 2 * (left - right) / drivetrain.trackWidth);
+        result.peakLateral = std::max(result.peakLateral, lateral);
+    });
+    sim::Scheduler::get().run(
+        [&] {
+            lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors, &throttleCurve,
+                                    &steerCurve);
+            chassis.calibrate();
+            world.teleport(c.start);
+            chassis.setPose(c.start);
+            lemlib::MoveToPoseParams params = c.params;
+            params.mpc = mpc;
+            result.peakLateral = 0;
+            const std::uint64_t start = sim::Scheduler::get().now();
+            chassis.moveToPose(c.target.x, c.target.y, c.target.theta, c.timeout, params, false);
+            result.time = (sim::Scheduler::get().now() - start) / 1e6;
+            // let the robot coast to a stop before measuring where it ended up
+            chassis.cancelAllMotions();
+            pros::delay(250);
+            const lemlib::Pose pose = world.pose();
+            result.error = pose.distance(c.target);
+            result.headingError = std::fabs(lemlib::angleError(pose.theta, c.target.theta, false));
+        },
+        30000000);
+    return result;
+}
+
+/**
+ * @brief Time MPC::update on problems sampled around every case
+ */
+void benchmark(int samples) {
+    const float fullSpeed = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<float> offset(-48, 48);
+    std::uniform_real_distribution<float> heading(-M_PI, M_PI);
+    std::uniform_real_distribution<float> speed(-fullSpeed, fullSpeed);
+    std::vector<double> times;
+    int evaluations = 0;
+    lemlib::MPC mpc({}, drivetrain.trackWidth);
+    for (int i = 0; i < samples; i++) {
+        const Case& c = CASES[i % CASES.size()];
+        // every sample is a cold start, the worst case for the optimizer
+        const lemlib::Pose target(c.target.x, c.target.y, M_PI_2 - lemlib::degToRad(c.target.theta));
+        const lemlib::Pose pose(target.x + offset(rng), target.y + offset(rng), heading(rng));
+        mpc.reset(speed(rng), speed(rng));
+        const auto start = std::chrono::steady_clock::now();
+        mpc.update(pose, target, c.params.lead, c.params.maxSpeed / 127 * fullSpeed,
+                   c.params.minSpeed / 127 * fullSpeed, c.params.forwards);
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        evaluations = std::max(evaluations, mpc.getEvaluations());
+    }
+    std::sort(times.begin(), times.end());
+    double total = 0;
+    for (double t : times) total += t;
+    const lemlib::MPCSettings settings;
+    std::printf("solve time over %d cold starts, %d steps x %d iterations:\n", samples, settings.steps,
+                settings.iterations);
+    std::printf("  mean %.1fus  p99 %.1fus  worst %.1fus  (this machine)\n", total / times.size(),
+                times[times.size() * 99 / 100], times.back());
+    std::printf("  worst case %d model steps per solve\n\n", evaluations);
+}
+
+std::string serialize(const Result& r) {
+    std::ostringstream out;
+    out << r.time << ' ' << r.error << ' ' << r.headingError << ' ' << r.peakLateral;
+    return out.str();
+}
+
+Result deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Result r {NAN, NAN, NAN, NAN};
+    in >> r.time >> r.error >> r.headingError >> r.peakLateral;
+    return r;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int workers = 0;
+    int samples = 2000;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--workers" && hasValue) workers = std::stoi(argv[++i]);
+        else if (arg == "--samples" && hasValue) samples = std::stoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--workers N] [--samples N]\n", argv[0]);
+            return 1;
+        }
+    }
+    benchmark(samples);
+
+    // one process per case, controller and scenario, since a simulation can only run once per process
+    const int scenarios = SCENARIOS.size();
+    const std::vector<std::string> outputs = sim::parallelMap(CASES.size() * 2 * scenarios, workers, [&](int job) {
+        std::freopen("/dev/null", "w", stdout);
+        const int scenario = job % scenarios;
+        const bool mpc = job / scenarios % 2;
+        return serialize(simulate(CASES[job / scenarios / 2], mpc, SCENARIOS[scenario]));
+    });
+
+    std::printf("scenarios: nominal, tired battery with slip and sensor noise\n");
+    std::printf("%-12s %-10s %-36s %-36s\n", "motion", "controller", "nominal", "tired");
+    for (std::size_t i = 0; i < CASES.size(); i++) {
+        for (int mpc = 0; mpc < 2; mpc++) {
+            std::printf("%-12s %-10s", mpc ? "" : CASES[i].name, mpc ? "mpc" : "boomerang");
+            for (int scenario = 0; scenario < scenarios; scenario++) {
+                const Result r = deserialize(outputs[(i * 2 + mpc) * scenarios + scenario]);
+                std::printf(" %5.2fs %5.2fin %5.1fdeg %4.0fin/s2  ", r.time, r.error, r.headingError, r.peakLateral);
+            }
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
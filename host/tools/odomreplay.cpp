@@ -0,0 +1,339 @@
+// Odometry replay.
+//
+// record runs an autonomous routine on the robot in sim/robot with lemlib::recordOdom writing to FILE, plus the true
+// pose of the simulated robot after every odometry frame. --disturbed adds wheel slip and sensor noise, drift and scale
+// error, without which every estimator tracks the simulated robot perfectly. Recordings made on the robot, by a
+// FlightRecorder, replay the same way, just without the true pose.
+//
+// replay feeds the recorded samples back through lemlib::update with the sensor layout of src/main.cpp and checks
+// every pose against the one the robot computed, bit for bit. Then it runs the same samples through variants of the
+// estimator and reports how far each one ends up from the true pose, or from LemLib's pose if the recording has no
+// true pose.
+//
+// usage: odomreplay record ROUTINE [--out FILE] [--disturbed]
+//        odomreplay replay FILE
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "main.h"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/selector.hpp"
+#include "sim/world.hpp"
+
+// robot configuration, from src/main.cpp
+extern lemlib::Chassis chassis;
+extern lemlib::OdomSensors sensors;
+extern lemlib::Drivetrain drivetrain;
+
+namespace {
+// time initialize() takes to calibrate before autonomous starts, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+// channel of the true pose, x, y and theta in radians, in the coordinates of the simulated field
+constexpr std::uint8_t TRUTH_CHANNEL = 242;
+
+/**
+ * @brief A robot with worn wheels and imperfect sensors
+ */
+sim::Disturbances disturbed() {
+    sim::Disturbances d;
+    d.leftSlip = 0.03;
+    d.rightSlip = 0.01;
+    d.trackingNoise = 20;
+    d.imuNoise = 0.05;
+    d.imuDrift = 0.01;
+    d.imuScale = 0.002;
+    return d;
+}
+
+struct Frame {
+        std::uint8_t channel;
+        std::uint32_t time;
+        std::vector<std::uint8_t> payload;
+
+        float at(std::size_t offset) const {
+            float value;
+            std::memcpy(&value, payload.data() + offset, sizeof(value));
+            return value;
+        }
+};
+
+/**
+ * @brief Append a frame to a recording
+ */
+void append(std::string& recording, const lemlib::TelemetryFrame& frame) {
+    std::uint8_t data[lemlib::TELEMETRY_OVERHEAD + lemlib::TELEMETRY_MAX_PAYLOAD];
+    const std::size_t size = lemlib::encodeTelemetry(data, frame.channel, frame.time, frame.payload, frame.size);
+    recording.append(reinterpret_cast<const char*>(data), size);
+}
+
+/**
+ * @brief Read the frames with a valid CRC out of a recording
+ */
+std::vector<Frame> readFrames(const std::string& recording) {
+    std::vector<Frame> frames;
+    const auto* data = reinterpret_cast<const std::uint8_t*>(recording.data());
+    std::size_t i = 0;
+    while (i + lemlib::TELEMETRY_OVERHEAD <= recording.size()) {
+        const std::size_t length = data[i + 3];
+        const std::size_t size = lemlib::TELEMETRY_OVERHEAD + length;
+        if (data[i] != lemlib::TELEMETRY_SYNC[0] || data[i + 1] != lemlib::TELEMETRY_SYNC[1] ||
+            i + size > recording.size() ||
+            lemlib::crc16(data + i + 2, 6 + length) != (data[i + 8 + length] | data[i + 9 + length] << 8)) {
+            i++;
+            continue;
+        }
+        Frame frame {data[i + 2], 0, std::vector<std::uint8_t>(data + i + 8, data + i + 8 + length)};
+        for (int b = 0; b < 4; b++) frame.time |= std::uint32_t(data[i + 4 + b]) << (8 * b);
+        frames.push_back(std::move(frame));
+        i += size;
+    }
+    return frames;
+}
+
+/**
+ * @brief Record a routine, returning the recording
+ */
+std::string record(const std::string& routine, const sim::Disturbances& disturbances) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), disturbances, 1);
+    sim::addMechanismModels();
+    std::string recording;
+    const float period = routine == "Skills Auto" ? 60 : 15;
+    scheduler.run(
+        [&] {
+            initialize();
+            world.setCompetitionStatus(COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED);
+            sim::selectRoutine(routine);
+            const std::uint64_t start = scheduler.now();
+            bool finished = false;
+            scheduler.spawn(
+                [&] {
+                    autonomous();
+                    finished = true;
+                },
+                TASK_PRIORITY_DEFAULT, "autonomous");
+            // take over the recording from src/main.cpp once autonomous has started. It starts with a reset, so the
+            // replay doesn't need the beginning
+            pros::delay(1);
+            lemlib::recordOdom([&](const lemlib::TelemetryFrame& frame) {
+                append(recording, frame);
+                const lemlib::Pose truth = world.pose();
+                const float pose[] = {truth.x, truth.y, lemlib::degToRad(truth.theta)};
+                append(recording, {TRUTH_CHANNEL, frame.time, reinterpret_cast<const std::uint8_t*>(pose),
+                                   sizeof(pose)});
+            });
+            while (!finished && scheduler.now() - start < period * 1e6) pros::delay(10);
+            lemlib::recordOdom(nullptr);
+        },
+        (CALIBRATION_TIME + period + 1) * 1e6);
+    return recording;
+}
+
+/**
+ * @brief An estimator variant, run over the same samples as LemLib
+ */
+struct Variant {
+        const char* name;
+        // where the heading comes from: the IMU, or the difference of the two vertical wheels
+        bool imuHeading;
+        // integrate along an arc, like LemLib, or in a straight line along the average heading
+        bool arc;
+        bool horizontalWheel;
+
+        lemlib::Pose pose {0, 0, 0};
+        lemlib::OdomSample previous;
+
+        void update(const lemlib::OdomSample& sample) {
+            const float vertical1Offset = sensors.vertical1->getOffset();
+            const float vertical2Offset = drivetrain.trackWidth / 2;
+            float deltaHeading = sample.imu - previous.imu;
+            if (!imuHeading) {
+                deltaHeading = -((sample.vertical1 - previous.vertical1) - (sample.vertical2 - previous.vertical2)) /
+                               (vertical1Offset - vertical2Offset);
+            }
+            const float deltaY = sample.vertical1 - previous.vertical1;
+            const float deltaX = horizontalWheel ? sample.horizontal1 - previous.horizontal1 : 0;
+            float localX = deltaX;
+            float localY = deltaY;
+            if (arc && deltaHeading != 0) {
+                const float horizontalOffset = horizontalWheel ? sensors.horizontal1->getOffset() : 0;
+                localX = 2 * std::sin(deltaHeading / 2) * (deltaX / deltaHeading + horizontalOffset);
+                localY = 2 * std::sin(deltaHeading / 2) * (deltaY / deltaHeading + vertical1Offset);
+            }
+            const float average = pose.theta + deltaHeading / 2;
+            pose.x += localY * std::sin(average) - localX * std::cos(average);
+            pose.y += localY * std::cos(average) + localX * std::sin(average);
+            pose.theta += deltaHeading;
+            previous = sample;
+        }
+};
+
+/**
+ * @brief Map a true pose into the coordinates odometry was reset in
+ */
+struct Alignment {
+        lemlib::Pose world {0, 0, 0};
+        lemlib::Pose odom {0, 0, 0};
+
+        lemlib::Pose apply(lemlib::Pose truth) const {
+            const float rotation = odom.theta - world.theta;
+            const float dx = truth.x - world.x;
+            const float dy = truth.y - world.y;
+            return {odom.x + dx * std::cos(rotation) + dy * std::sin(rotation),
+                    odom.y - dx * std::sin(rotation) + dy * std::cos(rotation), truth.theta + rotation};
+        }
+};
+
+struct Error {
+        float max = 0;
+        float final = 0;
+        float heading = 0; // final heading error, in degrees
+
+        void add(lemlib::Pose pose, lemlib::Pose reference) {
+            final = pose.distance(reference);
+            max = std::max(max, final);
+            heading = lemlib::radToDeg(std::remainder(pose.theta - reference.theta, 2 * M_PI));
+        }
+};
+
+std::string replay(const std::vector<Frame>& frames) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World::get().configure(sim::robotModel(), {}, 1);
+    std::string out;
+    char line[256];
+    sim::Scheduler::get().run(
+        [&] {
+            // the sensor layout of src/main.cpp. The odometry task starts too, but never runs, the replay doesn't
+            // give up the processor
+            chassis.calibrate(false);
+            std::vector<Variant> variants = {
+                {"arc, IMU heading", true, true, true},
+                {"straight line, IMU heading", true, false, true},
+                {"arc, wheel heading", false, true, true},
+                {"arc, no horizontal wheel", true, true, false},
+            };
+            std::vector<Error> errors(variants.size() + 1);
+            bool started = false;
+            bool hasTruth = false;
+            Alignment alignment;
+            lemlib::Pose lemlibPose {0, 0, 0};
+            long samples = 0;
+            long mismatches = 0;
+            float worst = 0;
+            double replayTime = 0;
+            for (std::size_t i = 0; i < frames.size(); i++) {
+                const Frame& frame = frames[i];
+                // the true pose the simulator recorded right after this frame
+                const Frame* truth = i + 1 < frames.size() && frames[i + 1].channel == TRUTH_CHANNEL ? &frames[i + 1]
+                                                                                                      : nullptr;
+                if (frame.channel == lemlib::ODOM_RESET_CHANNEL && frame.payload.size() == 33) {
+                    const lemlib::Pose pose(frame.at(1), frame.at(5), frame.at(9));
+                    const lemlib::OdomSample previous {frame.at(13), frame.at(17), frame.at(21), frame.at(25),
+                                                       frame.at(29)};
+                    // a reset at the start of the recording, or setPose, which every estimator follows
+                    if (!started || frame.payload[0] == 1) {
+                        lemlib::resetOdom(pose, previous);
+                        for (Variant& variant : variants) {
+                            variant.pose = pose;
+                            variant.previous = previous;
+                        }
+                        if (truth != nullptr) alignment = {{truth->at(0), truth->at(4), truth->at(8)}, pose};
+                        started = true;
+                    }
+                } else if (frame.channel == lemlib::ODOM_SAMPLE_CHANNEL && frame.payload.size() == 32 && started) {
+                    const lemlib::OdomSample sample {frame.at(0), frame.at(4), frame.at(8), frame.at(12),
+                                                     frame.at(16)};
+                    const lemlib::Pose recorded(frame.at(20), frame.at(24), frame.at(28));
+                    const auto start = std::chrono::steady_clock::now();
+                    lemlib::update(sample);
+                    replayTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    const lemlib::Pose pose = lemlib::getPose(true);
+                    if (std::memcmp(&pose.x, &recorded.x, sizeof(float)) ||
+                        std::memcmp(&pose.y, &recorded.y, sizeof(float)) ||
+                        std::memcmp(&pose.theta, &recorded.theta, sizeof(float))) {
+                        mismatches++;
+                        worst = std::max(worst, pose.distance(recorded));
+                    }
+                    for (Variant& variant : variants) variant.update(sample);
+                    // compare with the true pose if there is one, or else with LemLib
+                    hasTruth = truth != nullptr;
+                    const lemlib::Pose reference = hasTruth
+                                                       ? alignment.apply({truth->at(0), truth->at(4), truth->at(8)})
+                                                       : pose;
+                    errors[0].add(pose, reference);
+                    for (std::size_t v = 0; v < variants.size(); v++) errors[v + 1].add(variants[v].pose, reference);
+                    lemlibPose = pose;
+                    samples++;
+                }
+            }
+            std::snprintf(line, sizeof(line), "replayed %ld samples, %.0f ns each, %ld poses differ from the recording",
+                          samples, replayTime / std::max(samples, 1L) * 1e9, mismatches);
+            out += line;
+            if (mismatches) {
+                std::snprintf(line, sizeof(line), " by up to %g in", worst);
+                out += line;
+            }
+            out += "\n\n";
+            std::snprintf(line, sizeof(line), "%-28s  %9s  %9s  %12s   (%s)\n", "estimator", "max", "final",
+                          "heading", hasTruth ? "against the true pose" : "against LemLib");
+            out += line;
+            for (std::size_t v = 0; v <= variants.size(); v++) {
+                std::snprintf(line, sizeof(line), "%-28s  %7.3fin  %7.3fin  %10.3fdeg\n",
+                              v == 0 ? "LemLib" : variants[v - 1].name, errors[v].max, errors[v].final,
+                              errors[v].heading);
+                out += line;
+            }
+        },
+        (CALIBRATION_TIME + 1) * 1e6);
+    return out;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    auto usage = [&] {
+        std::fprintf(stderr,
+                     "usage: %s record ROUTINE [--out FILE] [--disturbed]\n"
+                     "       %s replay FILE\n",
+                     argv[0], argv[0]);
+        return 1;
+    };
+    if (argc < 3) return usage();
+    const std::string command = argv[1];
+    const std::string argument = argv[2];
+    if (command == "record") {
+        std::string path = "odom.bin";
+        sim::Disturbances disturbances;
+        for (int i = 3; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (arg == "--out" && i + 1 < argc) path = argv[++i];
+            else if (arg == "--disturbed") disturbances = disturbed();
+            else return usage();
+        }
+        const std::string recording = sim::parallelMap(1, 1, [&](int) { return record(argument, disturbances); })[0];
+        std::ofstream(path, std::ios::binary) << recording;
+        std::printf("recorded %zu bytes to %s\n", recording.size(), path.c_str());
+        return recording.empty();
+    }
+    if (command != "replay" || argc != 3) return usage();
+    std::ifstream file(argument, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "can't read %s\n", argument.c_str());
+        return 1;
+    }
+    const std::vector<Frame> frames = readFrames(std::string(std::istreambuf_iterator<char>(file), {}));
+    const std::string result = sim::parallelMap(1, 1, [&](int) { return replay(frames); })[0];
+    std::printf("%s", result.c_str());
+    return result.empty();
+}
@@ -0,0 +1,139 @@
+// Flight recorder throughput check.
+//
+// Runs the skills routine on the robot in sim/robot for 60 seconds with every telemetry channel of src/main.cpp at
+// full rate, 100Hz, recorded by a lemlib::FlightRecorder into DIR. Reports the data rate the recorder has to keep up
+// with, the blocks it wrote, what it dropped, and the average time a recording task spends in FlightRecorder::write, in
+// host time. Then reads the file back and checks that every sample the registry took is in it with a valid CRC.
+//
+// usage: recorder [--dir DIR] [--block BYTES]
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include "lemlib/api.hpp"
+#include "main.h"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/selector.hpp"
+#include "sim/world.hpp"
+
+// telemetry of src/main.cpp
+lemlib::TelemetryRegistry& telemetry();
+
+namespace {
+// time initialize() takes to calibrate before autonomous starts, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+// length of a skills run, in seconds
+constexpr float PERIOD = 60;
+// the channels src/main.cpp registers
+const char* const CHANNELS[] = {"pose", "wheels", "lateral", "angular", "ladyBrown", "motors", "state"};
+
+/**
+ * @brief Count the frames with a valid CRC in a recording, by channel
+ */
+std::map<int, long> countFrames(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    const std::string capture(std::istreambuf_iterator<char>(file), {});
+    const auto* data = reinterpret_cast<const std::uint8_t*>(capture.data());
+    std::map<int, long> frames;
+    std::size_t i = 0;
+    while (i + lemlib::TELEMETRY_OVERHEAD <= capture.size()) {
+        const std::size_t length = data[i + 3];
+        const std::size_t size = lemlib::TELEMETRY_OVERHEAD + length;
+        if (data[i] != lemlib::TELEMETRY_SYNC[0] || data[i + 1] != lemlib::TELEMETRY_SYNC[1] ||
+            i + size > capture.size() ||
+            lemlib::crc16(data + i + 2, 6 + length) != (data[i + 8 + length] | data[i + 9 + length] << 8)) {
+            i++;
+            continue;
+        }
+        frames[data[i + 2]]++;
+        i += size;
+    }
+    return frames;
+}
+
+std::string run(const std::string& directory, std::uint32_t blockSize) {
+    std::freopen("/dev/null", "w", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, 1);
+    sim::addMechanismModels();
+    std::ostringstream out;
+    scheduler.run(
+        [&] {
+            lemlib::FlightRecorder recorder(directory, blockSize);
+            double total = 0; // time spent writing, in microseconds of host time
+            long writes = 0;
+            initialize();
+            for (const char* channel : CHANNELS) {
+                telemetry().setPeriod(channel, 10);
+                telemetry().subscribe(channel, [&](const lemlib::TelemetryFrame& frame) {
+                    const auto start = std::chrono::steady_clock::now();
+                    recorder.write(frame);
+                    const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+                    total += time.count();
+                    writes++;
+                });
+            }
+            recorder.start("skills");
+            world.setCompetitionStatus(COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED);
+            sim::selectRoutine("Skills Auto");
+            const std::uint64_t start = scheduler.now();
+            std::uint32_t samples[std::size(CHANNELS)];
+            scheduler.spawn([&] { autonomous(); }, TASK_PRIORITY_DEFAULT, "autonomous");
+            while (scheduler.now() - start < PERIOD * 1e6) pros::delay(10);
+            // stop recording, and count the samples that were taken while recording
+            for (std::size_t i = 0; i < std::size(CHANNELS); i++) {
+                telemetry().setEnabled(CHANNELS[i], false);
+                samples[i] = telemetry().getSamples(CHANNELS[i]);
+            }
+            recorder.stop();
+            pros::delay(100);
+
+            const long bytes = recorder.getWritten();
+            out << "recorded " << writes << " frames, " << bytes << " bytes in " << PERIOD << "s, "
+                << bytes / PERIOD / 1000 << " kB/s\n";
+            out << "blocks of " << blockSize << " bytes: " << bytes / blockSize << " full, "
+                << (bytes % blockSize ? 1 : 0) << " partial at the end of the file\n";
+            out << "dropped " << recorder.getDropped() << " frames, failed to write " << recorder.getFailed()
+                << " bytes\n";
+            out << "average write " << total / writes * 1000 << "ns\n";
+            const std::string path = directory + "/skills_0.bin";
+            const std::map<int, long> frames = countFrames(path);
+            long recorded = 0;
+            for (const auto& [id, count] : frames) recorded += id == lemlib::TELEMETRY_SCHEMA_CHANNEL ? 0 : count;
+            long sampled = 0;
+            for (std::uint32_t count : samples) sampled += count;
+            out << path << ": " << recorded << " data frames with a valid CRC, the registry took " << sampled
+                << " samples\n";
+        },
+        (CALIBRATION_TIME + PERIOD + 1) * 1e6);
+    return out.str();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string directory = "/tmp/recorder";
+    std::uint32_t blockSize = 4096;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) directory = argv[++i];
+        else if (arg == "--block" && i + 1 < argc) blockSize = std::stoul(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--dir DIR] [--block BYTES]\n", argv[0]);
+            return 1;
+        }
+    }
+    // start from an empty directory, so the recording is skills_0.bin
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::string result = sim::parallelMap(1, 1, [&](int) { return run(directory, blockSize); })[0];
+    std::printf("%s", result.c_str());
+    return result.empty();
+}
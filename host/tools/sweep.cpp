@@ -0,0 +1,270 @@
+// Monte Carlo robustness sweep of the autonomous routines in src/main.cpp.
+//
+// Runs each selector routine many times, on a different robot every time: the start placement, battery voltage,
+// wheel slip and sensor noise are sampled per run from one seeded generator. Every run is a separate process (see
+// sim/parallel). For each routine this reports how often it finishes inside the autonomous period and ends where it
+// should, where the failures got stuck, and for every motion the distribution of its completion time and of how far
+// from the disturbance-free run it ended.
+//
+// usage: sweep [--routine NAME]... [--runs N] [--seed N] [--workers N] [--tolerance INCHES]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/util.hpp"
+#include "main.h"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/selector.hpp"
+#include "sim/world.hpp"
+
+namespace {
+// distance sensor on the clamp, and how close the robot has to get to a goal for it to see the goal
+constexpr std::uint8_t CLAMP_SENSOR_PORT = 5;
+constexpr float CLAMP_RANGE = 3; // inches
+
+/**
+ * @brief What a routine expects to find on the field, in the coordinates the routine starts from
+ */
+struct FieldModel {
+        const char* routine;
+        /** mobile goals the routine clamps */
+        std::vector<lemlib::Pose> goals;
+        /** time the routine has to finish in, in seconds */
+        float period;
+};
+
+// Skills is left out: it relocalizes against the field walls with reset_distance, which needs a model of the walls
+const std::vector<FieldModel> FIELDS = {
+    {"Red SAWP", {{-16.7, -32.9}, {-57.76, 6.5}}, 15},
+    {"Blue SAWP", {{16.7, -32.9}, {56.355, 7.8}}, 15},
+    {"Red Goal", {{16.7, -32.9}}, 15},
+    {"Blue Goal", {{-16.7, -32.9}}, 15},
+    {"Red Ring", {{-16.7, -32.9}}, 15},
+};
+
+// time initialize() takes to calibrate before autonomous starts, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+
+/**
+ * @brief Sample the robot and field for one run. Run 0 is the nominal run every other run is compared against
+ */
+sim::Disturbances sample(std::uint64_t seed, int run) {
+    if (run == 0) return {};
+    std::seed_seq sequence {seed, std::uint64_t(run)};
+    std::mt19937_64 rng(sequence);
+    std::normal_distribution<float> placement(0, 0.5); // inches
+    std::normal_distribution<float> placementAngle(0, 1); // degrees
+    std::uniform_real_distribution<float> battery(11.6, 12.8);
+    std::uniform_real_distribution<float> slip(0, 0.04);
+    std::uniform_real_distribution<float> trackingNoise(0, 30);
+    std::uniform_real_distribution<float> imuNoise(0, 0.1);
+    std::normal_distribution<float> imuDrift(0, 0.01);
+    std::normal_distribution<float> imuScale(0, 0.002);
+    sim::Disturbances d;
+    d.startOffset = {placement(rng), placement(rng), placementAngle(rng)};
+    d.batteryVoltage = battery(rng);
+    d.leftSlip = slip(rng);
+    d.rightSlip = slip(rng);
+    d.trackingNoise = trackingNoise(rng);
+    d.imuNoise = imuNoise(rng);
+    d.imuDrift = imuDrift(rng);
+    d.imuScale = imuScale(rng);
+    return d;
+}
+
+struct Motion {
+        float start; // seconds since autonomous started
+        float end;
+        lemlib::Pose pose; // where the robot ended up, heading in degrees
+};
+
+struct Run {
+        bool finished = false;
+        float duration = 0; // seconds, or the period if the routine didn't finish
+        lemlib::Pose pose = {0, 0, 0}; // where the robot was when the routine ended
+        std::vector<Motion> motions;
+};
+
+/**
+ * @brief Simulate one run of a routine
+ */
+Run simulate(const FieldModel& field, std::uint64_t seed, int run) {
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), sample(seed, run), seed + run);
+    sim::addMechanismModels();
+    world.setDistanceModel(CLAMP_SENSOR_PORT, [&world, goals = field.goals] {
+        float closest = INFINITY;
+        const lemlib::Pose pose = world.pose();
+        for (const lemlib::Pose& goal : goals) closest = std::min(closest, pose.distance(goal));
+        return std::int32_t(std::max(0.0f, closest - CLAMP_RANGE) * 25.4f);
+    });
+
+    Run result;
+    std::uint64_t start = 0;
+    int routine = -1;
+    // motions run in tasks the routine creates, so their end is the end of the motion
+    scheduler.onFinish([&](const sim::Scheduler::TaskRecord& task) {
+        if (routine < 0 || task.parent != routine) return;
+        result.motions.push_back({(task.start - start) / 1e6f, (task.end - start) / 1e6f, world.pose()});
+    });
+    const std::uint64_t period = field.period * 1e6;
+    scheduler.run(
+        [&] {
+            initialize();
+            world.setCompetitionStatus(COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED);
+            sim::selectRoutine(field.routine);
+            start = scheduler.now();
+            routine = scheduler.spawn(
+                [&] {
+                    autonomous();
+                    result.finished = true;
+                    result.duration = (scheduler.now() - start) / 1e6;
+                },
+                TASK_PRIORITY_DEFAULT, "autonomous");
+            while (!result.finished && scheduler.now() - start < period) pros::delay(10);
+            if (!result.finished) result.duration = field.period;
+            result.pose = world.pose();
+        },
+        (CALIBRATION_TIME + field.period + 1) * 1e6);
+    return result;
+}
+
+std::string serialize(const Run& run) {
+    std::ostringstream out;
+    out << run.finished << ' ' << run.duration << ' ' << run.pose.x << ' ' << run.pose.y << ' ' << run.pose.theta
+        << '\n';
+    for (const Motion& m : run.motions)
+        out << m.start << ' ' << m.end << ' ' << m.pose.x << ' ' << m.pose.y << ' ' << m.pose.theta << '\n';
+    return out.str();
+}
+
+std::optional<Run> deserialize(const std::string& text) {
+    std::istringstream in(text);
+    Run run;
+    if (!(in >> run.finished >> run.duration >> run.pose.x >> run.pose.y >> run.pose.theta)) return std::nullopt;
+    Motion m {0, 0, {0, 0, 0}};
+    while (in >> m.start >> m.end >> m.pose.x >> m.pose.y >> m.pose.theta) run.motions.push_back(m);
+    return run;
+}
+
+/**
+ * @brief Get a percentile of a sample, 0 to 1, by the nearest rank
+ */
+float percentile(std::vector<float> values, float p) {
+    if (values.empty()) return NAN;
+    std::sort(values.begin(), values.end());
+    const std::size_t rank = std::ceil(p * values.size());
+    return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
+}
+
+float headingError(const lemlib::Pose& a, const lemlib::Pose& b) {
+    return std::fabs(lemlib::angleError(a.theta, b.theta, false));
+}
+
+void report(const FieldModel& field, const Run& nominal, const std::vector<Run>& runs, float tolerance) {
+    int finished = 0;
+    int accurate = 0;
+    std::vector<float> durations;
+    // where unfinished runs were stuck: the number of motions they had completed
+    std::map<std::size_t, int> stuck;
+    for (const Run& run : runs) {
+        if (!run.finished) {
+            stuck[run.motions.size()]++;
+            continue;
+        }
+        finished++;
+        durations.push_back(run.duration);
+        if (run.pose.distance(nominal.pose) <= tolerance) accurate++;
+    }
+    const float total = runs.size();
+    std::printf("%s: %zu runs\n", field.routine, runs.size());
+    std::printf("  finished in %.0fs  %5.1f%%   time p50 %.2fs  p90 %.2fs  max %.2fs  (nominal %.2fs)\n",
+                field.period, 100 * finished / total, percentile(durations, 0.5), percentile(durations, 0.9),
+                percentile(durations, 1), nominal.duration);
+    std::printf("  ended within %gin %5.1f%%\n", tolerance, 100 * accurate / total);
+    for (const auto& [motions, count] : stuck) {
+        std::printf("  stuck after motion %2zu: %5.1f%%\n", motions, 100 * count / total);
+    }
+    std::printf("  motion  nominal start -> end pose         time p50    p90    error p50   p90    max   heading p90\n");
+    for (std::size_t i = 0; i < nominal.motions.size(); i++) {
+        const Motion& reference = nominal.motions[i];
+        std::vector<float> times, errors, headings;
+        for (const Run& run : runs) {
+            if (i >= run.motions.size()) continue;
+            const Motion& m = run.motions[i];
+            times.push_back(m.end - m.start);
+            errors.push_back(m.pose.distance(reference.pose));
+            headings.push_back(headingError(m.pose, reference.pose));
+        }
+        std::printf("  %4zu  %6.2fs -> (%6.1f, %6.1f, %6.1f)  %6.2fs %6.2fs  %6.2fin %5.2fin %5.2fin  %5.1fdeg\n", i,
+                    reference.start, reference.pose.x, reference.pose.y, reference.pose.theta, percentile(times, 0.5),
+                    percentile(times, 0.9), percentile(errors, 0.5), percentile(errors, 0.9), percentile(errors, 1),
+                    percentile(headings, 0.9));
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> names;
+    int runs = 1000;
+    std::uint64_t seed = 1;
+    int workers = 0;
+    float tolerance = 6;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--routine" && hasValue) names.push_back(argv[++i]);
+        else if (arg == "--runs" && hasValue) runs = std::stoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = std::stoull(argv[++i]);
+        else if (arg == "--workers" && hasValue) workers = std::stoi(argv[++i]);
+        else if (arg == "--tolerance" && hasValue) tolerance = std::stof(argv[++i]);
+        else {
+            std::fprintf(stderr,
+                         "usage: %s [--routine NAME]... [--runs N] [--seed N] [--workers N] [--tolerance INCHES]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    std::vector<const FieldModel*> fields;
+    if (names.empty())
+        for (const FieldModel& field : FIELDS) fields.push_back(&field);
+    for (const std::string& name : names) {
+        auto it = std::find_if(FIELDS.begin(), FIELDS.end(), [&](const FieldModel& f) { return name == f.routine; });
+        if (it == FIELDS.end()) {
+            std::fprintf(stderr, "no field model for routine '%s'\n", name.c_str());
+            return 1;
+        }
+        fields.push_back(&*it);
+    }
+
+    for (const FieldModel* field : fields) {
+        // job 0 is the nominal run
+        const std::vector<std::string> outputs = sim::parallelMap(runs + 1, workers, [&](int job) {
+            // the robot code logs to stdout, which would interleave with the report
+            std::freopen("/dev/null", "w", stdout);
+            return serialize(simulate(*field, seed, job));
+        });
+        const std::optional<Run> nominal = deserialize(outputs.at(0));
+        if (!nominal) {
+            std::fprintf(stderr, "%s: nominal run failed\n", field->routine);
+            return 1;
+        }
+        std::vector<Run> results;
+        for (std::size_t i = 1; i < outputs.size(); i++) {
+            if (const std::optional<Run> run = deserialize(outputs[i])) results.push_back(*run);
+        }
+        report(*field, *nominal, results, tolerance);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,332 @@
+// Binary telemetry decoder.
+//
+// Finds the frames lemlib::sendTelemetry and lemlib::TelemetryRegistry write to stdout in a capture of the brain's
+// output, checks their CRC and writes one CSV file per channel, with the timestamp in the first column. Text in between
+// frames, like log messages, is skipped. The layout of registry channels is read from the schema frames in the
+// capture, anywhere in it, so a capture that starts late still decodes from its first frame. Other channels are
+// described as ID=NAME:TYPES:FIELDS, where TYPES has one letter per field: b/B for 8 bit, h/H for 16 bit and i/I for
+// 32 bit signed/unsigned integers, and f for floats. A --channel overrides the schema of the same id.
+//
+// record runs an autonomous routine on the robot in sim/robot with its stdout captured to PREFIXcapture.bin, then
+// decodes the capture and compares the link usage with sending the same samples as TelemetrySink text.
+//
+// usage: telemetry decode [FILE] [--channel ID=NAME:TYPES:FIELDS]... [--out PREFIX]
+//        telemetry record ROUTINE [--channel ID=NAME:TYPES:FIELDS]... [--out PREFIX]
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/telemetry.hpp"
+#include "main.h"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/selector.hpp"
+#include "sim/world.hpp"
+
+namespace {
+// time initialize() takes to calibrate before autonomous starts, in seconds
+constexpr float CALIBRATION_TIME = 2.5;
+
+struct Channel {
+        std::string name;
+        std::string types;
+        std::vector<std::string> fields;
+};
+
+/**
+ * @brief Size of a field type, 0 if the type is unknown
+ */
+std::size_t typeSize(char type) {
+    switch (type) {
+        case 'b':
+        case 'B': return 1;
+        case 'h':
+        case 'H': return 2;
+        case 'i':
+        case 'I':
+        case 'f': return 4;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse a channel description, ID=NAME:TYPES:FIELDS
+ */
+bool parseChannel(const std::string& text, std::map<int, Channel>& channels) {
+    const std::size_t equals = text.find('=');
+    const std::size_t colon1 = text.find(':', equals);
+    const std::size_t colon2 = text.find(':', colon1 + 1);
+    if (equals == std::string::npos || colon1 == std::string::npos || colon2 == std::string::npos) return false;
+    Channel channel;
+    channel.name = text.substr(equals + 1, colon1 - equals - 1);
+    channel.types = text.substr(colon1 + 1, colon2 - colon1 - 1);
+    std::istringstream fields(text.substr(colon2 + 1));
+    for (std::string field; std::getline(fields, field, ',');) channel.fields.push_back(field);
+    if (channel.fields.size() != channel.types.size()) return false;
+    for (char type : channel.types)
+        if (typeSize(type) == 0) return false;
+    channels[std::stoi(text.substr(0, equals))] = channel;
+    return true;
+}
+
+/**
+ * @brief Read a field out of a payload and format it
+ */
+std::string readField(char type, const std::uint8_t* data) {
+    auto read = [data](auto value) {
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    };
+    switch (type) {
+        case 'b': return std::to_string(read(std::int8_t()));
+        case 'B': return std::to_string(read(std::uint8_t()));
+        case 'h': return std::to_string(read(std::int16_t()));
+        case 'H': return std::to_string(read(std::uint16_t()));
+        case 'i': return std::to_string(read(std::int32_t()));
+        case 'I': return std::to_string(read(std::uint32_t()));
+        case 'f': {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%g", read(float()));
+            return text;
+        }
+    }
+    return "";
+}
+
+struct ChannelStats {
+        long frames = 0;
+        long bytes = 0; // bytes of binary frames
+        long textBytes = 0; // bytes the same samples take as TelemetrySink text
+        long malformed = 0; // frames whose size doesn't match the channel
+        std::uint32_t first = 0; // first and last timestamp, in milliseconds
+        std::uint32_t last = 0;
+};
+
+struct Stats {
+        std::map<int, ChannelStats> channels;
+        long corrupt = 0; // frames that failed the CRC
+        long otherBytes = 0; // bytes outside of frames, like log text
+        long schemaBytes = 0; // bytes of schema frames
+};
+
+/**
+ * @brief Call a function with the channel, timestamp, payload and payload size of every frame with a valid CRC
+ *
+ * @return number of bytes outside of frames
+ */
+template <typename F> long forEachFrame(const std::string& capture, Stats& stats, F&& function) {
+    long otherBytes = 0;
+    const auto* data = reinterpret_cast<const std::uint8_t*>(capture.data());
+    const std::size_t size = capture.size();
+    std::size_t i = 0;
+    while (i < size) {
+        if (data[i] != lemlib::TELEMETRY_SYNC[0] || i + 1 >= size || data[i + 1] != lemlib::TELEMETRY_SYNC[1]) {
+            otherBytes++;
+            i++;
+            continue;
+        }
+        const std::size_t length = i + 3 < size ? data[i + 3] : 0;
+        const std::size_t frameSize = lemlib::TELEMETRY_OVERHEAD + length;
+        // a frame cut off at the end of the capture, or sync bytes that happen to be in text
+        if (length > lemlib::TELEMETRY_MAX_PAYLOAD || i + frameSize > size ||
+            lemlib::crc16(data + i + 2, 6 + length) != (data[i + 8 + length] | data[i + 9 + length] << 8)) {
+            if (length <= lemlib::TELEMETRY_MAX_PAYLOAD && i + frameSize <= size) stats.corrupt++;
+            otherBytes++;
+            i++;
+            continue;
+        }
+        std::uint32_t time = 0;
+        for (int b = 0; b < 4; b++) time |= std::uint32_t(data[i + 4 + b]) << (8 * b);
+        function(data[i + 2], time, data + i + 8, length);
+        i += frameSize;
+    }
+    return otherBytes;
+}
+
+/**
+ * @brief Read a schema frame of a TelemetryRegistry: [id][field count][types]["name:field,field,..."]
+ */
+bool parseSchema(const std::uint8_t* payload, std::size_t size, int& id, Channel& channel) {
+    if (size < 2 || size < 2 + std::size_t(payload[1])) return false;
+    id = payload[0];
+    channel.types.assign(reinterpret_cast<const char*>(payload + 2), payload[1]);
+    for (char type : channel.types)
+        if (typeSize(type) == 0) return false;
+    const std::string text(reinterpret_cast<const char*>(payload + 2 + payload[1]), size - 2 - payload[1]);
+    const std::size_t colon = text.find(':');
+    channel.name = text.substr(0, colon);
+    channel.fields.clear();
+    if (colon != std::string::npos) {
+        std::istringstream fields(text.substr(colon + 1));
+        for (std::string field; std::getline(fields, field, ',');) channel.fields.push_back(field);
+    }
+    // the registry cuts off long schemas, number the fields that didn't fit
+    while (channel.fields.size() < channel.types.size())
+        channel.fields.push_back("field" + std::to_string(channel.fields.size()));
+    channel.fields.resize(channel.types.size());
+    if (channel.name.empty()) channel.name = "channel" + std::to_string(id);
+    return true;
+}
+
+/**
+ * @brief Decode every frame in a capture, and write each known channel to PREFIX<name>.csv
+ *
+ * Channels without a description in channels are learned from the schema frames in the capture
+ */
+Stats decode(const std::string& capture, std::map<int, Channel>& channels, const std::string& prefix) {
+    Stats stats;
+    // first pass, learn the channels the capture describes
+    forEachFrame(capture, stats, [&](int id, std::uint32_t, const std::uint8_t* payload, std::size_t size) {
+        if (id != lemlib::TELEMETRY_SCHEMA_CHANNEL) return;
+        int described;
+        Channel channel;
+        if (parseSchema(payload, size, described, channel)) channels.try_emplace(described, channel);
+    });
+    stats.corrupt = 0;
+
+    std::map<int, std::ofstream> files;
+    stats.otherBytes = forEachFrame(capture, stats, [&](int id, std::uint32_t time, const std::uint8_t* payload,
+                                                        std::size_t length) {
+        if (id == lemlib::TELEMETRY_SCHEMA_CHANNEL) {
+            stats.schemaBytes += lemlib::TELEMETRY_OVERHEAD + length;
+            return;
+        }
+        ChannelStats& channelStats = stats.channels[id];
+        if (channelStats.frames == 0) channelStats.first = time;
+        channelStats.frames++;
+        channelStats.bytes += lemlib::TELEMETRY_OVERHEAD + length;
+        channelStats.last = time;
+        const auto channel = channels.find(id);
+        if (channel == channels.end()) return;
+        std::size_t expected = 0;
+        for (char type : channel->second.types) expected += typeSize(type);
+        if (expected != length) {
+            channelStats.malformed++;
+            return;
+        }
+        std::ofstream& file = files[id];
+        if (!file.is_open()) {
+            file.open(prefix + channel->second.name + ".csv");
+            file << "time";
+            for (const std::string& field : channel->second.fields) file << ',' << field;
+            file << '\n';
+        }
+        file << time;
+        std::string text = "\033[sTELE_INFO:" + channel->second.name + ":";
+        for (std::size_t f = 0; f < channel->second.types.size(); f++) {
+            const std::string value = readField(channel->second.types[f], payload);
+            payload += typeSize(channel->second.types[f]);
+            file << ',' << value;
+            text += (f ? "," : "") + value;
+        }
+        file << '\n';
+        text += "TELE_END\033[u\033[0J";
+        channelStats.textBytes += text.size();
+    });
+    return stats;
+}
+
+void report(const Stats& stats, const std::map<int, Channel>& channels, const std::string& prefix) {
+    std::printf("channel  name       frames  rate     binary      as text     file\n");
+    for (const auto& [id, s] : stats.channels) {
+        const auto channel = channels.find(id);
+        const bool known = channel != channels.end();
+        const float seconds = (s.last - s.first) / 1000.0f;
+        const float rate = seconds > 0 ? (s.frames - 1) / seconds : 0;
+        const float binary = seconds > 0 ? s.bytes / seconds : 0;
+        const float text = seconds > 0 ? s.textBytes / seconds : 0;
+        std::printf("%7d  %-9s  %6ld  %5.1fHz  %6.0fB/s  ", id, known ? channel->second.name.c_str() : "?", s.frames,
+                    rate, binary);
+        if (known) std::printf("%7.0fB/s  %s%s.csv\n", text, prefix.c_str(), channel->second.name.c_str());
+        else std::printf("%10s  unknown channel, skipped\n", "");
+        if (s.malformed) std::printf("         %ld frames with the wrong size for the channel\n", s.malformed);
+    }
+    std::printf("%ld bytes of schema frames, %ld frames failed the CRC, %ld bytes of other output\n", stats.schemaBytes,
+                stats.corrupt, stats.otherBytes);
+}
+
+/**
+ * @brief Run a routine in the simulator with stdout captured to a file
+ */
+void record(const std::string& routine, const std::string& path) {
+    std::freopen(path.c_str(), "wb", stdout);
+    sim::World& world = sim::World::get();
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    world.configure(sim::robotModel(), {}, 1);
+    sim::addMechanismModels();
+    const float period = routine == "Skills Auto" ? 60 : 15;
+    scheduler.run(
+        [&] {
+            initialize();
+            world.setCompetitionStatus(COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED);
+            sim::selectRoutine(routine);
+            const std::uint64_t start = scheduler.now();
+            bool finished = false;
+            scheduler.spawn(
+                [&] {
+                    autonomous();
+                    finished = true;
+                },
+                TASK_PRIORITY_DEFAULT, "autonomous");
+            while (!finished && scheduler.now() - start < period * 1e6) pros::delay(10);
+            // let the buffered stdout print what is left
+            pros::delay(100);
+        },
+        (CALIBRATION_TIME + period + 1) * 1e6);
+    std::fflush(stdout);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    auto usage = [&] {
+        std::fprintf(stderr,
+                     "usage: %s decode [FILE] [--channel ID=NAME:TYPES:FIELDS]... [--out PREFIX]\n"
+                     "       %s record ROUTINE [--channel ID=NAME:TYPES:FIELDS]... [--out PREFIX]\n",
+                     argv[0], argv[0]);
+        return 1;
+    };
+    if (argc < 2) return usage();
+    const std::string command = argv[1];
+    if (command != "decode" && command != "record") return usage();
+    std::map<int, Channel> channels;
+    std::string prefix = "telemetry_";
+    std::string input;
+    for (int i = 2; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--channel" && i + 1 < argc) {
+            if (!parseChannel(argv[++i], channels)) return usage();
+        } else if (arg == "--out" && i + 1 < argc) prefix = argv[++i];
+        else if (input.empty() && arg.rfind("--", 0) != 0) input = arg;
+        else return usage();
+    }
+    if (command == "record" && input.empty()) return usage();
+
+    if (command == "record") {
+        const std::string routine = input;
+        input = prefix + "capture.bin";
+        sim::parallelMap(1, 1, [&](int) {
+            record(routine, input);
+            return std::string();
+        });
+    }
+
+    std::string capture;
+    if (input.empty()) capture.assign(std::istreambuf_iterator<char>(std::cin), {});
+    else {
+        std::ifstream file(input, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "can't read %s\n", input.c_str());
+            return 1;
+        }
+        capture.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    report(decode(capture, channels, prefix), channels, prefix);
+    return 0;
+}
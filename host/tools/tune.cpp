@@ -0,0 +1,332 @@
+// Gain optimizer for the drivetrain controllers in src/main.cpp.
+//
+// Runs a fixed suite of motions in the simulator for every candidate set of linear and angular ControllerSettings,
+// and searches kP, kD, slew and the small/large exit ranges with the cross-entropy method: each generation samples a
+// population around the current mean, simulates every candidate in parallel, and moves the mean towards the best
+// fraction. The search is driven by one seeded generator, so the same seed always produces the same gains.
+//
+// usage: tune [--seed N] [--generations N] [--population N] [--workers N] [--controller linear|angular|both]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "sim/parallel.hpp"
+#include "sim/robot.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+// robot configuration, from src/main.cpp
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern lemlib::ControllerSettings linearController;
+extern lemlib::ControllerSettings angularController;
+extern lemlib::ExpoDriveCurve throttleCurve;
+extern lemlib::ExpoDriveCurve steerCurve;
+
+namespace {
+// search dimensions
+enum Param { LIN_KP, LIN_KD, LIN_SLEW, LIN_SMALL, LIN_LARGE, ANG_KP, ANG_KD, ANG_SLEW, ANG_SMALL, ANG_LARGE, COUNT };
+
+struct Bounds {
+        const char* name;
+        float low;
+        float high;
+};
+
+constexpr Bounds BOUNDS[COUNT] = {
+    {"linear kP", 1, 20},
+    {"linear kD", 0, 60},
+    {"linear slew", 0, 30},
+    {"linear small error", 0.25, 3},
+    {"linear large error", 1, 8},
+    {"angular kP", 0.5, 8},
+    {"angular kD", 0, 60},
+    {"angular slew", 0, 30},
+    {"angular small error", 0.25, 3},
+    {"angular large error", 1, 10},
+};
+
+using Candidate = std::array<float, COUNT>;
+
+/**
+ * @brief A motion in the evaluation suite, run from a standstill at the origin facing +y
+ */
+struct Motion {
+        enum class Type { POINT, HEADING, POSE };
+
+        const char* name;
+        Type type;
+        float x;
+        float y;
+        float theta;
+        int timeout;
+};
+
+const std::vector<Motion> SUITE = {
+    {"drive 24", Motion::Type::POINT, 0, 24, 0, 2000},
+    {"drive 48", Motion::Type::POINT, 0, 48, 0, 3000},
+    {"point 24,24", Motion::Type::POINT, 24, 24, 0, 3000},
+    {"turn 90", Motion::Type::HEADING, 0, 0, 90, 1500},
+    {"turn 180", Motion::Type::HEADING, 0, 0, 180, 1500},
+    {"turn -45", Motion::Type::HEADING, 0, 0, -45, 1500},
+    {"pose 24,36,90", Motion::Type::POSE, 24, 36, 90, 4000},
+};
+
+// fixed scenarios every candidate is scored on: a nominal robot, and a tired one that slips
+const std::vector<sim::Disturbances> SCENARIOS = {
+    {},
+    {.batteryVoltage = 11.8, .leftSlip = 0.02, .rightSlip = 0.04, .trackingNoise = 20, .imuNoise = 0.05},
+};
+
+struct Result {
+        float time; // seconds
+        float error; // inches, or degrees for turns
+        bool timedOut;
+};
+
+lemlib::ControllerSettings toSettings(const lemlib::ControllerSettings& base, float kP, float kD, float slew,
+                                      float small, float large) {
+    lemlib::ControllerSettings settings = base;
+    settings.kP = kP;
+    settings.kD = kD;
+    // slew below 1 is indistinguishable from no slew, and 0 disables it
+    settings.slew = slew < 1 ? 0 : slew;
+    settings.smallError = small;
+    settings.largeError = std::max(large, small);
+    return settings;
+}
+
+lemlib::ControllerSettings linearSettings(const Candidate& c) {
+    return toSettings(linearController, c[LIN_KP], c[LIN_KD], c[LIN_SLEW], c[LIN_SMALL], c[LIN_LARGE]);
+}
+
+lemlib::ControllerSettings angularSettings(const Candidate& c) {
+    return toSettings(angularController, c[ANG_KP], c[ANG_KD], c[ANG_SLEW], c[ANG_SMALL], c[ANG_LARGE]);
+}
+
+Candidate fromSettings(const lemlib::ControllerSettings& linear, const lemlib::ControllerSettings& angular) {
+    return {linear.kP,  linear.kD,  linear.slew,  linear.smallError,  linear.largeError,
+            angular.kP, angular.kD, angular.slew, angular.smallError, angular.largeError};
+}
+
+/**
+ * @brief Simulate the suite for one candidate in one scenario
+ */
+std::vector<Result> simulate(const Candidate& candidate, const sim::Disturbances& scenario, std::uint64_t seed) {
+    sim::World::get().configure(sim::robotModel(), scenario, seed);
+    std::vector<Result> results;
+    sim::Scheduler::get().run(
+        [&] {
+            lemlib::Chassis chassis(drivetrain, linearSettings(candidate), angularSettings(candidate), sensors,
+                                    &throttleCurve, &steerCurve);
+            chassis.calibrate();
+            for (const Motion& motion : SUITE) {
+                sim::World::get().teleport({0, 0, 0});
+                chassis.setPose(0, 0, 0);
+                const std::uint64_t start = sim::Scheduler::get().now();
+                switch (motion.type) {
+                    case Motion::Type::POINT:
+                        chassis.moveToPoint(motion.x, motion.y, motion.timeout, {}, false);
+                        break;
+                    case Motion::Type::HEADING: chassis.turnToHeading(motion.theta, motion.timeout, {}, false); break;
+                    case Motion::Type::POSE:
+                        chassis.moveToPose(motion.x, motion.y, motion.theta, motion.timeout, {}, false);
+                        break;
+                }
+                const float time = (sim::Scheduler::get().now() - start) / 1e6;
+                // let the robot coast to a stop before measuring where it ended up
+                chassis.cancelAllMotions();
+                pros::delay(250);
+                const lemlib::Pose pose = sim::World::get().pose();
+                const float angular = std::fabs(lemlib::angleError(pose.theta, motion.theta, false));
+                const float linear = std::hypot(pose.x - motion.x, pose.y - motion.y);
+                float error = linear;
+                if (motion.type == Motion::Type::HEADING) error = angular;
+                if (motion.type == Motion::Type::POSE) error = linear + angular / 10;
+                results.push_back({time, error, time * 1000 >= motion.timeout - 10});
+            }
+        },
+        120000000);
+    return results;
+}
+
+/**
+ * @brief Score a suite result. Lower is better: every second and every inch (or 10 degrees) of error costs 1
+ */
+float cost(const std::vector<Result>& results, bool linear, bool angular) {
+    if (results.size() != SUITE.size()) return INFINITY;
+    float total = 0;
+    for (std::size_t i = 0; i < SUITE.size(); i++) {
+        const bool isTurn = SUITE[i].type == Motion::Type::HEADING;
+        if ((isTurn && !angular) || (!isTurn && !linear)) continue;
+        const Result& result = results[i];
+        total += result.time + (isTurn ? result.error / 10 : result.error) + (result.timedOut ? 2 : 0);
+    }
+    return total;
+}
+
+std::string serialize(const std::vector<Result>& results) {
+    std::ostringstream out;
+    for (const Result& result : results) out << result.time << ' ' << result.error << ' ' << result.timedOut << ' ';
+    return out.str();
+}
+
+std::vector<Result> deserialize(const std::string& text) {
+    std::istringstream in(text);
+    std::vector<Result> results;
+    Result result;
+    while (in >> result.time >> result.error >> result.timedOut) results.push_back(result);
+    return results;
+}
+
+float totalCost(const std::vector<std::vector<Result>>& scenarios, bool linear, bool angular) {
+    float total = 0;
+    for (const auto& results : scenarios) total += cost(results, linear, angular);
+    return total / scenarios.size();
+}
+
+void printSettings(const char* name, const lemlib::ControllerSettings& s, const char* unit) {
+    const int indent = std::strlen("lemlib::ControllerSettings ") + std::strlen(name) + 1;
+    std::printf("lemlib::ControllerSettings %s(%g, // proportional gain (kP)\n", name, std::round(s.kP * 100) / 100);
+    std::printf("%*s%g, // integral gain (kI)\n", indent, "", s.kI);
+    std::printf("%*s%g, // derivative gain (kD)\n", indent, "", std::round(s.kD * 100) / 100);
+    std::printf("%*s%g, // anti windup\n", indent, "", s.windupRange);
+    std::printf("%*s%g, // small error range, in %s\n", indent, "", std::round(s.smallError * 100) / 100, unit);
+    std::printf("%*s%g, // small error range timeout, in milliseconds\n", indent, "", s.smallErrorTimeout);
+    std::printf("%*s%g, // large error range, in %s\n", indent, "", std::round(s.largeError * 100) / 100, unit);
+    std::printf("%*s%g, // large error range timeout, in milliseconds\n", indent, "", s.largeErrorTimeout);
+    std::printf("%*s%g // maximum acceleration (slew)\n", indent, "", std::round(s.slew * 100) / 100);
+    std::printf(");\n");
+}
+
+void printSuite(const char* label, const std::vector<std::vector<Result>>& scenarios) {
+    std::printf("%s\n", label);
+    for (std::size_t i = 0; i < SUITE.size(); i++) {
+        std::printf("  %-16s", SUITE[i].name);
+        for (const auto& results : scenarios) {
+            const Result& r = results[i];
+            std::printf("  %5.2fs %6.2f%s%s", r.time, r.error, SUITE[i].type == Motion::Type::HEADING ? "deg" : "in ",
+                        r.timedOut ? " timeout" : "        ");
+        }
+        std::printf("\n");
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t seed = 1;
+    int generations = 12;
+    int population = 32;
+    int workers = 0;
+    bool linear = true;
+    bool angular = true;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) seed = std::stoull(argv[++i]);
+        else if (arg == "--generations" && hasValue) generations = std::stoi(argv[++i]);
+        else if (arg == "--population" && hasValue) population = std::stoi(argv[++i]);
+        else if (arg == "--workers" && hasValue) workers = std::stoi(argv[++i]);
+        else if (arg == "--controller" && hasValue) {
+            const std::string which = argv[++i];
+            linear = which != "angular";
+            angular = which != "linear";
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--seed N] [--generations N] [--population N] [--workers N] "
+                         "[--controller linear|angular|both]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    // the distribution is refit to at least two elites
+    if (population < 2) {
+        std::fprintf(stderr, "%s: --population has to be at least 2\n", argv[0]);
+        return 1;
+    }
+
+    // one process per candidate and scenario, since a simulation can only run once per process
+    auto evaluate = [&](const std::vector<Candidate>& candidates) {
+        const int scenarioCount = SCENARIOS.size();
+        const std::vector<std::string> outputs =
+            sim::parallelMap(candidates.size() * scenarioCount, workers, [&](int job) {
+                const int scenario = job % scenarioCount;
+                return serialize(simulate(candidates[job / scenarioCount], SCENARIOS[scenario], seed + scenario));
+            });
+        std::vector<std::vector<std::vector<Result>>> results(candidates.size());
+        // a crashed simulation comes back short, and cost() scores it as infinitely bad
+        for (std::size_t i = 0; i < outputs.size(); i++) results[i / scenarioCount].push_back(deserialize(outputs[i]));
+        return results;
+    };
+
+    const Candidate baseline = fromSettings(linearController, angularController);
+    const auto baselineResults = evaluate({baseline}).at(0);
+    const float baselineCost = totalCost(baselineResults, linear, angular);
+    std::printf("baseline cost %.3f\n", baselineCost);
+
+    // cross-entropy search, starting from the gains in main.cpp
+    std::mt19937_64 rng(seed);
+    Candidate mean = baseline;
+    Candidate stddev;
+    for (int p = 0; p < COUNT; p++) stddev[p] = (BOUNDS[p].high - BOUNDS[p].low) / 4;
+    const bool searched[COUNT] = {linear, linear, linear, linear, linear, angular, angular, angular, angular, angular};
+    Candidate best = baseline;
+    float bestCost = baselineCost;
+    auto bestResults = baselineResults;
+    const int elites = std::max(2, population / 5);
+
+    for (int generation = 0; generation < generations; generation++) {
+        std::vector<Candidate> candidates(population);
+        for (Candidate& candidate : candidates) {
+            for (int p = 0; p < COUNT; p++) {
+                if (!searched[p]) {
+                    candidate[p] = mean[p];
+                    continue;
+                }
+                std::normal_distribution<float> distribution(mean[p], stddev[p]);
+                candidate[p] = std::clamp(distribution(rng), BOUNDS[p].low, BOUNDS[p].high);
+            }
+        }
+        const auto results = evaluate(candidates);
+        std::vector<int> order(population);
+        std::vector<float> costs(population);
+        for (int i = 0; i < population; i++) {
+            order[i] = i;
+            costs[i] = totalCost(results[i], linear, angular);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return costs[a] < costs[b]; });
+        if (costs[order[0]] < bestCost) {
+            bestCost = costs[order[0]];
+            best = candidates[order[0]];
+            bestResults = results[order[0]];
+        }
+        // refit the sampling distribution to the elites
+        for (int p = 0; p < COUNT; p++) {
+            if (!searched[p]) continue;
+            float sum = 0;
+            for (int e = 0; e < elites; e++) sum += candidates[order[e]][p];
+            mean[p] = sum / elites;
+            float variance = 0;
+            for (int e = 0; e < elites; e++) variance += std::pow(candidates[order[e]][p] - mean[p], 2);
+            // keep a floor on the spread so the search doesn't collapse early
+            stddev[p] = std::max(std::sqrt(variance / elites), (BOUNDS[p].high - BOUNDS[p].low) / 100);
+        }
+        std::printf("generation %2d: best %.3f, generation best %.3f\n", generation + 1, bestCost, costs[order[0]]);
+        std::fflush(stdout);
+    }
+
+    std::printf("\nscenarios: nominal, tired battery with slip and sensor noise\n");
+    printSuite("baseline:", baselineResults);
+    printSuite("tuned:", bestResults);
+    std::printf("\ncost %.3f -> %.3f (seed %llu)\n\n", baselineCost, bestCost, (unsigned long long)seed);
+    if (linear) printSettings("linearController", linearSettings(best), "inches");
+    if (linear && angular) std::printf("\n");
+    if (angular) printSettings("angularController", angularSettings(best), "degrees");
+    return 0;
+}
@@ -2,10 +2,24 @@
 
 #include "lemlib/pid.hpp" // IWYU pragma: keep
 #include "lemlib/pose.hpp" // IWYU pragma: keep
+#include "lemlib/poseHistory.hpp" // IWYU pragma: keep
 #include "lemlib/util.hpp" // IWYU pragma: keep
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/chassis/trackingWheel.hpp" // IWYU pragma: keep
+#include "lemlib/clock.hpp" // IWYU pragma: keep
+#include "lemlib/controllerScreen.hpp" // IWYU pragma: keep
+#include "lemlib/dashboard.hpp" // IWYU pragma: keep
+#include "lemlib/input.hpp" // IWYU pragma: keep
+#include "lemlib/jam.hpp" // IWYU pragma: keep
 #include "lemlib/logger/logger.hpp" // IWYU pragma: keep
+#include "lemlib/mechanism.hpp" // IWYU pragma: keep
+#include "lemlib/output.hpp" // IWYU pragma: keep
+#include "lemlib/profile.hpp" // IWYU pragma: keep
+#include "lemlib/recorder.hpp" // IWYU pragma: keep
+#include "lemlib/state.hpp" // IWYU pragma: keep
+#include "lemlib/subsystem.hpp" // IWYU pragma: keep
+#include "lemlib/telemetry.hpp" // IWYU pragma: keep
+#include "lemlib/trigger.hpp" // IWYU pragma: keep
 
 // using to shorten lemlib::AngularDirection to just AngularDirection
 using lemlib::AngularDirection;
@@ -8,6 +8,8 @@
 #include "lemlib/pid.hpp"
 #include "lemlib/exitcondition.hpp"
 #include "lemlib/driveCurve.hpp"
+#include "lemlib/mpc.hpp"
+#include "lemlib/output.hpp"
 
 namespace lemlib {
 
@@ -196,6 +198,9 @@ struct TurnToPointParams {
         /** angle between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to control against the pose predicted after the latency measured by Chassis::calibrate, which
+         * allows a higher kP without oscillation. False by default */
+        bool predict = false;
 };
 
 /**
@@ -217,6 +222,9 @@ struct TurnToHeadingParams {
         /** angle between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to control against the pose predicted after the latency measured by Chassis::calibrate, which
+         * allows a higher kP without oscillation. False by default */
+        bool predict = false;
 };
 
 /**
@@ -253,6 +261,9 @@ struct SwingToPointParams {
         /** angle between the robot and target heading where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to control against the pose predicted after the latency measured by Chassis::calibrate, which
+         * allows a higher kP without oscillation. False by default */
+        bool predict = false;
 };
 
 /**
@@ -274,6 +285,9 @@ struct SwingToHeadingParams {
         /** angle between the robot and target heading where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to control against the pose predicted after the latency measured by Chassis::calibrate, which
+         * allows a higher kP without oscillation. False by default */
+        bool predict = false;
 };
 
 /**
@@ -300,6 +314,12 @@ struct MoveToPoseParams {
         /** distance between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to approach the target with the model predictive controller instead of the boomerang controller.
+         * The PIDs still settle the robot once it is close. Configured with Chassis::setMPCSettings. False by default */
+        bool mpc = false;
+        /** whether to control against the pose predicted after the latency measured by Chassis::calibrate, which
+         * allows a higher kP without oscillation. False by default */
+        bool predict = false;
 };
 
 /**
@@ -321,6 +341,9 @@ struct MoveToPointParams {
         /** distance between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to control against the pose predicted after the latency measured by Chassis::calibrate, which
+         * allows a higher kP without oscillation. False by default */
+        bool predict = false;
 };
 
 // default drive curve
@@ -350,6 +373,9 @@ class Chassis {
          * @brief Calibrate the chassis sensors. THis should be called in the initialize function
          *
          * @param calibrateIMU whether the IMU should be calibrated. true by default
+         * @param measureLatency whether to measure the latency between a motor command and the tracking sensors seeing
+         * it, which motions with predict set compensate for. This pulses the drivetrain forwards and backwards a
+         * fraction of an inch. false by default
          *
          * @b Example
          * @code {.cpp}
@@ -366,8 +392,15 @@ class Chassis {
          *     chassis.calibrate(false);
          * }
          * @endcode
+         * @code {.cpp}
+         * // initialize function in your project. The first function that runs when the program is started
+         * void initialize() {
+         *     // calibrate the IMU and measure the latency, so motions can predict where the robot will be
+         *     chassis.calibrate(true, true);
+         * }
+         * @endcode
          */
-        void calibrate(bool calibrateIMU = true);
+        void calibrate(bool calibrateIMU = true, bool measureLatency = false);
         /**
          * @brief Set the pose of the chassis
          *
@@ -427,6 +460,34 @@ class Chassis {
          * @endcode
          */
         Pose getPose(bool radians = false, bool standardPos = false);
+        /**
+         * @brief Get the latency motions with predict set compensate for
+         *
+         * This is the time from a motor command to the tracking sensors seeing it, plus the average age of the pose
+         * when a motion reads it. It is measured by Chassis::calibrate, and 0 until then.
+         *
+         * @return float latency, in milliseconds
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.calibrate(true, true);
+         * printf("latency: %f ms\n", chassis.getLatency());
+         * @endcode
+         */
+        float getLatency() const;
+        /**
+         * @brief Set the latency motions with predict set compensate for, instead of measuring it
+         *
+         * @param latency latency, in milliseconds
+         *
+         * @b Example
+         * @code {.cpp}
+         * // compensate for 15ms of latency
+         * chassis.setLatency(15);
+         * chassis.turnToHeading(90, 1000, {.predict = true});
+         * @endcode
+         */
+        void setLatency(float latency);
         /**
          * @brief Wait until the robot has traveled a certain distance along the path
          *
@@ -482,6 +543,20 @@ class Chassis {
          * @endcode
          */
         void setBrakeMode(pros::motor_brake_mode_e mode);
+        /**
+         * @brief Sets the settings of the model predictive controller used by moveToPose when params.mpc is set
+         *
+         * @param settings horizon, limits and weights of the controller
+         *
+         * @b Example
+         * @code {.cpp}
+         * // plan 12 steps ahead, and limit sideways acceleration to 100 inches per second squared
+         * chassis.setMPCSettings({.steps = 12, .maxLateralAcceleration = 100});
+         * // move to x = 20, y = 15, facing heading 90, with the model predictive controller
+         * chassis.moveToPose(20, 15, 90, 4000, {.mpc = true});
+         * @endcode
+         */
+        void setMPCSettings(const MPCSettings& settings);
         /**
          * @brief Turn the chassis so it is facing the target point
          *
@@ -621,7 +696,8 @@ class Chassis {
         /**
          * @brief Move the chassis towards the target pose
          *
-         * Uses the boomerang controller
+         * Uses the boomerang controller. If params.mpc is set, the model predictive controller drives the approach and
+         * the boomerang controller settles the robot on the target
          *
          * @param x x location
          * @param y y location
@@ -649,6 +725,9 @@ class Chassis {
          * // move the robot to 0, 0, and facing heading 0 with a timeout of 4000ms
          * // this motion should not be as curved as the others, so we set lead to a smaller value (0.3)
          * chassis.moveToPose(0, 0, 0, 4000, {.lead = 0.3});
+         * // move the robot to x = 20, y = 15, and face heading 90 with a timeout of 4000ms
+         * // using the model predictive controller, which respects acceleration and slip limits
+         * chassis.moveToPose(20, 15, 90, 4000, {.mpc = true});
          * @endcode
          */
         void moveToPose(float x, float y, float theta, int timeout, MoveToPoseParams params = {}, bool async = true);
@@ -918,14 +997,29 @@ class Chassis {
          * @brief Dequeues this motion and permits queued task to run
          */
         void endMotion();
+        /**
+         * @brief Get the pose a motion controls against
+         *
+         * @param predict whether to predict the pose after the latency, or use the current pose
+         * @param radians whether theta should be in radians (true) or degrees (false). false by default
+         * @param standardPos whether theta should be in standard position. false by default
+         */
+        Pose getControlPose(bool predict, bool radians = false, bool standardPos = false);
+        /**
+         * @brief Measure the latency by pulsing the drivetrain and timing how long the tracking sensors take to see it
+         */
+        void measureLatency();
 
         bool motionRunning = false;
         bool motionQueued = false;
 
         float distTraveled = 0;
+        // latency motions with predict set compensate for, in milliseconds
+        float latency = 0;
 
         ControllerSettings lateralSettings;
         ControllerSettings angularSettings;
+        MPCSettings mpcSettings;
         Drivetrain drivetrain;
         OdomSensors sensors;
         DriveCurve* throttleCurve;
@@ -935,6 +1029,30 @@ class Chassis {
         ExitCondition lateralSmallExit;
         ExitCondition angularLargeExit;
         ExitCondition angularSmallExit;
+    public:
+        /**
+         * Outputs of the drivetrain sides. Motions and driver control write to them as "chassis" with priority 0
+         *
+         * Any other code driving the drivetrain directly has to write through these too, see MotorOutput
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::MotorOutput::Writer leftRoutine = chassis.leftOutput.writer("routine", 0);
+         * lemlib::MotorOutput::Writer rightRoutine = chassis.rightOutput.writer("routine", 0);
+         * // drive forwards for half a second
+         * leftRoutine.move(60);
+         * rightRoutine.move(60);
+         * pros::delay(500);
+         * leftRoutine.release();
+         * rightRoutine.release();
+         * @endcode
+         */
+        MotorOutput leftOutput;
+        MotorOutput rightOutput;
+    protected:
+        // declared after the outputs, they are initialized from them
+        MotorOutput::Writer leftDrive;
+        MotorOutput::Writer rightDrive;
     private:
         pros::Mutex mutex;
 };
@@ -1,9 +1,32 @@
 #pragma once
 
+#include <functional>
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/pose.hpp"
+#include "lemlib/telemetry.hpp"
 
 namespace lemlib {
+/**
+ * @brief The raw sensor readings one odometry update works from
+ */
+struct OdomSample {
+        /** distance traveled by each tracking wheel in inches, 0 for wheels that don't exist */
+        float vertical1 = 0;
+        float vertical2 = 0;
+        float horizontal1 = 0;
+        float horizontal2 = 0;
+        /** rotation of the IMU in radians, 0 if there is no IMU */
+        float imu = 0;
+};
+
+/** channel of recorded odometry updates: the OdomSample, then the pose it produced, x, y and theta in radians */
+constexpr std::uint8_t ODOM_SAMPLE_CHANNEL = 240;
+/**
+ * channel of recorded odometry resets: why, 0 for the start of the recording or 1 for setPose, the pose, x, y and theta
+ * in radians, and then the OdomSample of the last update
+ */
+constexpr std::uint8_t ODOM_RESET_CHANNEL = 241;
+
 /**
  * @brief Set the sensors to be used for odometry
  *
@@ -47,11 +70,52 @@ Pose getLocalSpeed(bool radians = false);
  * @return lemlib::Pose
  */
 Pose estimatePose(float time, bool radians = false);
+/**
+ * @brief Read the sensors used for odometry
+ */
+OdomSample readOdomSample();
+/**
+ * @brief Update the pose of the robot from a sample of the sensors
+ *
+ * Only uses the sensors for their layout: which exist, their offsets and which are substituted by the drivetrain. The
+ * same samples give the same poses, so recorded samples can be replayed through the same code
+ *
+ * @param sample the sensor readings
+ */
+void update(const OdomSample& sample);
 /**
  * @brief Update the pose of the robot
  *
  */
 void update();
+/**
+ * @brief Set the pose of the robot, and the readings the next update measures the change from
+ *
+ * Used to start replaying a recording from an ODOM_RESET_CHANNEL frame
+ *
+ * @param pose the new pose, theta in radians
+ * @param previous the sample of the last update
+ */
+void resetOdom(Pose pose, const OdomSample& previous);
+/**
+ * @brief Record the inputs and outputs of every odometry update
+ *
+ * The consumer gets an ODOM_RESET_CHANNEL frame now and on every setPose, and an ODOM_SAMPLE_CHANNEL frame for every
+ * update, which is all a replay needs to reproduce the poses. It is called from the odometry task, so it has to be
+ * quick, like FlightRecorder::write
+ *
+ * @param consumer function called with every frame, nullptr to stop recording
+ *
+ * @b Example
+ * @code {.cpp}
+ * void autonomous() {
+ *     recorder.start("auton");
+ *     lemlib::recordOdom([](const lemlib::TelemetryFrame& frame) { recorder.write(frame); });
+ *     // ...
+ * }
+ * @endcode
+ */
+void recordOdom(std::function<void(const TelemetryFrame& frame)> consumer);
 /**
  * @brief Initialize the odometry system
  *
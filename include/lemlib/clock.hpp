@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lemlib {
+/**
+ * @brief A source of time, which LemLib reads the time from and sleeps with
+ *
+ * Times are in microseconds since the clock started.
+ */
+class Clock {
+    public:
+        /**
+         * @brief Get the time, in microseconds
+         */
+        virtual std::uint64_t micros() = 0;
+
+        /**
+         * @brief Sleep until a time, in microseconds. Returns right away if it has passed
+         */
+        virtual void sleepUntil(std::uint64_t time) = 0;
+
+        virtual ~Clock() = default;
+};
+
+/**
+ * @brief The clock of the brain, pros::micros and pros::delay
+ *
+ * The scheduler ticks once a millisecond, so sleeps are rounded up to whole milliseconds. On the host build, PROS runs
+ * on the simulator's virtual clock, and so does this
+ */
+class SystemClock : public Clock {
+    public:
+        std::uint64_t micros() override;
+        void sleepUntil(std::uint64_t time) override;
+};
+
+/**
+ * @brief A clock that only moves when told to
+ *
+ * Sleeping moves the clock to the end of the sleep right away, so code that runs on one task, like a test of an exit
+ * condition or a timer, runs as fast as the computer can. It doesn't schedule tasks, so code with several tasks has
+ * to run on the simulator instead.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::VirtualClock clock;
+ * lemlib::setClock(&clock);
+ * lemlib::Timer timer(1000);
+ * clock.advance(999999);
+ * // the timer isn't done yet, 1us left
+ * @endcode
+ */
+class VirtualClock : public Clock {
+    public:
+        /**
+         * @brief Construct a new virtual clock
+         *
+         * @param start the time the clock starts at, in microseconds. 0 by default
+         */
+        VirtualClock(std::uint64_t start = 0);
+
+        std::uint64_t micros() override;
+        void sleepUntil(std::uint64_t time) override;
+
+        /**
+         * @brief Move the clock forwards
+         *
+         * @param time how far, in microseconds
+         */
+        void advance(std::uint64_t time);
+    private:
+        std::uint64_t time;
+};
+
+/**
+ * @brief Set the clock LemLib uses
+ *
+ * Set it before starting anything that reads the time, like calibrating the chassis or constructing a sink
+ *
+ * @param clock the clock, nullptr for the SystemClock. It has to outlive its use
+ */
+void setClock(Clock* clock);
+
+/**
+ * @brief Get the clock LemLib uses
+ */
+Clock& getClock();
+
+/**
+ * @brief Get the time from LemLib's clock, in microseconds
+ */
+std::uint64_t micros();
+
+/**
+ * @brief Get the time from LemLib's clock, in milliseconds
+ */
+std::uint32_t millis();
+
+/**
+ * @brief Sleep on LemLib's clock
+ *
+ * @param milliseconds how long to sleep
+ */
+void delay(std::uint32_t milliseconds);
+
+/**
+ * @brief Sleep until a period after the last wake up, for loops that run at a fixed rate without drifting
+ *
+ * @param previous the time of the last wake up, in microseconds. Moved forwards by the period
+ * @param period the period of the loop, in microseconds
+ *
+ * @b Example
+ * @code {.cpp}
+ * std::uint64_t wake = lemlib::micros();
+ * while (true) {
+ *     // runs every 10ms, however long the work takes
+ *     lemlib::delayUntil(wake, 10000);
+ * }
+ * @endcode
+ */
+void delayUntil(std::uint64_t& previous, std::uint64_t period);
+} // namespace lemlib
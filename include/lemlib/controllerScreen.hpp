@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+/**
+ * @brief The screen and rumble motor of a controller, written at the rate the controller accepts
+ *
+ * The controller takes one screen or rumble write every 50ms, and silently drops the writes that come sooner, so
+ * tasks writing to it directly lose text and rumbles whenever two of them write close together. Instead, tasks set the
+ * text they want on each line and queue rumbles here, which only takes a mutex and never waits for the controller.
+ * Every update sends one write: the oldest rumble queued, or else the next line whose text changed since it was last
+ * sent. A line set several times before it is sent is only sent once, with its latest text, and setting a line to the
+ * text it already shows sends nothing. A write the controller refuses is sent again on the next update.
+ *
+ * The screen is a subsystem: it has to be added to a SubsystemScheduler to run. rumbleController() sends rumbles
+ * through the screen of a controller if it has one, so rumbles from LemLib, like the one at the end of
+ * Chassis::calibrate, are queued with the rest.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::ControllerScreen controllerScreen("controller screen");
+ *
+ * void initialize() {
+ *     static lemlib::SubsystemScheduler subsystems;
+ *     subsystems.add(controllerScreen);
+ * }
+ *
+ * void opcontrol() {
+ *     while (true) {
+ *         controllerScreen.print(0, "x %.0f y %.0f", chassis.getPose().x, chassis.getPose().y);
+ *         if (ringLoaded) controllerScreen.rumble(".");
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class ControllerScreen : public Subsystem {
+    public:
+        /**
+         * @brief Construct a new controller screen
+         *
+         * @param name name of the screen, also the name of its LoopProfile. The string has to outlive it
+         * @param id the controller. The master controller by default
+         * @param period time between writes, in milliseconds. 50 by default, as often as the controller takes them
+         */
+        ControllerScreen(const char* name, pros::controller_id_e_t id = pros::E_CONTROLLER_MASTER,
+                         std::uint32_t period = 50);
+
+        ~ControllerScreen();
+
+        /**
+         * @brief Send the next write the screen needs, if any. Called by the scheduler
+         */
+        void update() override;
+
+        /**
+         * @brief Set the text of a line
+         *
+         * @param line the line, from 0 to 2
+         * @param text the text. Cut to the width of the screen, and padded with spaces to cover the text before it
+         */
+        void setText(std::uint8_t line, const std::string& text);
+
+        /**
+         * @brief Set the text of a line, formatted like printf
+         *
+         * @param line the line, from 0 to 2
+         * @param fmt the format string
+         */
+        void print(std::uint8_t line, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+
+        /**
+         * @brief Clear a line
+         *
+         * @param line the line, from 0 to 2
+         */
+        void clearLine(std::uint8_t line);
+
+        /**
+         * @brief Queue a rumble. A rumble the same as the last one queued and not yet sent is only sent once
+         *
+         * @param pattern the pattern: '.' for a short rumble, '-' for a long one and ' ' for a pause. At most 8
+         */
+        void rumble(const char* pattern);
+
+        /**
+         * @brief Get the number of writes the controller accepted
+         */
+        std::uint32_t getWrites();
+
+        /**
+         * @brief Get the number of writes saved: lines set again before they were sent, lines set to the text they
+         * already had, and repeated rumbles
+         */
+        std::uint32_t getCoalesced();
+
+        /**
+         * @brief Get the number of writes the controller refused, and that were sent again
+         */
+        std::uint32_t getRefused();
+
+        /**
+         * @brief Find the screen of a controller
+         *
+         * @return the screen, nullptr if the controller has none
+         */
+        static ControllerScreen* find(pros::controller_id_e_t id);
+
+        /**
+         * @brief Width of the screen, in characters
+         */
+        static constexpr int WIDTH = 15;
+        /**
+         * @brief Most rumbles waiting to be sent. Rumbles queued after that are dropped
+         */
+        static constexpr int MAX_RUMBLES = 4;
+    private:
+        const pros::controller_id_e_t id;
+        pros::Mutex mutex;
+        // text wanted on each line, and the text last sent
+        std::array<std::string, 3> text;
+        std::array<std::string, 3> sent;
+        std::deque<std::string> rumbles;
+        // line checked first for a change, so every line gets its turn
+        int nextLine = 0;
+
+        std::uint32_t writes = 0;
+        std::uint32_t coalesced = 0;
+        std::uint32_t refused = 0;
+
+        ControllerScreen* next = nullptr;
+};
+
+/**
+ * @brief Rumble a controller, through its ControllerScreen if it has one, or else straight away
+ *
+ * @param pattern the pattern, like ControllerScreen::rumble
+ * @param id the controller. The master controller by default
+ */
+void rumbleController(const char* pattern, pros::controller_id_e_t id = pros::E_CONTROLLER_MASTER);
+} // namespace lemlib
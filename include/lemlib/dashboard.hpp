@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+/**
+ * @brief Draw a line of text on the brain screen, the way Dashboard widgets draw by default
+ */
+void drawBrainLine(std::uint8_t line, const char* text);
+
+/**
+ * @brief A screen of text widgets, redrawn only where they changed
+ *
+ * Every frame the dashboard samples the state it shows once, through its sample function, and renders each widget
+ * from that sample. A widget is only drawn again when its text differs from what it last drew, so a dashboard of
+ * things that rarely change costs a sample and a few string compares per frame. Each widget draws to the brain screen
+ * by default, or through its own draw function, like to a ControllerScreen.
+ *
+ * The dashboard is a subsystem: it has to be added to a SubsystemScheduler to run, best one at a lower priority than
+ * the control loops. Its LoopProfile records how long each frame takes. Widgets have to be added before it runs.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::Dashboard<lemlib::Pose> dashboard("dashboard", [] { return chassis.getPose(); });
+ *
+ * void initialize() {
+ *     dashboard.addWidget(0, [](const lemlib::Pose& pose, char* text, std::size_t size) {
+ *         std::snprintf(text, size, "X: %.2f", pose.x);
+ *     });
+ *     static lemlib::SubsystemScheduler displays(50, TASK_PRIORITY_MIN + 1);
+ *     displays.add(dashboard);
+ * }
+ * @endcode
+ */
+template <typename T> class Dashboard : public Subsystem {
+    public:
+        /**
+         * @brief Renders the text of a widget from a sample, into a buffer of WIDTH characters
+         */
+        using Render = std::function<void(const T& state, char* text, std::size_t size)>;
+        /**
+         * @brief Draws the text of a widget on a line
+         */
+        using Draw = std::function<void(std::uint8_t line, const char* text)>;
+
+        /**
+         * @brief Construct a new dashboard
+         *
+         * @param name name of the dashboard, also the name of its LoopProfile. The string has to outlive it
+         * @param sample function sampling the state the widgets show, called once per frame
+         * @param period time between frames, in milliseconds. 50 by default
+         */
+        Dashboard(const char* name, std::function<T()> sample, std::uint32_t period = 50)
+            : Subsystem(name, period),
+              sample(std::move(sample)) {}
+
+        /**
+         * @brief Add a widget. It is drawn on the first frame
+         *
+         * @param line the line it is drawn on
+         * @param render function rendering its text
+         * @param draw function drawing the text. The line of the brain screen by default
+         */
+        void addWidget(std::uint8_t line, Render render, Draw draw = nullptr) {
+            if (!draw) draw = drawBrainLine;
+            widgets.push_back({line, std::move(render), std::move(draw)});
+        }
+
+        /**
+         * @brief Sample the state, and redraw the widgets that changed. Called by the scheduler
+         */
+        void update() override {
+            const T state = sample();
+            for (Widget& widget : widgets) {
+                char text[WIDTH] = "";
+                widget.render(state, text, sizeof(text));
+                if (widget.drawn && std::strcmp(text, widget.shown) == 0) continue;
+                std::memcpy(widget.shown, text, sizeof(text));
+                widget.drawn = true;
+                widget.draw(widget.line, text);
+                redraws.fetch_add(1, std::memory_order_relaxed);
+            }
+            frames.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the number of frames drawn
+         */
+        std::uint32_t getFrames() const { return frames.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get the number of times a widget was drawn. A widget that didn't change isn't
+         */
+        std::uint32_t getRedraws() const { return redraws.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Longest text of a widget, including the terminating null
+         */
+        static constexpr std::size_t WIDTH = 48;
+    private:
+        struct Widget {
+                std::uint8_t line;
+                Render render;
+                Draw draw;
+                // text last drawn, and whether there is any
+                char shown[WIDTH] = "";
+                bool drawn = false;
+        };
+
+        std::function<T()> sample;
+        std::vector<Widget> widgets;
+        std::atomic<std::uint32_t> frames = 0;
+        std::atomic<std::uint32_t> redraws = 0;
+};
+} // namespace lemlib
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace lemlib {
 class ExitCondition {
     public:
@@ -62,7 +64,8 @@ class ExitCondition {
     protected:
         const float range;
         const int time;
-        int startTime = -1;
+        // when the input came in range, in microseconds. -1 if it isn't
+        std::int64_t startTime = -1;
         bool done = false;
 };
 } // namespace lemlib
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "robodash/api.h"
+#include "pros/rtos.hpp"
+#include "lemlib/pose.hpp"
+#include "lemlib/poseHistory.hpp"
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+/**
+ * @brief A robodash view of the field, with where the robot thinks it is, the path it plans to follow and the trail
+ * of where it has been
+ *
+ * The view is an LVGL canvas the field view draws into itself. The field, the path and the trail are drawn into a
+ * base image that only changes where the trail grows; the robot is drawn over a copy of it. Every frame only redraws
+ * what changed: the new stretch of trail, and the robot where it was and where it is now. Only those rectangles are
+ * invalidated, so LVGL only redraws them too, and a robot standing still costs nothing to draw.
+ *
+ * The trail and the pose come from a PoseHistory, so drawing never reads the odometry. The field view is a subsystem:
+ * it has to be added to a SubsystemScheduler to run, best one at a lower priority than the control loops. Its view is
+ * created on the first frame.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::PoseHistory poseHistory("pose history", [] { return chassis.getPose(); }, 1);
+ * // the routines start at (0, 0), on the tile left of the red alliance stake
+ * lemlib::FieldView fieldView("field", &poseHistory, {-60, 0, 90});
+ *
+ * void initialize() {
+ *     subsystems.add(poseHistory);
+ *     displays.add(fieldView);
+ * }
+ * @endcode
+ */
+class FieldView : public Subsystem {
+    public:
+        /**
+         * @brief Construct a new field view
+         *
+         * @param name name of the view in robodash, also the name of its LoopProfile. The string has to outlive it
+         * @param history the history the pose and the trail come from
+         * @param origin where the robot is on the field at pose (0, 0, 0), in inches from the center of the field, with
+         * the red alliance on the left, and degrees. The center of the field facing away from red by default
+         * @param period time between frames, in milliseconds. 100 by default
+         */
+        FieldView(const char* name, PoseHistory* history, Pose origin = {0, 0, 0}, std::uint32_t period = 100);
+
+        /**
+         * @brief Draw the poses kept since the last frame, and the robot where it is now. Called by the scheduler
+         */
+        void update() override;
+
+        /**
+         * @brief Show a path the robot plans to follow, replacing the last one. Redraws the whole field
+         *
+         * @param path the points of the path, in the coordinates of the pose
+         */
+        void setPath(const std::vector<Pose>& path);
+
+        /**
+         * @brief Forget the trail. Redraws the whole field
+         */
+        void clearTrail();
+
+        /**
+         * @brief Make the view the active robodash view
+         */
+        void focus();
+
+        /**
+         * @brief Get the number of frames drawn
+         */
+        std::uint32_t getFrames();
+
+        /**
+         * @brief Get the number of pixels invalidated in every frame together. A whole frame is SIZE * SIZE
+         */
+        std::uint64_t getDirtyPixels();
+
+        /**
+         * @brief Get the number of times the whole field was redrawn
+         */
+        std::uint32_t getFullRedraws();
+
+        /**
+         * @brief Width and height of the canvas, in pixels
+         */
+        static constexpr int SIZE = 216;
+    private:
+        struct Rect {
+                int x1 = SIZE;
+                int y1 = SIZE;
+                int x2 = -1;
+                int y2 = -1;
+
+                bool empty() const { return x2 < x1 || y2 < y1; }
+
+                void add(int x, int y);
+                void add(const Rect& other);
+                int area() const;
+        };
+
+        /**
+         * @brief Get where a pose is on the field
+         */
+        Pose toField(const Pose& pose) const;
+
+        /**
+         * @brief Get the pixel a point on the field is at
+         */
+        void toPixel(float x, float y, int& px, int& py) const;
+
+        /**
+         * @brief Draw a line into an image
+         */
+        void drawLine(std::vector<lv_color_t>& image, int x0, int y0, int x1, int y1, lv_color_t color, Rect& dirty);
+
+        /**
+         * @brief Draw the robot into the canvas, returning where
+         */
+        Rect drawRobot(const Pose& pose);
+
+        /**
+         * @brief Draw the field, the path and the trail into the base image, and copy it to the canvas
+         */
+        void drawBase();
+
+        /**
+         * @brief Copy part of the base image to the canvas
+         */
+        void restore(const Rect& rect);
+
+        /**
+         * @brief Tell LVGL to redraw part of the canvas
+         */
+        void invalidate(const Rect& rect);
+
+        PoseHistory* history;
+        const Pose origin;
+        pros::Mutex mutex;
+        rd_view_t* view = nullptr;
+        lv_obj_t* canvas = nullptr;
+        // the field, the path and the trail, and the canvas, which is the base with the robot on it
+        std::vector<lv_color_t> base;
+        std::vector<lv_color_t> pixels;
+
+        std::vector<Pose> path;
+        std::vector<PoseHistory::Entry> trail;
+        std::uint32_t sequence = 0;
+        bool baseChanged = true;
+        Rect robot;
+        Pose lastPose = {0, 0, 0};
+        bool robotDrawn = false;
+        bool focusing = false;
+
+        std::uint32_t frames = 0;
+        std::uint64_t dirtyPixels = 0;
+        std::uint32_t fullRedraws = 0;
+};
+} // namespace lemlib
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+/**
+ * @brief class containing constants for a controller input sampler
+ */
+class InputSettings {
+    public:
+        /**
+         * @brief InputSettings constructor
+         *
+         * @param holdTime how long a button has to stay pressed to be held, in milliseconds
+         * @param doubleTapTime the longest time from one press to the next for them to be a double tap, in milliseconds
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::InputSettings inputSettings(400, // held after 400ms
+         *                                     250); // double tapped within 250ms
+         * @endcode
+         */
+        InputSettings(std::uint32_t holdTime, std::uint32_t doubleTapTime)
+            : holdTime(holdTime),
+              doubleTapTime(doubleTapTime) {}
+
+        std::uint32_t holdTime;
+        std::uint32_t doubleTapTime;
+};
+
+/**
+ * @brief What happened to a button
+ */
+enum class InputEventType {
+    PRESS, /** the button was pressed */
+    RELEASE, /** the button was released */
+    HOLD, /** the button has been pressed for the hold time. Sent once per press */
+    DOUBLE_TAP /** the button was pressed again within the double tap time. Sent after the PRESS */
+};
+
+/**
+ * @brief Something that happened to a button, as seen by a sample of the controller
+ */
+struct InputEvent {
+        pros::controller_digital_e_t button;
+        InputEventType type;
+        /** time of the sample that saw it, in milliseconds */
+        std::uint32_t time;
+        /** how long the button was pressed for a RELEASE or HOLD, or since the last press for a DOUBLE_TAP, in ms */
+        std::uint32_t duration;
+};
+
+/**
+ * @brief The events of some of the buttons, for one subscriber of a ControllerInput
+ *
+ * Events are kept in order until the subscriber takes them. A queue that is full drops its newest events, and counts
+ * them: a subscriber that takes its events every update never drops any. The queue also records how long its events
+ * waited between the sample that saw them and being taken.
+ */
+class InputQueue {
+    public:
+        InputQueue(const InputQueue&) = delete;
+        InputQueue& operator=(const InputQueue&) = delete;
+
+        /**
+         * @brief Take the oldest event, if there is one
+         *
+         * @param event set to the event
+         * @return whether there was an event
+         */
+        bool pop(InputEvent& event);
+
+        /**
+         * @brief Take the oldest event, waiting for one if there is none
+         *
+         * The waiting task is woken by the sample that sees the event.
+         *
+         * @param event set to the event
+         * @param timeout the longest time to wait, in milliseconds. Forever by default
+         * @return whether there was an event before the timeout ran out
+         */
+        bool wait(InputEvent& event, std::uint32_t timeout = TIMEOUT_MAX);
+
+        /**
+         * @brief Drop every event in the queue, like presses made before the subscriber started to listen
+         */
+        void clear();
+
+        /**
+         * @brief Get the number of events put in the queue, not counting the dropped ones
+         */
+        std::uint32_t getReceived();
+
+        /**
+         * @brief Get the number of events dropped because the queue was full
+         */
+        std::uint32_t getDropped();
+
+        /**
+         * @brief Get the average time events taken waited since the sample that saw them, in milliseconds
+         */
+        float getMeanLatency();
+
+        /**
+         * @brief Get the longest time an event taken waited since the sample that saw it, in milliseconds
+         */
+        std::uint32_t getMaxLatency();
+    private:
+        friend class ControllerInput;
+
+        InputQueue(std::uint16_t buttons, std::size_t capacity);
+
+        /**
+         * @brief Put an event in the queue if it is about one of the buttons, and wake a waiting task
+         */
+        void push(const InputEvent& event);
+
+        /**
+         * @brief Take the oldest event and record its latency. The mutex has to be held
+         */
+        bool take(InputEvent& event);
+
+        // one bit per button, from E_CONTROLLER_DIGITAL_L1
+        const std::uint16_t buttons;
+        const std::size_t capacity;
+        pros::Mutex mutex;
+        std::deque<InputEvent> events;
+        std::vector<pros::task_t> waiting;
+
+        std::uint32_t received = 0;
+        std::uint32_t dropped = 0;
+        std::uint32_t taken = 0;
+        std::uint64_t totalLatency = 0;
+        std::uint32_t maxLatency = 0;
+};
+
+/**
+ * @brief Samples a controller once per update, and sends what happened to its buttons to subscribers
+ *
+ * Every update reads each button and joystick of the controller once. A button changing from one sample to the next is
+ * a press or a release, and the sampler tracks how long each button has been pressed and when it was last pressed, for
+ * holds and double taps. The events are put in the queue of every subscriber of that button, so every subscriber sees
+ * every press, however often it looks and however many subscribers a button has. This replaces tasks calling
+ * get_digital_new_press themselves, where the first task to look at a button takes the press from the others, and a
+ * press shorter than a task's loop can fall between two of its reads.
+ *
+ * Tasks that want the level of a button or a joystick read it from the last sample instead of the controller. The
+ * sampler is a subsystem: it has to be added to a SubsystemScheduler to run, before its subscribers so they see the
+ * events of a sample in the same tick.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Controller controller(pros::E_CONTROLLER_MASTER);
+ * lemlib::ControllerInput input("controller", &controller, inputSettings);
+ * lemlib::InputQueue& clampButton = input.subscribe({pros::E_CONTROLLER_DIGITAL_Y});
+ *
+ * void opcontrol() {
+ *     while (true) {
+ *         lemlib::InputEvent event;
+ *         while (clampButton.pop(event)) {
+ *             if (event.type == lemlib::InputEventType::PRESS) toggleClamp();
+ *         }
+ *         chassis.arcade(input.getAnalog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
+ *                        input.getAnalog(pros::E_CONTROLLER_ANALOG_RIGHT_X));
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class ControllerInput : public Subsystem {
+    public:
+        /**
+         * @brief Construct a new controller input sampler
+         *
+         * @param name name of the sampler, also the name of its LoopProfile. The string has to outlive it
+         * @param controller the controller
+         * @param settings the hold and double tap times
+         * @param period time between samples, in milliseconds. 10 by default. A press shorter than this can be missed
+         */
+        ControllerInput(const char* name, pros::Controller* controller, InputSettings settings,
+                        std::uint32_t period = 10);
+
+        /**
+         * @brief Sample the controller, and send the events it saw. Called by the scheduler
+         */
+        void update() override;
+
+        /**
+         * @brief Subscribe to the events of some buttons
+         *
+         * @param buttons the buttons
+         * @param capacity the most events the queue keeps. 16 by default
+         * @return the queue the events are put in. It lives as long as the sampler
+         */
+        InputQueue& subscribe(std::initializer_list<pros::controller_digital_e_t> buttons, std::size_t capacity = 16);
+
+        /**
+         * @brief Whether a button was pressed at the last sample
+         */
+        bool isPressed(pros::controller_digital_e_t button);
+
+        /**
+         * @brief Get how long a button has been pressed at the last sample, in milliseconds. 0 if it isn't pressed
+         */
+        std::uint32_t getHoldTime(pros::controller_digital_e_t button);
+
+        /**
+         * @brief Get a joystick channel at the last sample, from -127 to 127
+         */
+        std::int32_t getAnalog(pros::controller_analog_e_t channel);
+
+        /**
+         * @brief Get the number of presses seen, of every button
+         */
+        std::uint32_t getPresses();
+    private:
+        static constexpr int BUTTONS = 12;
+
+        pros::Controller* controller;
+        InputSettings settings;
+        pros::Mutex mutex;
+        std::vector<std::unique_ptr<InputQueue>> queues;
+
+        std::array<bool, BUTTONS> pressed {};
+        std::array<bool, BUTTONS> held {};
+        std::array<std::uint32_t, BUTTONS> pressedSince {};
+        // time of the last press of each button, and whether there was one
+        std::array<std::uint32_t, BUTTONS> lastPress {};
+        std::array<bool, BUTTONS> pressedBefore {};
+        std::array<std::int32_t, 4> analog {};
+        std::uint32_t sampleTime = 0;
+        std::uint32_t presses = 0;
+};
+} // namespace lemlib
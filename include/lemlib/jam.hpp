@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "pros/motors.hpp"
+#include "lemlib/output.hpp"
+
+namespace lemlib {
+/**
+ * @brief class containing constants for a jam detector
+ */
+class JamSettings {
+    public:
+        /**
+         * @brief JamSettings constructor
+         *
+         * A motor is jammed when, for the whole jam time, it is driven but draws at least the stall current and torque,
+         * turns slower than the stall velocity, and isn't speeding up. A ring slowing the motor down keeps it turning,
+         * and a motor starting up speeds up, so neither counts as a jam however much current they draw.
+         *
+         * @param stallCurrent current above which the motor is straining, in milliamps
+         * @param stallTorque torque above which the motor is straining, in Nm
+         * @param stallVelocity speed below which the motor is stopped, in rpm
+         * @param jamTime how long the motor has to be stopped and straining to be jammed, in milliseconds. At most
+         * JamDetector::WINDOW updates
+         * @param escalationTime a jam within this long after a recovery ends runs the next recovery step, in
+         * milliseconds. A later jam starts from the first step again
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::JamSettings intakeJam(1800, // strained above 1800mA
+         *                               0.25, // and 0.25Nm
+         *                               90, // stopped below 90rpm
+         *                               40, // for 40ms
+         *                               1000); // escalate if it jams again within 1s
+         * @endcode
+         */
+        JamSettings(float stallCurrent, float stallTorque, float stallVelocity, std::uint32_t jamTime,
+                    std::uint32_t escalationTime)
+            : stallCurrent(stallCurrent),
+              stallTorque(stallTorque),
+              stallVelocity(stallVelocity),
+              jamTime(jamTime),
+              escalationTime(escalationTime) {}
+
+        float stallCurrent;
+        float stallTorque;
+        float stallVelocity;
+        std::uint32_t jamTime;
+        std::uint32_t escalationTime;
+};
+
+/**
+ * @brief One step of a jam recovery: a power to run the motor at, and for how long
+ */
+struct RecoveryStep {
+        /** power from -127 to 127, like pros::Motor::move */
+        int power;
+        /** time to run at that power, in milliseconds */
+        std::uint32_t time;
+};
+
+/**
+ * @brief Detects a motor jamming, and takes it over to clear the jam
+ *
+ * Every update samples the current, torque, velocity and voltage of the motor into a short window. Once the window
+ * shows a jam, the detector runs a recovery step through its writer, which should have a higher priority than the
+ * other writers of the motor, and releases it afterwards. If the motor jams again soon after, the next step runs, so
+ * the recovery escalates, for example from a short reverse to a long one to stopping the motor for a while. The last
+ * step repeats if the jams keep coming.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Motor intake(1, pros::MotorGearset::blue);
+ * lemlib::MotorOutput intakeOutput(&intake);
+ * lemlib::JamDetector intakeJam(&intake, intakeOutput.writer("unjam", 2), intakeJamSettings,
+ *                               {{-90, 80}, {-127, 250}, {0, 1000}});
+ *
+ * // in a subsystem, every 10ms
+ * const bool unjamming = intakeJam.update();
+ * @endcode
+ */
+class JamDetector {
+    public:
+        /** the most samples the window holds */
+        static constexpr std::size_t WINDOW = 16;
+
+        /**
+         * @brief Construct a new jam detector
+         *
+         * @param motor the motor to watch
+         * @param writer the writer the recovery drives the motor through
+         * @param settings the constants of the detector
+         * @param recovery the recovery steps, from the first jam to the last. Must not be empty
+         */
+        JamDetector(pros::Motor* motor, MotorOutput::Writer writer, JamSettings settings,
+                    std::vector<RecoveryStep> recovery);
+
+        /**
+         * @brief Sample the motor, and start or continue a recovery
+         *
+         * @param detect whether to look for jams. A recovery that already started finishes either way
+         * @return whether the detector is recovering from a jam
+         */
+        bool update(bool detect = true);
+
+        /**
+         * @brief Whether the detector is recovering from a jam
+         */
+        bool isRecovering() const;
+
+        /**
+         * @brief Get the recovery step running, or that ran last. -1 before the first jam
+         */
+        int getStep() const;
+
+        /**
+         * @brief Get how many jams were detected
+         */
+        int getJams() const;
+    private:
+        struct Sample {
+                std::uint32_t time;
+                float current;
+                float torque;
+                float velocity;
+                float voltage;
+        };
+
+        /**
+         * @brief Whether the samples in the window over the jam time show a jam
+         */
+        bool jammed() const;
+
+        pros::Motor* motor;
+        MotorOutput::Writer writer;
+        JamSettings settings;
+        std::vector<RecoveryStep> recovery;
+
+        // the last samples, oldest overwritten first
+        std::array<Sample, WINDOW> window;
+        std::size_t next = 0;
+        std::size_t count = 0;
+
+        bool recovering = false;
+        int step = -1;
+        std::uint32_t stepSince = 0;
+        std::uint32_t recoveredAt = 0;
+        int jams = 0;
+};
+} // namespace lemlib
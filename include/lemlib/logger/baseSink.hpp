@@ -1,15 +1,71 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <initializer_list>
+#include <new>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include "pros/rtos.hpp"
 
 #define FMT_HEADER_ONLY
 #include "fmt/core.h"
 #include "fmt/args.h"
 
+#include "lemlib/clock.hpp"
+#include "lemlib/logger/buffer.hpp"
 #include "lemlib/logger/message.hpp"
+#include "lemlib/pose.hpp"
 
 namespace lemlib {
+/**
+ * @brief Whether a sink can copy an argument of a type into a record, and format it later on the logger task
+ *
+ * Numbers and enums can. Any other type is formatted when it is logged, unless it opts in by specializing this, which
+ * only a trivially copyable type that holds its whole value can: no pointers, references, views or iterators.
+ *
+ * @b Example
+ * @code {.cpp}
+ * template <> struct lemlib::DeferredLogArg<Gains> : std::true_type {};
+ * @endcode
+ */
+template <typename T> struct DeferredLogArg : std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T>> {};
+
+template <> struct DeferredLogArg<Pose> : std::true_type {};
+
+/**
+ * @brief The format of a log call, and whether the logger task can still read it later
+ *
+ * Formats checked at compile time are literals, which outlive any message. A format made at run time with fmt::runtime
+ * might be gone by the time the logger task gets to the message, so messages logged with one are formatted right away.
+ */
+template <typename... T> class BasicLogFormat {
+    public:
+        template <typename S, typename = std::enable_if_t<std::is_convertible_v<const S&, fmt::string_view>>>
+        consteval BasicLogFormat(const S& format)
+            : format(format),
+              literal(true) {}
+
+        BasicLogFormat(fmt::runtime_format_string<> format)
+            : format(format),
+              literal(false) {}
+
+        BasicLogFormat(fmt::format_string<T...> format)
+            : format(format),
+              literal(false) {}
+
+        fmt::format_string<T...> format;
+        /** whether the format is a literal */
+        bool literal;
+};
+
+/**
+ * @brief The format of a log call with arguments of the given types
+ */
+template <typename... T> using LogFormat = BasicLogFormat<fmt::type_identity_t<T>...>;
+
 /**
  * @brief A base for any sink in LemLib to implement.
  *
@@ -34,6 +90,34 @@ class BaseSink {
          */
         BaseSink(std::initializer_list<std::shared_ptr<BaseSink>> sinks);
 
+        /**
+         * @brief Destroy the sink, once the logger task is done with the messages it logged
+         *
+         * Messages still waiting are handed to this base, which ignores them. A derived sink that can be destroyed while
+         * it has messages waiting should call flush() in its own destructor, so they reach its sendMessage.
+         */
+        virtual ~BaseSink();
+
+        BaseSink(const BaseSink&) = delete;
+        BaseSink& operator=(const BaseSink&) = delete;
+
+        /**
+         * @brief Send every message this sink logged that is still waiting for the logger task, on the calling task
+         * If this is a combined sink, this operation will
+         * apply for all the parent sinks.
+         *
+         * Messages other sinks logged before them are sent too. Must not be called from sendMessage.
+         */
+        void flush();
+
+        /**
+         * @brief Get the number of messages of every sink dropped because too many were waiting for the logger task
+         *
+         * Up to 64 messages can wait at once, so a burst of them, like every motion logging at the debug level, can
+         * overflow it.
+         */
+        static std::uint32_t getDroppedRecords();
+
         /**
          * @brief Set the lowest level.
          * If this is a combined sink, this operation will
@@ -60,35 +144,46 @@ class BaseSink {
          * @param format The format that the message will use. Use "{}" as placeholders.
          * @param args The values that will be substituted into the placeholders in the format.
          *
+         * Arguments that can be copied as bytes, like numbers and poses, are copied and formatted later by the logger
+         * task, so logging from a control loop only costs a copy. Strings are formatted right away, since the memory
+         * they refer to might be gone by then, and so are messages with a format made at run time with fmt::runtime.
+         * A sink that is destroyed first waits for the logger task to be done with its messages.
+         *
+         * A message formatted right away travels to the logger task in a record of 128 bytes, which leaves room for
+         * 88 characters of text on the brain, and 72 on the host. Longer text is cut short, and ends with
+         * " <truncated>" so the cut is visible.
+         *
          * <h3> Example Usage </h3>
          * @code
          * sink.log(lemlib::Level::INFO, "{} from the logger!", "Hello");
          * @endcode
 
          */
-        template <typename... T> void log(Level level, fmt::format_string<T...> format, T&&... args) {
+        template <typename... T> void log(Level level, LogFormat<T...> format, T&&... args) {
             if (!sinks.empty()) {
-                for (std::shared_ptr<BaseSink> sink : sinks) { sink->log(level, format, std::forward<T>(args)...); }
+                for (const std::shared_ptr<BaseSink>& sink : sinks) {
+                    sink->log(level, format, std::forward<T>(args)...);
+                }
                 return;
             }
 
             if (level < lowestLevel) { return; }
 
-            // substitute the user's arguments into the format.
-            std::string messageString = fmt::format(format, std::forward<T>(args)...);
-
-            Message message = Message {.level = level, .time = pros::millis()};
-
-            // get the arguments
-            fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
-
-            formattingArgs.push_back(fmt::arg("time", message.time));
-            formattingArgs.push_back(fmt::arg("level", message.level));
-            formattingArgs.push_back(fmt::arg("message", messageString));
-
-            std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
-            message.message = std::move(formattedString);
-            sendMessage(std::move(message));
+            if constexpr ((deferrable<std::remove_cvref_t<T>> && ...) &&
+                          sizeof(Record) + (0 + ... + sizeof(std::remove_cvref_t<T>)) <= RECORD_SIZE) {
+                if (format.literal) {
+                    // copy the arguments into a record, and leave the formatting to the logger task
+                    Record record {this, &formatArgs<std::remove_cvref_t<T>...>, format.format.get(), level, micros(),
+                                   sizeof(Record)};
+                    char data[RECORD_SIZE];
+                    ((std::memcpy(data + record.size, &args, sizeof(args)), record.size += sizeof(args)), ...);
+                    push(record, data);
+                    return;
+                }
+            }
+            // arguments that point to memory the caller owns, like strings, and formats that aren't literals have to be
+            // formatted now
+            pushText(level, micros(), fmt::format(format.format, std::forward<T>(args)...));
         }
 
         /**
@@ -99,7 +194,7 @@ class BaseSink {
          * @param format
          * @param args
          */
-        template <typename... T> void debug(fmt::format_string<T...> format, T&&... args) {
+        template <typename... T> void debug(LogFormat<T...> format, T&&... args) {
             log(Level::DEBUG, format, std::forward<T>(args)...);
         }
 
@@ -111,7 +206,7 @@ class BaseSink {
          * @param format
          * @param args
          */
-        template <typename... T> void info(fmt::format_string<T...> format, T&&... args) {
+        template <typename... T> void info(LogFormat<T...> format, T&&... args) {
             log(Level::INFO, format, std::forward<T>(args)...);
         }
 
@@ -123,7 +218,7 @@ class BaseSink {
          * @param format
          * @param args
          */
-        template <typename... T> void warn(fmt::format_string<T...> format, T&&... args) {
+        template <typename... T> void warn(LogFormat<T...> format, T&&... args) {
             log(Level::WARN, format, std::forward<T>(args)...);
         }
 
@@ -135,7 +230,7 @@ class BaseSink {
          * @param format
          * @param args
          */
-        template <typename... T> void error(fmt::format_string<T...> format, T&&... args) {
+        template <typename... T> void error(LogFormat<T...> format, T&&... args) {
             log(Level::ERROR, format, std::forward<T>(args)...);
         }
 
@@ -147,7 +242,7 @@ class BaseSink {
          * @param format
          * @param args
          */
-        template <typename... T> void fatal(fmt::format_string<T...> format, T&&... args) {
+        template <typename... T> void fatal(LogFormat<T...> format, T&&... args) {
             log(Level::FATAL, format, std::forward<T>(args)...);
         }
     protected:
@@ -166,6 +261,7 @@ class BaseSink {
          * Changing the format of the sink changes the way each logged message looks. The following named formatting
          * specifiers can be used:
          * - {time} The time the message was sent in milliseconds since the program started.
+         * - {micros} The same time in microseconds.
          * - {level} The level of the logged message.
          * - {message} The message itself.
          *
@@ -201,6 +297,98 @@ class BaseSink {
          */
         virtual fmt::dynamic_format_arg_store<fmt::format_context> getExtraFormattingArgs(const Message& messageInfo);
     private:
+        /**
+         * @brief Header of a message waiting to be formatted, followed by its arguments
+         */
+        struct Record {
+                /** the sink that logged the message */
+                BaseSink* sink;
+                /** formats the arguments that follow the header */
+                void (*formatter)(fmt::string_view format, const char* args, std::size_t size, std::string& out);
+                /** the format, a literal that outlives the record. Empty for text formatted when it was logged */
+                fmt::string_view format;
+                Level level;
+                /** when the message was logged, in microseconds */
+                std::uint64_t time;
+                /** size of the header and the arguments, in bytes */
+                std::uint32_t size;
+        };
+
+        /** largest record, in bytes */
+        static constexpr std::size_t RECORD_SIZE = 128;
+        /** marker ending text that was cut to fit in a record */
+        static constexpr std::string_view TRUNCATED_MARKER = " <truncated>";
+
+        /**
+         * @brief Copy text formatted when it was logged into a record, cut to fit with a marker, and push it
+         */
+        void pushText(Level level, std::uint64_t time, const std::string& text);
+
+        /**
+         * @brief Push a record, its header written to the start of data, and count it as waiting
+         */
+        void push(const Record& record, char* data);
+
+        /**
+         * @brief Whether an argument can be copied into a record and formatted later
+         *
+         * Only types allowed by DeferredLogArg are. Anything that could refer to memory the caller owns, like strings,
+         * spans or pointers, is formatted when it is logged, since the memory might be gone by then.
+         */
+        template <typename T>
+        static constexpr bool deferrable = DeferredLogArg<T>::value && std::is_trivially_copyable_v<T>;
+
+        /**
+         * @brief Copy of an argument taken out of a record, aligned for its type
+         */
+        template <typename T> struct Argument {
+                alignas(T) unsigned char bytes[sizeof(T)];
+
+                const T& get() const { return *std::launder(reinterpret_cast<const T*>(bytes)); }
+        };
+
+        /**
+         * @brief Format the arguments of a record
+         */
+        template <typename... T>
+        static void formatArgs(fmt::string_view format, const char* args, std::size_t size, std::string& out) {
+            // a record cut short holds fewer arguments than its format needs
+            if (size < (0 + ... + sizeof(T))) {
+                out.append("<truncated log record>");
+                return;
+            }
+            std::tuple<Argument<T>...> arguments;
+            std::apply(
+                [&](auto&... argument) {
+                    ((std::memcpy(argument.bytes, args, sizeof(argument.bytes)), args += sizeof(argument.bytes)), ...);
+                    fmt::vformat_to(std::back_inserter(out), format, fmt::make_format_args(argument.get()...));
+                },
+                arguments);
+        }
+
+        /**
+         * @brief Copy the text of a record that was formatted when it was logged
+         */
+        static void formatText(fmt::string_view format, const char* args, std::size_t size, std::string& out);
+
+        /**
+         * @brief Get the buffer records wait in, and the task that formats them
+         */
+        static Buffer& records();
+
+        /**
+         * @brief Format and send every record in a drained batch
+         */
+        static void processRecords(const std::string& records);
+
+        /**
+         * @brief Apply the format of the sink to a message, and send it
+         */
+        void deliver(Level level, std::uint64_t time, std::string text);
+
+        /** number of records this sink logged that the logger task hasn't sent yet */
+        std::atomic<std::uint32_t> waiting = 0;
+
         Level lowestLevel = Level::WARN;
         std::string logFormat;
 
@@ -1,25 +1,44 @@
 #pragma once
 
-#include <deque>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "pros/rtos.hpp"
 
 namespace lemlib {
+/**
+ * @brief What a buffer does when a message is pushed while it is full
+ */
+enum class OverflowPolicy {
+    /** drop the new message and count it. Logging never blocks */
+    DROP,
+    /** wait for the buffer task to make room. Nothing is lost, but logging can stall the caller */
+    BLOCK
+};
+
 /**
  * @brief A buffer implementation
  *
- * Asynchronously processes a backlog of strings at a given rate. The strings are processed in a first in last out
- * order.
+ * Asynchronously processes a backlog of strings at a given rate, in the order they were pushed. Messages are copied
+ * into a fixed number of preallocated slots of a lock-free ring, so pushing never allocates or takes a mutex and any
+ * task can push at the same time. Every time the buffer task wakes up, it processes everything pending at once.
  */
 class Buffer {
     public:
         /**
          * @brief Construct a new Buffer object
          *
+         * @param bufferFunc function called with the pending messages, concatenated, every time the task wakes up
+         * @param capacity number of messages the buffer holds. Rounded up to a power of 2. 64 by default
+         * @param slotSize longest message in bytes. Longer messages are truncated. 256 by default
+         * @param policy what to do when the buffer is full. Drop by default
          */
-        Buffer(std::function<void(const std::string&)> bufferFunc);
+        Buffer(std::function<void(const std::string&)> bufferFunc, std::uint32_t capacity = 64,
+               std::uint32_t slotSize = 256, OverflowPolicy policy = OverflowPolicy::DROP);
 
         /**
          * @brief Destroy the Buffer object
@@ -33,22 +52,45 @@ class Buffer {
         /**
          * @brief Push to the buffer
          *
-         * @param bufferData
+         * @param bufferData the message
+         * @return true if the message was pushed, false if it was dropped
          */
-        void pushToBuffer(const std::string& bufferData);
+        bool pushToBuffer(std::string_view bufferData);
 
         /**
          * @brief Set the rate of the sink
          *
-         * @param rate
+         * @param rate time between the buffer task processing the pending messages, in milliseconds
          */
         void setRate(uint32_t rate);
 
+        /**
+         * @brief Set what to do when the buffer is full
+         */
+        void setOverflowPolicy(OverflowPolicy policy);
+
         /**
          * @brief Check to see if the internal buffer is empty
          *
          */
         bool buffersEmpty();
+
+        /**
+         * @brief Process every pending message on the calling task, without waiting for the buffer task
+         *
+         * Must not be called from the function processing the messages.
+         */
+        void flush();
+
+        /**
+         * @brief Get the number of messages dropped because the buffer was full
+         */
+        std::uint32_t getDropped() const;
+
+        /**
+         * @brief Get the number of messages truncated because they were longer than a slot
+         */
+        std::uint32_t getTruncated() const;
     private:
         /**
          * @brief The function that will be run inside of the buffer's task.
@@ -57,16 +99,37 @@ class Buffer {
         void taskLoop();
 
         /**
-         * @brief The function that will be applied to each string in the buffer when it is removed.
+         * @brief Process every pending message
+         */
+        void drain();
+
+        /**
+         * @brief The function that will be applied to the pending messages when they are removed.
          *
          */
-        std::function<void(std::string)> bufferFunc;
+        std::function<void(const std::string&)> bufferFunc;
 
-        std::deque<std::string> buffer = {};
+        // ring of slots. Each slot has a sequence number: equal to the position of the next push into it when it is
+        // free, one more than that once the message is written, which is how producers and the task hand it over
+        const std::uint32_t capacity;
+        const std::uint32_t slotSize;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> sequences;
+        std::unique_ptr<std::uint32_t[]> lengths;
+        std::unique_ptr<char[]> slots;
+        // next position to push to, shared by producers, and next position to pop, only changed by the task
+        std::atomic<std::uint32_t> pushPosition = 0;
+        std::atomic<std::uint32_t> popPosition = 0;
 
-        pros::Mutex mutex;
-        pros::Task task;
+        std::atomic<OverflowPolicy> policy;
+        std::atomic<std::uint32_t> dropped = 0;
+        std::atomic<std::uint32_t> truncated = 0;
+        // concatenated messages of one drain, reserved up front
+        std::string output;
+        // held while draining, so flush and the task take turns
+        pros::Mutex drainMutex;
 
-        uint32_t rate;
+        std::atomic<uint32_t> rate = 50;
+        // started at the end of the constructor, once the ring is ready
+        std::unique_ptr<pros::Task> task;
 };
 } // namespace lemlib
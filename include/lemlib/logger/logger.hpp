@@ -10,17 +10,83 @@
 #include "lemlib/logger/infoSink.hpp"
 #include "lemlib/logger/telemetrySink.hpp"
 
+// Lowest level compiled into LemLib's own log calls, and the lowest level for each module, which default to it. Set
+// them with the name of a level, for example -DLEMLIB_LOG_LEVEL=WARN. Release builds, which define NDEBUG, leave out
+// everything below WARN by default.
+#ifndef LEMLIB_LOG_LEVEL
+#ifdef NDEBUG
+#define LEMLIB_LOG_LEVEL WARN
+#else
+#define LEMLIB_LOG_LEVEL INFO
+#endif
+#endif
+#ifndef LEMLIB_LOG_LEVEL_CHASSIS
+#define LEMLIB_LOG_LEVEL_CHASSIS LEMLIB_LOG_LEVEL
+#endif
+#ifndef LEMLIB_LOG_LEVEL_MOTION
+#define LEMLIB_LOG_LEVEL_MOTION LEMLIB_LOG_LEVEL
+#endif
+#ifndef LEMLIB_LOG_LEVEL_ODOM
+#define LEMLIB_LOG_LEVEL_ODOM LEMLIB_LOG_LEVEL
+#endif
+
 namespace lemlib {
+/**
+ * @brief Part of LemLib a message is logged from
+ */
+enum class Module {
+    /** setup and calibration of the chassis */
+    CHASSIS,
+    /** the motion loops */
+    MOTION,
+    /** position tracking */
+    ODOM
+};
+
+/**
+ * @brief Get the lowest level compiled in for a module
+ */
+constexpr Level compiledLevel(Module module) {
+    switch (module) {
+        case Module::CHASSIS: return Level::LEMLIB_LOG_LEVEL_CHASSIS;
+        case Module::MOTION: return Level::LEMLIB_LOG_LEVEL_MOTION;
+        case Module::ODOM: return Level::LEMLIB_LOG_LEVEL_ODOM;
+    }
+    return Level::INFO;
+}
+
 
 /**
  * @brief Get the info sink.
- * @return std::shared_ptr<InfoSink>
+ * @return const std::shared_ptr<InfoSink>&
  */
-std::shared_ptr<InfoSink> infoSink();
+const std::shared_ptr<InfoSink>& infoSink();
 
 /**
  * @brief Get the telemetry sink.
- * @return std::shared_ptr<TelemetrySink>
+ * @return const std::shared_ptr<TelemetrySink>&
+ */
+const std::shared_ptr<TelemetrySink>& telemetrySink();
+
+/**
+ * @brief Log a message from LemLib to the info sink, if its level is compiled in for the module
+ *
+ * Messages below the compiled level of the module compile to nothing: the info sink isn't fetched and the message
+ * isn't formatted. The format is still checked against the arguments. Arguments are still evaluated, so keep them
+ * plain values, as the optimizer removes those.
+ *
+ * @tparam module the module logging the message
+ * @tparam level the level of the message
+ * @param format the format, with "{}" as placeholders
+ * @param args the values substituted into the placeholders
+ *
+ * @b Example
+ * @code {.cpp}
+ * // left out of builds with -DLEMLIB_LOG_LEVEL_MOTION=WARN
+ * lemlib::log<lemlib::Module::MOTION, lemlib::Level::DEBUG>("Turn Motor Power: {} ", motorPower);
+ * @endcode
  */
-std::shared_ptr<TelemetrySink> telemetrySink();
+template <Module module, Level level, typename... T> void log(LogFormat<T...> format, T&&... args) {
+    if constexpr (level >= compiledLevel(module)) infoSink()->log(level, format, std::forward<T>(args)...);
+}
 } // namespace lemlib
@@ -21,8 +21,8 @@ struct Message {
         /** The level of the message */
         Level level;
 
-        /** The time the message was logged, in milliseconds */
-        uint32_t time;
+        /** The time the message was logged, in microseconds */
+        uint64_t time;
 };
 
 /**
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pros/rotation.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/output.hpp"
+#include "lemlib/pid.hpp"
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+/**
+ * @brief class containing constants for a mechanism controller
+ */
+class MechanismSettings {
+    public:
+        /**
+         * @brief MechanismSettings constructor
+         *
+         * The feedforward gains give the voltage the mechanism needs to follow its motion profile, and the PID corrects
+         * what they miss. kV and kA can be measured by driving the motor at a few voltages and recording the velocity
+         * and acceleration, kG by finding the voltage that holds the arm still while it is horizontal. Set a constant to
+         * 0 and it will be ignored
+         *
+         * @param kP proportional gain, in millivolts per degree
+         * @param kI integral gain
+         * @param kD derivative gain
+         * @param kV velocity feedforward, in millivolts per degree per second
+         * @param kA acceleration feedforward, in millivolts per degree per second squared
+         * @param kG gravity feedforward, the voltage that holds the arm up while it is horizontal, in millivolts
+         * @param horizontal angle at which the arm is horizontal, in degrees
+         * @param maxVelocity maximum velocity of the motion profile, in degrees per second
+         * @param maxAcceleration maximum acceleration of the motion profile, in degrees per second squared
+         * @param tolerance distance from the target at which it is reached, in degrees
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::MechanismSettings armSettings(200, // proportional gain (kP)
+         *                                       0, // integral gain (kI), set to 0 to disable
+         *                                       0, // derivative gain (kD), set to 0 to disable
+         *                                       10, // velocity feedforward (kV)
+         *                                       0.5, // acceleration feedforward (kA)
+         *                                       600, // gravity feedforward (kG)
+         *                                       0, // the arm is horizontal at 0 degrees
+         *                                       900, // maximum velocity, in degrees per second
+         *                                       6000, // maximum acceleration, in degrees per second squared
+         *                                       2); // reached within 2 degrees
+         * @endcode
+         */
+        MechanismSettings(float kP, float kI, float kD, float kV, float kA, float kG, float horizontal,
+                          float maxVelocity, float maxAcceleration, float tolerance)
+            : kP(kP),
+              kI(kI),
+              kD(kD),
+              kV(kV),
+              kA(kA),
+              kG(kG),
+              horizontal(horizontal),
+              maxVelocity(maxVelocity),
+              maxAcceleration(maxAcceleration),
+              tolerance(tolerance) {}
+
+        float kP;
+        float kI;
+        float kD;
+        float kV;
+        float kA;
+        float kG;
+        float horizontal;
+        float maxVelocity;
+        float maxAcceleration;
+        float tolerance;
+};
+
+/**
+ * @brief A motor that moves an arm to angles measured by a rotation sensor
+ *
+ * Each move follows a trapezoidal motion profile: the target accelerates to the maximum velocity, cruises, and slows
+ * down in time to stop at the goal. The motor is driven with the feedforward voltage for the profile, a gravity
+ * feedforward of kG * cos(angle - horizontal), and a PID on how far the arm is behind the profile. Moving to a new
+ * angle during a move continues from where the profile is, so the arm doesn't jerk.
+ *
+ * Angles can be given names with addSetpoint, and whether the arm holds a setpoint once it reaches it, or lets the
+ * motor brake. The mechanism is a subsystem: it has to be added to a SubsystemScheduler to run.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Motor armMotor(1);
+ * pros::Rotation armRotation(2);
+ * lemlib::MotorOutput armOutput(&armMotor);
+ * lemlib::Mechanism arm("arm", armOutput.writer("arm", 0), &armRotation, armSettings);
+ *
+ * void initialize() {
+ *     armRotation.reset_position(); // the arm starts down, at 0 degrees
+ *     arm.addSetpoint("down", 0, false);
+ *     arm.addSetpoint("score", 120);
+ *     static lemlib::SubsystemScheduler subsystems;
+ *     subsystems.add(arm);
+ * }
+ *
+ * void autonomous() {
+ *     arm.moveTo("score");
+ *     arm.waitUntilReached(1000);
+ * }
+ * @endcode
+ */
+class Mechanism : public Subsystem {
+    public:
+        /**
+         * @brief Construct a new mechanism
+         *
+         * @param name name of the mechanism, also the name of its LoopProfile. The string has to outlive it
+         * @param writer the writer the motor is driven through
+         * @param sensor the rotation sensor on the arm. Its position is the angle of the arm, in centidegrees
+         * @param settings the constants of the controller
+         * @param period time between updates, in milliseconds. 10 by default
+         */
+        Mechanism(const char* name, MotorOutput::Writer writer, pros::Rotation* sensor, MechanismSettings settings,
+                  std::uint32_t period = 10);
+
+        /**
+         * @brief Update the motion profile and drive the motor. Called by the scheduler
+         */
+        void update() override;
+
+        /**
+         * @brief Give an angle a name
+         *
+         * @param name name of the setpoint. Adding a name again changes its angle
+         * @param angle the angle, in degrees
+         * @param hold whether the arm is held at the angle once it reaches it, or the motor brakes with its brake mode.
+         * True by default
+         */
+        void addSetpoint(const std::string& name, float angle, bool hold = true);
+
+        /**
+         * @brief Move to a setpoint
+         *
+         * @param name name of the setpoint
+         * @return false if there is no setpoint with that name, in which case the arm keeps its target
+         */
+        bool moveTo(const std::string& name);
+
+        /**
+         * @brief Move to an angle
+         *
+         * @param angle the angle, in degrees
+         * @param hold whether the arm is held at the angle once it reaches it. True by default
+         */
+        void moveTo(float angle, bool hold = true);
+
+        /**
+         * @brief Whether the arm has reached its target since the last move. It stays reached if the arm is then
+         * moved away, or falls away after braking
+         */
+        bool isReached();
+
+        /**
+         * @brief Wait until the arm reaches its target, or the timeout runs out
+         *
+         * @param timeout the longest time to wait, in milliseconds
+         * @return whether the arm reached its target
+         */
+        bool waitUntilReached(std::uint32_t timeout);
+
+        /**
+         * @brief Get the angle of the arm, in degrees
+         */
+        float getPosition();
+
+        /**
+         * @brief Get the angle the arm is moving to, in degrees
+         */
+        float getTarget();
+
+        /**
+         * @brief Get the distance from the arm to its target at the last update, in degrees
+         */
+        float getError();
+
+        /**
+         * @brief Get the voltage the motor was driven with at the last update, in millivolts
+         */
+        float getOutput();
+    private:
+        struct Setpoint {
+                std::string name;
+                float angle;
+                bool hold;
+        };
+
+        MotorOutput::Writer writer;
+        pros::Rotation* sensor;
+        MechanismSettings settings;
+        PID pid;
+        pros::Mutex mutex;
+        std::vector<Setpoint> setpoints;
+
+        // no target until the first move, the motor is left alone
+        bool moving = false;
+        float goal = 0;
+        bool hold = true;
+        // the motion profile: where the arm should be now, and how fast it should be moving
+        float reference = 0;
+        float velocity = 0;
+        bool profileDone = false;
+        bool reached = false;
+        float error = 0;
+        float output = 0;
+};
+} // namespace lemlib
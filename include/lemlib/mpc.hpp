@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "lemlib/pose.hpp"
+
+namespace lemlib {
+/**
+ * @brief Settings for the model predictive controller
+ *
+ * The controller plans wheel speeds a fixed number of steps ahead, so its worst case solve time is bounded by steps and
+ * iterations alone. The defaults solve in well under the 10ms motion loop.
+ */
+struct MPCSettings {
+        /** number of steps the controller plans ahead. 10 by default */
+        int steps = 10;
+        /** length of each step, in milliseconds. 80 by default */
+        int stepTime = 80;
+        /** optimizer iterations per update. Bounds the worst case solve time. 15 by default */
+        int iterations = 15;
+        /** maximum wheel acceleration, in inches per second squared. 300 by default */
+        float maxAcceleration = 300;
+        /** maximum sideways acceleration before the wheels slip, in inches per second squared. 150 by default */
+        float maxLateralAcceleration = 150;
+        /** cost of a radian of heading error, relative to the cost of an inch of distance from the target. 10 by
+         * default */
+        float headingWeight = 10;
+};
+
+/**
+ * @brief Model predictive controller for a differential drivetrain
+ *
+ * Every update, the controller optimizes the speed of each side over a short horizon, simulating the robot with a
+ * kinematic model. The cost pulls the robot towards the target and its heading towards a boomerang carrot point, which
+ * blends into the target heading as the robot closes in. Wheel speed and acceleration limits are hard constraints,
+ * sideways slip is penalized. The plan is solved with projected gradient descent and warm started from the last one.
+ *
+ * Chassis::moveToPose only uses the controller to approach the target, the last few inches are settled by its PIDs.
+ */
+class MPC {
+    public:
+        /**
+         * @brief Construct a new MPC
+         *
+         * @param settings horizon, limits and weights
+         * @param trackWidth distance between the left and right wheels, in inches
+         *
+         * @b Example
+         * @code {.cpp}
+         * // controller with the default settings, for a drivetrain with a 10 inch track width
+         * lemlib::MPC mpc({}, 10);
+         * @endcode
+         */
+        MPC(const MPCSettings& settings, float trackWidth);
+
+        /**
+         * @brief Forget the current plan and start from the given wheel speeds
+         *
+         * @param left speed of the left wheels, in inches per second
+         * @param right speed of the right wheels, in inches per second
+         */
+        void reset(float left, float right);
+
+        /**
+         * @brief Plan the next wheel speeds
+         *
+         * @param pose pose of the robot in standard form: radians, counterclockwise from the x axis
+         * @param target target pose in standard form. When moving backwards, the heading the back of the robot should
+         * face
+         * @param lead carrot point multiplier, as in Chassis::moveToPose
+         * @param maxSpeed maximum wheel speed, in inches per second
+         * @param minSpeed minimum speed towards the target, in inches per second. 0 allows the robot to stop
+         * @param forwards whether the robot should move forwards or backwards
+         * @return std::array<float, 2> left and right wheel speeds to command, in inches per second
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::MPC mpc({}, 10);
+         * // drive to (24, 24), facing along the y axis
+         * const auto [left, right] = mpc.update(chassis.getPose(true, true), lemlib::Pose(24, 24, M_PI_2), 0.6, 60, 0,
+         *                                       true);
+         * @endcode
+         */
+        std::array<float, 2> update(Pose pose, Pose target, float lead, float maxSpeed, float minSpeed, bool forwards);
+
+        /**
+         * @brief Get the number of model steps the last update simulated
+         *
+         * The solve time is proportional to this, and it is bounded by the steps and iterations in the settings, so it
+         * can be used to budget the solver on slower hardware.
+         */
+        int getEvaluations() const;
+    protected:
+        /**
+         * @brief Simulate the plan from a step, applying the limits, and return the total cost
+         *
+         * @param from first step to simulate. Earlier steps are taken from the last call with record set
+         * @param record whether to store the states, inputs and costs of this rollout for later partial rollouts
+         */
+        float rollout(int from, bool record);
+
+        /**
+         * @brief Get the cost of one step of the plan
+         */
+        float stepCost(float x, float y, float cosTheta, float sinTheta, float speed, float turnRate) const;
+
+        const MPCSettings settings;
+        const float trackWidth;
+
+        // planned wheel speeds, before the limits are applied. Two per step: left, then right
+        std::vector<float> plan;
+        std::vector<float> previous;
+        std::vector<float> gradient;
+        // recorded rollout: state at the start of each step, limited inputs and cost before each step
+        std::vector<std::array<float, 3>> states;
+        std::vector<float> inputs;
+        std::vector<float> costs;
+        // wheel speeds commanded by the last update, and when it ran
+        float left = 0;
+        float right = 0;
+        std::uint32_t lastUpdate = 0;
+        bool started = false;
+        // gradient step, in inches per second
+        float stepSize;
+        int evaluations = 0;
+
+        // the problem being solved, in the frame the robot is planned in
+        bool forwards = true;
+        Pose target = {0, 0, 0};
+        float targetCos = 1;
+        float targetSin = 0;
+        float lead = 0;
+        float maxSpeed = 0;
+        float minSpeed = 0;
+};
+} // namespace lemlib
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pros/abstract_motor.hpp"
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/**
+ * @brief A command for a motor
+ */
+struct MotorCommand {
+        enum class Mode { BRAKE, VOLTAGE, VELOCITY };
+
+        /** what the motor should do. Brake, with the brake mode of the motor, by default */
+        Mode mode = Mode::BRAKE;
+        /** voltage in millivolts, or velocity in rpm */
+        int value = 0;
+
+        bool operator==(const MotorCommand& other) const = default;
+};
+
+/**
+ * @brief Arbitrates between everything that writes to a motor, and only writes to it when needed
+ *
+ * Each subsystem that drives the motor gets a writer with a priority. The active writer with the highest priority
+ * owns the motor, and between writers of the same priority the latest request wins. A writer stays active until it is
+ * released, and the motor brakes when no writer is active. The motor is only written to when the command of the owner
+ * changes, or when the last write is older than the keepalive period, so a task can request the same command every
+ * tick without flooding the smart port.
+ *
+ * Every write to the motor has to go through its output, since the output doesn't notice writes that bypass it.
+ */
+class MotorOutput {
+    public:
+        /**
+         * @brief A subsystem writing to a motor output
+         */
+        class Writer {
+            public:
+                /**
+                 * @brief Request a power, like pros::Motor::move
+                 *
+                 * @param power power from -127 to 127
+                 */
+                void move(int power);
+                /**
+                 * @brief Request a voltage
+                 *
+                 * @param voltage voltage in millivolts, from -12000 to 12000
+                 */
+                void moveVoltage(int voltage);
+                /**
+                 * @brief Request a velocity, using the motor's built-in velocity controller
+                 *
+                 * @param velocity velocity in rpm
+                 */
+                void moveVelocity(int velocity);
+                /**
+                 * @brief Request the motor to brake, with its brake mode
+                 */
+                void brake();
+                /**
+                 * @brief Stop requesting anything, handing the motor to the next writer
+                 */
+                void release();
+                /**
+                 * @brief Whether this writer owns the motor
+                 */
+                bool owns() const;
+            private:
+                friend class MotorOutput;
+                Writer(MotorOutput* output, int id);
+
+                MotorOutput* output;
+                int id;
+        };
+
+        /**
+         * @brief Construct a new motor output
+         *
+         * @param motor the motor or motor group to write to
+         * @param keepalive longest time between writes of the same command, in milliseconds. 100 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * pros::Motor intake(11);
+         * lemlib::MotorOutput intakeOutput(&intake);
+         * // the driver runs the intake, and the unjammer overrides the driver while it runs
+         * lemlib::MotorOutput::Writer driverIntake = intakeOutput.writer("driver", 1);
+         * lemlib::MotorOutput::Writer unjamIntake = intakeOutput.writer("unjam", 2);
+         * driverIntake.move(127);
+         * unjamIntake.move(-60);
+         * pros::delay(100);
+         * unjamIntake.release(); // the driver owns the intake again
+         * @endcode
+         */
+        MotorOutput(pros::AbstractMotor* motor, int keepalive = 100);
+
+        /**
+         * @brief Add a writer
+         *
+         * @param name name of the subsystem, reported by getOwner
+         * @param priority priority of the writer. Higher priorities win
+         */
+        Writer writer(const std::string& name, int priority);
+
+        /**
+         * @brief Get the name of the writer that owns the motor, or an empty string if no writer is active
+         */
+        std::string getOwner();
+
+        /**
+         * @brief Get the number of writes sent to the motor
+         */
+        std::uint32_t getWrites();
+
+        /**
+         * @brief Get the number of requests made by writers. The difference to getWrites is the traffic saved
+         */
+        std::uint32_t getRequests();
+    private:
+        struct Request {
+                std::string name;
+                int priority;
+                bool active = false;
+                MotorCommand command;
+                // when the request was made, to break ties between writers of the same priority
+                std::uint32_t sequence = 0;
+        };
+
+        /**
+         * @brief Update the request of a writer, and write to the motor if needed
+         */
+        void request(int id, const MotorCommand& command, bool active);
+        /**
+         * @brief Get the active writer with the highest priority, -1 if there is none
+         */
+        int findOwner() const;
+
+        pros::AbstractMotor* motor;
+        const std::uint32_t keepalive;
+        pros::Mutex mutex;
+        std::vector<Request> requests;
+        std::uint32_t sequence = 0;
+        // last command written, and when
+        MotorCommand written;
+        bool hasWritten = false;
+        std::uint32_t lastWrite = 0;
+        std::uint32_t writes = 0;
+        std::uint32_t requestCount = 0;
+};
+} // namespace lemlib
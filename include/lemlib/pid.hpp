@@ -60,6 +60,26 @@ class PID {
          * @endcode
          */
         void reset();
+
+        /**
+         * @brief Get the error given to the last update
+         *
+         * @b Example
+         * @code {.cpp}
+         * printf("lateral error: %f\n", chassis.lateralPID.getError());
+         * @endcode
+         */
+        float getError() const;
+
+        /**
+         * @brief Get the output of the last update
+         *
+         * @b Example
+         * @code {.cpp}
+         * printf("lateral output: %f\n", chassis.lateralPID.getOutput());
+         * @endcode
+         */
+        float getOutput() const;
     protected:
         // gains
         const float kP;
@@ -72,5 +92,6 @@ class PID {
 
         float integral = 0;
         float prevError = 0;
+        float prevOutput = 0;
 };
 } // namespace lemlib
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "lemlib/pose.hpp"
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+/**
+ * @brief A trail of where the robot has been, sampled periodically and thinned out
+ *
+ * Every update samples the pose once. The sample is kept only if the robot moved at least the spacing since the last
+ * pose kept, so a robot standing still adds nothing and the trail has about the same density at any speed. A sample
+ * further from the last pose kept than the robot could have driven, like after Chassis::setPose, starts a new stretch
+ * of the trail instead of joining the last one. The history keeps the most recent poses up to its capacity.
+ *
+ * Readers like FieldView take the poses kept since they last looked, by sequence number, instead of reading the pose
+ * themselves. The history is a subsystem: it has to be added to a SubsystemScheduler to run.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::PoseHistory poseHistory("pose history", [] { return chassis.getPose(); }, 1);
+ *
+ * void initialize() {
+ *     static lemlib::SubsystemScheduler subsystems;
+ *     subsystems.add(poseHistory);
+ * }
+ * @endcode
+ */
+class PoseHistory : public Subsystem {
+    public:
+        /**
+         * @brief A pose kept, and whether it starts a new stretch of the trail
+         */
+        struct Entry {
+                Pose pose;
+                bool jump;
+        };
+
+        /**
+         * @brief Construct a new pose history
+         *
+         * @param name name of the history, also the name of its LoopProfile. The string has to outlive it
+         * @param sample function returning the pose, called once per update
+         * @param spacing how far the robot has to move for a pose to be kept, in inches
+         * @param capacity the most poses kept. 2000 by default
+         * @param period time between samples, in milliseconds. 20 by default
+         */
+        PoseHistory(const char* name, std::function<Pose()> sample, float spacing, std::size_t capacity = 2000,
+                    std::uint32_t period = 20);
+
+        /**
+         * @brief Sample the pose, and keep it if the robot moved far enough. Called by the scheduler
+         */
+        void update() override;
+
+        /**
+         * @brief Get the pose at the last sample, kept or not
+         */
+        Pose getLatest();
+
+        /**
+         * @brief Get the number of poses kept since the history was constructed, counting the ones dropped since
+         */
+        std::uint32_t getSequence();
+
+        /**
+         * @brief Get the poses kept after a sequence number
+         *
+         * @param sequence the sequence number the caller last got, 0 at first
+         * @param entries the poses are added to the end of it, oldest first. Poses dropped to make room are skipped
+         * @return the sequence number to pass next time
+         */
+        std::uint32_t getSince(std::uint32_t sequence, std::vector<Entry>& entries);
+
+        /**
+         * @brief Get the number of samples taken
+         */
+        std::uint32_t getSamples();
+    private:
+        std::function<Pose()> sample;
+        const float spacing;
+        const std::size_t capacity;
+        pros::Mutex mutex;
+        // the poses kept, a ring of capacity entries, the newest at index (sequence - 1) % capacity
+        std::vector<Entry> entries;
+        std::uint32_t sequence = 0;
+        std::uint32_t samples = 0;
+        Pose latest = {0, 0, 0};
+        std::uint32_t latestTime = 0;
+        bool started = false;
+};
+} // namespace lemlib
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace lemlib {
+/**
+ * @brief A histogram of durations, in fixed memory
+ *
+ * Bucket 0 counts durations under 1us, and bucket i counts durations from 2^(i-1) up to 2^i microseconds. The last
+ * bucket also counts everything longer.
+ */
+struct Histogram {
+        static constexpr int BUCKETS = 20;
+
+        std::uint32_t buckets[BUCKETS] = {};
+        /** number of durations */
+        std::uint32_t count = 0;
+        /** sum of the durations, in microseconds */
+        std::uint64_t total = 0;
+        /** longest duration, in microseconds */
+        std::uint32_t max = 0;
+
+        /**
+         * @brief Add a duration
+         *
+         * @param duration the duration, in microseconds
+         */
+        void add(std::uint32_t duration);
+
+        /**
+         * @brief Get the average duration, in microseconds. 0 if there are none
+         */
+        float mean() const;
+
+        /**
+         * @brief Get an upper bound of a percentile of the durations, in microseconds
+         *
+         * The top of the bucket the percentile falls in, or the longest duration if that is lower
+         *
+         * @param percentile the percentile, from 0 to 100
+         */
+        std::uint32_t percentile(float percentile) const;
+};
+
+/**
+ * @brief Timing of a periodic loop: how long each iteration takes, and how late the loop wakes up
+ *
+ * Mark the start of every iteration with start(), and sleep with delay() or delayUntil() at the end. Execution time
+ * is the time from start() to the sleep, including anything the loop waits on in between. Lateness is how long after
+ * the end of the sleep the next start() is. Both go into histograms in fixed memory, so profiling never allocates.
+ * Marking an iteration costs two reads of the clock.
+ *
+ * Profiles add themselves to a list when they are constructed, to be looked up by name or sent as telemetry.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void intakeTask() {
+ *     static lemlib::LoopProfile profile("intake");
+ *     while (true) {
+ *         profile.start();
+ *         // ...
+ *         profile.delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class LoopProfile {
+    public:
+        /**
+         * @brief Construct a new loop profile, and add it to the list
+         *
+         * @param name name of the loop. The string has to outlive the profile
+         */
+        LoopProfile(const char* name);
+
+        /**
+         * @brief Remove the profile from the list
+         */
+        ~LoopProfile();
+
+        LoopProfile(const LoopProfile&) = delete;
+        LoopProfile& operator=(const LoopProfile&) = delete;
+
+        /**
+         * @brief Mark the start of an iteration
+         */
+        void start();
+
+        /**
+         * @brief Mark the start of an iteration that was due at a time, for loops something else wakes up, like the
+         * subsystems of a SubsystemScheduler
+         *
+         * @param due when the iteration should have started, in microseconds
+         */
+        void start(std::uint64_t due);
+
+        /**
+         * @brief Mark the end of an iteration, for loops that don't sleep with delay() or delayUntil()
+         *
+         * Call it when the loop exits too, so the time until it runs again isn't counted as lateness
+         */
+        void end();
+
+        /**
+         * @brief End the iteration, and sleep
+         *
+         * @param milliseconds how long to sleep
+         */
+        void delay(std::uint32_t milliseconds);
+
+        /**
+         * @brief End the iteration, and sleep until a period after the last wake up. See lemlib::delayUntil
+         *
+         * @param previous the time of the last wake up, in microseconds
+         * @param period the period of the loop, in microseconds
+         */
+        void delayUntil(std::uint64_t& previous, std::uint64_t period);
+
+        /**
+         * @brief Clear the histograms
+         */
+        void reset();
+
+        /**
+         * @brief Get the name of the loop
+         */
+        const char* getName() const;
+
+        /**
+         * @brief Get the histogram of execution times
+         */
+        const Histogram& getExecution() const;
+
+        /**
+         * @brief Get the histogram of how late the loop woke up
+         */
+        const Histogram& getLateness() const;
+
+        /**
+         * @brief Find a profile by name
+         *
+         * @return the profile, nullptr if there is none
+         */
+        static LoopProfile* find(const char* name);
+
+        /**
+         * @brief Call a function with every profile
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::LoopProfile::forEach([](lemlib::LoopProfile& profile) {
+         *     printf("%s: %.0fus on average, up to %uus late\n", profile.getName(), profile.getExecution().mean(),
+         *            profile.getLateness().max);
+         * });
+         * @endcode
+         */
+        static void forEach(const std::function<void(LoopProfile& profile)>& function);
+    private:
+        const char* name;
+        Histogram execution;
+        Histogram lateness;
+        // start of the current iteration, and when the loop should wake up next
+        std::uint64_t startTime = 0;
+        std::uint64_t wakeTime = 0;
+        bool started = false;
+        bool sleeping = false;
+        LoopProfile* next = nullptr;
+};
+} // namespace lemlib
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "lemlib/telemetry.hpp"
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/**
+ * @brief A flight recorder, which writes telemetry to files on the SD card
+ *
+ * Records are copied into one of two blocks of memory. When it is full, the blocks swap and a low priority task writes
+ * the full one to the file in a single write, so the file only grows by whole blocks and the tasks recording never
+ * wait on the SD card. If the SD card falls so far behind that both blocks are full, records are dropped and counted,
+ * as are records that would fill the active block while the task is switching files. The recorder never uses more
+ * memory than the two blocks.
+ *
+ * Each call to start() rotates to a new file, like one per match or routine. Files hold telemetry frames back to back,
+ * so host/tools/telemetry decodes them like a capture of stdout.
+ */
+class FlightRecorder {
+    public:
+        /**
+         * @brief Construct a new flight recorder, and start its task
+         *
+         * @param directory where to put the files. "/usd" by default, the root of the SD card
+         * @param blockSize bytes written to the SD card at once. Use a multiple of 512, the sector size. 4096 by
+         * default
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::FlightRecorder recorder;
+         * // record every channel of a telemetry registry
+         * telemetry.subscribe("pose", [](const lemlib::TelemetryFrame& frame) { recorder.write(frame); });
+         * @endcode
+         */
+        FlightRecorder(const std::string& directory = "/usd", std::uint32_t blockSize = 4096);
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        /**
+         * @brief Start recording to a new file, directory/NAME_N.bin with the first N that isn't taken
+         *
+         * Records from before the call finish the current file, and records from after it go to the new one. Only
+         * the recorder task touches the SD card, so this returns immediately.
+         *
+         * @param name name of the file, without the number
+         *
+         * @b Example
+         * @code {.cpp}
+         * void autonomous() {
+         *     recorder.start("auton");
+         *     // ...
+         * }
+         * @endcode
+         */
+        void start(const std::string& name);
+
+        /**
+         * @brief Stop recording, and finish the current file
+         */
+        void stop();
+
+        /**
+         * @brief Record bytes
+         *
+         * @param data the bytes, at most the block size
+         * @return true if the bytes were recorded, false if the recorder is stopped, the bytes are too large or both
+         * blocks are full
+         */
+        bool write(std::string_view data);
+
+        /**
+         * @brief Record a telemetry frame, stamped with its own time
+         *
+         * @return true if the frame was recorded
+         */
+        bool write(const TelemetryFrame& frame);
+
+        /**
+         * @brief Get the number of records dropped because both blocks were full, the files were being switched or the
+         * record was too large
+         */
+        std::uint32_t getDropped() const;
+
+        /**
+         * @brief Get the number of bytes written to files since the recorder was constructed
+         */
+        std::uint32_t getWritten() const;
+
+        /**
+         * @brief Get the number of bytes lost to files that couldn't be opened or written
+         */
+        std::uint32_t getFailed() const;
+    private:
+        /**
+         * @brief Hand the active block to the task, and switch to the other one. The mutex has to be taken
+         */
+        void seal();
+        /**
+         * @brief Mark where the current file ends, for the task to switch files there. The mutex has to be taken
+         */
+        void markSwitch();
+        /**
+         * @brief Write a block to the current file
+         */
+        void writeBlock(const char* data, std::uint32_t size);
+        /**
+         * @brief Finish the current file, and open the next one if there is a name for it
+         */
+        void rotate(const std::string& name);
+        /**
+         * @brief The function run inside of the recorder's task
+         */
+        void taskLoop();
+
+        const std::string directory;
+        const std::uint32_t blockSize;
+        std::unique_ptr<char[]> blocks;
+
+        // taken by recording tasks to copy into the active block, and by the task only to take a full one
+        pros::Mutex mutex;
+        std::uint32_t active = 0; // block being filled
+        std::uint32_t fill = 0; // end of the data in the active block
+        std::uint32_t skip = 0; // start of the data in the active block, after what already went to the last file
+        std::uint32_t sealedBegin = 0; // data in the other block waiting for the task, empty if the block is free
+        std::uint32_t sealedEnd = 0;
+        bool recording = false;
+        bool switching = false; // start() or stop() was called, and the task hasn't switched files yet
+        std::uint32_t boundary = 0; // end of the data in the active block that belongs to the last file
+        std::uint32_t requests = 0; // number of calls to start() and stop()
+        std::string nextName; // file to switch to, empty to stop
+
+        // only used by the task
+        std::FILE* file = nullptr;
+
+        std::atomic<std::uint32_t> dropped = 0;
+        std::atomic<std::uint32_t> written = 0;
+        std::atomic<std::uint32_t> failed = 0;
+
+        pros::Task task;
+};
+} // namespace lemlib
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/**
+ * @brief The part of a State that doesn't depend on its type: the change count, and the tasks waiting for a change
+ */
+class StateBase {
+    public:
+        StateBase() = default;
+        StateBase(const StateBase&) = delete;
+        StateBase& operator=(const StateBase&) = delete;
+
+        /**
+         * @brief Get how many times the value changed. Setting it to the value it already has isn't a change
+         */
+        std::uint32_t getSequence() const;
+
+        /**
+         * @brief Wait until the value changes after a sequence number was read
+         *
+         * @param sequence the sequence number the caller last saw
+         * @param timeout the longest time to wait, in milliseconds. Forever by default
+         * @return the sequence number now, which is still the one passed if the timeout ran out
+         */
+        std::uint32_t waitForChange(std::uint32_t sequence, std::uint32_t timeout = TIMEOUT_MAX);
+    protected:
+        /**
+         * @brief Count a change and wake every waiting task
+         */
+        void changed();
+
+        /**
+         * @brief Block until a condition on the value holds, checking it every time the value changes
+         *
+         * @return whether the condition held before the timeout ran out
+         */
+        bool waitFor(const std::function<bool()>& done, std::uint32_t timeout);
+    private:
+        std::atomic<std::uint32_t> sequence {0};
+        pros::Mutex mutex;
+        std::vector<pros::task_t> waiting;
+};
+
+/**
+ * @brief A value shared between tasks
+ *
+ * Reads and writes are atomic, so tasks can share a State without a mutex. Every change is counted, and a task can
+ * block until the value changes or reaches a value instead of polling it: it is woken by the write itself.
+ *
+ * A State reads and assigns like the plain variable it replaces.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::State<bool> ringLoaded = false;
+ *
+ * // in a subsystem
+ * ringLoaded = intakeStalled;
+ *
+ * // in a routine
+ * if (!ringLoaded) ringLoaded.waitUntil(true, 2000);
+ * @endcode
+ */
+template <typename T> class State : public StateBase {
+        static_assert(std::is_trivially_copyable_v<T>, "State values have to be atomic");
+    public:
+        /**
+         * @brief Construct a new state
+         *
+         * @param value the value it starts with
+         */
+        State(T value = T())
+            : value(value) {}
+
+        /**
+         * @brief Get the value
+         */
+        T get() const { return value.load(); }
+
+        operator T() const { return get(); }
+
+        /**
+         * @brief Set the value, waking the tasks waiting for it if it changed
+         */
+        void set(T value) {
+            if (this->value.exchange(value) != value) changed();
+        }
+
+        State& operator=(T value) {
+            set(value);
+            return *this;
+        }
+
+        /**
+         * @brief Wait until the state has a value. Returns straight away if it already has it
+         *
+         * @param target the value to wait for
+         * @param timeout the longest time to wait, in milliseconds. Forever by default
+         * @return whether the state had the value before the timeout ran out
+         */
+        bool waitUntil(T target, std::uint32_t timeout = TIMEOUT_MAX) {
+            return waitFor([&] { return get() == target; }, timeout);
+        }
+    private:
+        std::atomic<T> value;
+};
+} // namespace lemlib
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "lemlib/profile.hpp"
+
+namespace lemlib {
+/**
+ * @brief A mechanism updated periodically by a SubsystemScheduler
+ *
+ * update() runs on the scheduler's task, one subsystem after another, so it must never sleep or wait: every subsystem
+ * after it would be late. Something that takes time, like holding a motor for 100ms, is a state that update() checks
+ * the time against.
+ *
+ * @b Example
+ * @code {.cpp}
+ * class Intake : public lemlib::Subsystem {
+ *     public:
+ *         Intake()
+ *             : Subsystem("intake", 10) {}
+ *
+ *         void update() override {
+ *             // read the sensors and set the motors, without sleeping
+ *         }
+ * };
+ * @endcode
+ */
+class Subsystem {
+    public:
+        /**
+         * @brief Construct a new subsystem
+         *
+         * @param name name of the subsystem, also the name of its LoopProfile. The string has to outlive it
+         * @param period time between updates, in milliseconds. Rounded to a multiple of the scheduler's period
+         * @param enabled whether the subsystem starts enabled. True by default
+         */
+        Subsystem(const char* name, std::uint32_t period, bool enabled = true);
+
+        virtual ~Subsystem() = default;
+
+        Subsystem(const Subsystem&) = delete;
+        Subsystem& operator=(const Subsystem&) = delete;
+
+        /**
+         * @brief Update the subsystem. Called by the scheduler every period while the subsystem is enabled
+         */
+        virtual void update() = 0;
+
+        /**
+         * @brief Enable or disable the subsystem. A disabled subsystem isn't updated
+         */
+        void setEnabled(bool enabled);
+
+        /**
+         * @brief Whether the subsystem is enabled
+         */
+        bool isEnabled() const;
+
+        /**
+         * @brief Get the name of the subsystem
+         */
+        const char* getName() const;
+
+        /**
+         * @brief Get the time between updates, in milliseconds
+         */
+        std::uint32_t getPeriod() const;
+
+        /**
+         * @brief Get the timing of the updates: how long they take, and how late after their tick they start
+         */
+        const LoopProfile& getProfile() const;
+    private:
+        friend class SubsystemScheduler;
+
+        const std::uint32_t period;
+        std::atomic<bool> enabled;
+        LoopProfile profile;
+};
+
+/**
+ * @brief Runs subsystems from one task at fixed rates
+ *
+ * The task wakes up every period without drifting, and updates the subsystems that are due in the order they were
+ * added. A subsystem with a period of n times the scheduler's runs on every nth tick, so the rates and the order are
+ * the same every run. Each subsystem's LoopProfile records how long its updates take, and how late after the start of
+ * the tick they start, which includes the updates before it.
+ *
+ * @b Example
+ * @code {.cpp}
+ * Intake intake;
+ * Arm arm; // a subsystem with a period of 20ms
+ *
+ * void initialize() {
+ *     static lemlib::SubsystemScheduler subsystems;
+ *     subsystems.add(intake);
+ *     subsystems.add(arm);
+ * }
+ * @endcode
+ */
+class SubsystemScheduler {
+    public:
+        /**
+         * @brief Construct a new subsystem scheduler, and start its task
+         *
+         * @param period time between ticks, in milliseconds. 10 by default
+         * @param priority priority of the task. TASK_PRIORITY_DEFAULT by default
+         */
+        SubsystemScheduler(std::uint32_t period = 10, std::uint32_t priority = TASK_PRIORITY_DEFAULT);
+
+        SubsystemScheduler(const SubsystemScheduler&) = delete;
+        SubsystemScheduler& operator=(const SubsystemScheduler&) = delete;
+
+        /**
+         * @brief Add a subsystem. It is first updated on the next tick
+         *
+         * @param subsystem the subsystem. It has to outlive the scheduler
+         */
+        void add(Subsystem& subsystem);
+
+        /**
+         * @brief Get the number of ticks whose updates took longer than the period, so the next tick started late
+         */
+        std::uint32_t getOverruns() const;
+    private:
+        /**
+         * @brief The function run inside of the scheduler's task
+         */
+        void taskLoop();
+
+        const std::uint32_t period;
+        pros::Mutex mutex;
+        std::vector<Subsystem*> subsystems;
+        std::uint32_t ticks = 0;
+        std::atomic<std::uint32_t> overruns = 0;
+        pros::Task task;
+};
+} // namespace lemlib
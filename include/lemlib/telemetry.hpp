@@ -0,0 +1,284 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/** the two bytes every telemetry frame starts with */
+constexpr std::uint8_t TELEMETRY_SYNC[2] = {0xA5, 0x5A};
+/** largest payload of a telemetry frame, in bytes. Frames have to fit in a slot of the buffered stdout */
+constexpr std::size_t TELEMETRY_MAX_PAYLOAD = 240;
+/** bytes a frame adds to its payload: sync, channel, length, timestamp and CRC */
+constexpr std::size_t TELEMETRY_OVERHEAD = 10;
+
+/** channel that describes the other channels, see TelemetryRegistry */
+constexpr std::uint8_t TELEMETRY_SCHEMA_CHANNEL = 0;
+
+/**
+ * @brief A telemetry sample
+ */
+struct TelemetryFrame {
+        /** id of the channel */
+        std::uint8_t channel;
+        /** when the sample was taken, in milliseconds */
+        std::uint32_t time;
+        /** the packed fields */
+        const std::uint8_t* payload;
+        /** size of the payload in bytes */
+        std::size_t size;
+};
+
+/**
+ * @brief Calculate a CRC-16/CCITT-FALSE checksum
+ *
+ * @param data the bytes to check
+ * @param size number of bytes
+ * @param crc checksum of the bytes before these, to check data in pieces. 0xFFFF to start
+ */
+std::uint16_t crc16(const std::uint8_t* data, std::size_t size, std::uint16_t crc = 0xFFFF);
+
+/**
+ * @brief Encode a telemetry frame
+ *
+ * A frame is, in order: the two sync bytes, the channel, the payload size, the timestamp in milliseconds as a 32 bit
+ * little endian integer, the payload, and the CRC-16 of everything after the sync bytes, little endian. Telemetry
+ * shares stdout with text, so a decoder looks for the sync bytes and only trusts frames with a valid CRC.
+ *
+ * @param frame where to write the frame, at least TELEMETRY_OVERHEAD + TELEMETRY_MAX_PAYLOAD bytes
+ * @param channel id of the channel, which tells the decoder how to read the payload
+ * @param time timestamp in milliseconds
+ * @param payload the payload
+ * @param size size of the payload in bytes, at most TELEMETRY_MAX_PAYLOAD
+ * @return size of the frame in bytes, 0 if the payload is too large
+ */
+std::size_t encodeTelemetry(std::uint8_t* frame, std::uint8_t channel, std::uint32_t time, const void* payload,
+                            std::size_t size);
+
+/**
+ * @brief Send a telemetry frame over the buffered stdout, stamped with the current time
+ *
+ * @param channel id of the channel
+ * @param payload the payload
+ * @param size size of the payload in bytes, at most TELEMETRY_MAX_PAYLOAD
+ * @return true if the frame was queued, false if it was too large or the buffer was full
+ */
+bool sendTelemetryFrame(std::uint8_t channel, const void* payload, std::size_t size);
+
+/**
+ * @brief Send a telemetry frame over the buffered stdout, with its own timestamp
+ *
+ * Subscribe this to the channels of a TelemetryRegistry to stream them to the computer.
+ *
+ * @return true if the frame was queued, false if it was too large or the buffer was full
+ */
+bool sendTelemetryFrame(const TelemetryFrame& frame);
+
+/**
+ * @brief Send numbers as a telemetry frame
+ *
+ * The numbers are packed back to back in the order they are given, in the byte order of the brain, which is little
+ * endian. Send smaller types, like std::int16_t in fixed point, to use less of the link.
+ *
+ * @param channel id of the channel
+ * @param fields the numbers to send
+ * @return true if the frame was queued, false if the buffer was full
+ *
+ * @b Example
+ * @code {.cpp}
+ * // send the pose on channel 1, 100 times a second
+ * while (true) {
+ *     const lemlib::Pose pose = chassis.getPose();
+ *     lemlib::sendTelemetry(1, pose.x, pose.y, pose.theta);
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+template <typename... T> bool sendTelemetry(std::uint8_t channel, T... fields) {
+    static_assert(sizeof...(T) > 0, "a telemetry frame needs at least one field");
+    static_assert((std::is_arithmetic_v<T> && ...), "telemetry fields have to be numbers");
+    static_assert((0 + ... + sizeof(T)) <= TELEMETRY_MAX_PAYLOAD, "too many telemetry fields for one frame");
+    std::uint8_t payload[(0 + ... + sizeof(T))];
+    std::size_t offset = 0;
+    ((std::memcpy(payload + offset, &fields, sizeof(T)), offset += sizeof(T)), ...);
+    return sendTelemetryFrame(channel, payload, sizeof(payload));
+}
+
+/**
+ * @brief Get the letter a decoder uses for a field type
+ *
+ * b/B for 8 bit, h/H for 16 bit and i/I for 32 bit signed/unsigned integers, and f for floats
+ */
+template <typename T> constexpr char telemetryType() {
+    if constexpr (std::is_same_v<T, float>) return 'f';
+    else {
+        static_assert(std::is_integral_v<T> && sizeof(T) <= 4,
+                      "telemetry fields have to be floats or integers of at most 32 bits");
+        constexpr char types[2][3] = {{'B', 'H', 'I'}, {'b', 'h', 'i'}};
+        return types[std::is_signed_v<T>][sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : 2];
+    }
+}
+
+/**
+ * @brief A registry of typed telemetry channels, sampled from one task
+ *
+ * Each channel has an id, a name, named fields and a sampling period, and a sampler that returns the fields as a
+ * std::tuple of numbers. Consumers, like sendTelemetryFrame for the computer, a file or the screen, subscribe to the
+ * channels they want, each with its own decimation. A channel that is disabled or has no subscribers is never
+ * sampled.
+ *
+ * Every consumer gets a schema frame on TELEMETRY_SCHEMA_CHANNEL for each channel it subscribes to, when it subscribes
+ * and then every 2 seconds, so a decoder that starts late learns the layout of the channels. The periodic schema
+ * frames go out one channel per tick, and channels of the same period are sampled on different ticks, so the frames of
+ * a tick stay few and a buffered output like sendTelemetryFrame's doesn't overflow. Its payload is the id of
+ * the channel, the number of fields, one type letter per field (see telemetryType) and then "name:field,field,...".
+ */
+class TelemetryRegistry {
+    public:
+        /**
+         * @brief A consumer of telemetry frames. Called from the registry's task
+         */
+        using Consumer = std::function<void(const TelemetryFrame& frame)>;
+
+        /**
+         * @brief Construct a new telemetry registry, and start its task
+         *
+         * @param period time between checks for channels to sample, in milliseconds. Channel periods are rounded to a
+         * multiple of it. 10 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::TelemetryRegistry telemetry;
+         * // sample the pose every 10ms
+         * telemetry.add(1, "pose", {"x", "y", "theta"}, 10, [] {
+         *     const lemlib::Pose pose = chassis.getPose();
+         *     return std::tuple(pose.x, pose.y, pose.theta);
+         * });
+         * // stream it to the computer, at half the rate
+         * telemetry.subscribe("pose", [](const lemlib::TelemetryFrame& frame) { lemlib::sendTelemetryFrame(frame); },
+         *                     2);
+         * @endcode
+         */
+        TelemetryRegistry(std::uint32_t period = 10);
+
+        TelemetryRegistry(const TelemetryRegistry&) = delete;
+        TelemetryRegistry& operator=(const TelemetryRegistry&) = delete;
+
+        /**
+         * @brief Add a channel
+         *
+         * @param id id of the channel, from 1 to 255
+         * @param name name of the channel
+         * @param fields names of the fields, in the order the sampler returns them
+         * @param period time between samples, in milliseconds
+         * @param sampler function returning the fields as a std::tuple of floats and integers
+         */
+        template <typename Sampler> void add(std::uint8_t id, const std::string& name,
+                                             const std::vector<std::string>& fields, std::uint32_t period,
+                                             Sampler sampler) {
+            using Sample = decltype(sampler());
+            const std::string types = std::apply(
+                [](auto... values) { return std::string {telemetryType<decltype(values)>()...}; }, Sample());
+            static_assert(std::tuple_size_v<Sample> > 0, "a telemetry channel needs at least one field");
+            static_assert(payloadSize(static_cast<Sample*>(nullptr)) <= TELEMETRY_MAX_PAYLOAD,
+                          "too many telemetry fields for one frame");
+            addChannel(id, name, fields, types, period, [sampler](std::uint8_t* payload) {
+                return std::apply(
+                    [payload](auto... values) {
+                        std::size_t offset = 0;
+                        ((std::memcpy(payload + offset, &values, sizeof(values)), offset += sizeof(values)), ...);
+                        return offset;
+                    },
+                    sampler());
+            });
+        }
+
+        /**
+         * @brief Subscribe to a channel
+         *
+         * @param name name of the channel
+         * @param consumer function called with every frame the consumer gets
+         * @param decimation the consumer gets every nth sample of the channel. 1 by default
+         * @return true if the channel exists
+         */
+        bool subscribe(const std::string& name, Consumer consumer, std::uint32_t decimation = 1);
+
+        /**
+         * @brief Enable or disable a channel. Disabled channels aren't sampled
+         *
+         * @return true if the channel exists
+         */
+        bool setEnabled(const std::string& name, bool enabled);
+
+        /**
+         * @brief Set the time between samples of a channel, in milliseconds
+         *
+         * @return true if the channel exists
+         */
+        bool setPeriod(const std::string& name, std::uint32_t period);
+
+        /**
+         * @brief Get the number of times a channel has been sampled
+         */
+        std::uint32_t getSamples(const std::string& name);
+    private:
+        struct Subscription {
+                Consumer consumer;
+                std::uint32_t decimation;
+        };
+
+        struct Channel {
+                std::uint8_t id;
+                std::string name;
+                std::string types;
+                std::vector<std::string> fields;
+                std::uint32_t period;
+                bool enabled = true;
+                // packs a sample into the payload and returns its size
+                std::function<std::size_t(std::uint8_t* payload)> sample;
+                std::vector<Subscription> subscriptions;
+                std::uint32_t samples = 0;
+        };
+
+        /**
+         * @brief Get the size of a sample, in bytes
+         */
+        template <typename... T> static constexpr std::size_t payloadSize(std::tuple<T...>*) {
+            return (0 + ... + sizeof(T));
+        }
+
+        /**
+         * @brief Add a type-erased channel
+         */
+        void addChannel(std::uint8_t id, const std::string& name, const std::vector<std::string>& fields,
+                        const std::string& types, std::uint32_t period,
+                        std::function<std::size_t(std::uint8_t* payload)> sample);
+        /**
+         * @brief Find a channel by name, nullptr if there is none. The mutex has to be taken
+         */
+        Channel* find(const std::string& name);
+        /**
+         * @brief Send the schema frame of a channel to a consumer
+         */
+        void describe(const Channel& channel, const Consumer& consumer, std::uint32_t time);
+        /**
+         * @brief The function run inside of the registry's task
+         */
+        void taskLoop();
+
+        const std::uint32_t period;
+        pros::Mutex mutex;
+        std::vector<Channel> channels;
+        std::uint32_t ticks = 0;
+        std::uint32_t lastSchema = 0;
+        // next channel to send the schema of, past the end when they have all been sent
+        std::size_t nextSchema = 0;
+        pros::Task task;
+};
+} // namespace lemlib
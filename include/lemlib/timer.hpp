@@ -193,8 +193,9 @@ class Timer {
         void waitUntilDone();
     private:
         uint32_t period;
-        uint32_t lastTime;
-        uint32_t timeWaited = 0;
+        // in microseconds, so time isn't lost to rounding between calls
+        uint64_t lastTime;
+        uint64_t timeWaited = 0;
         bool paused = false;
 };
 } // namespace lemlib
\ No newline at end of file
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "pros/adi.hpp"
+#include "pros/distance.hpp"
+#include "pros/optical.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+/**
+ * @brief class containing constants for a trigger
+ */
+class TriggerSettings {
+    public:
+        /**
+         * @brief TriggerSettings constructor
+         *
+         * The reading becomes active once it reaches the on threshold, and stays active until it goes back past the off
+         * threshold, so a reading wavering around one threshold doesn't flicker. With on below off the trigger watches
+         * for the reading falling, like a distance sensor seeing something come close. With on above off it watches for
+         * the reading rising, like the proximity of an optical sensor or a limit switch being pressed.
+         *
+         * @param on reading at which the trigger becomes active
+         * @param off reading at which it stops being active
+         * @param debounce how long the reading has to stay active before it counts, in milliseconds
+         * @param delay time from the reading counting to the trigger firing, in milliseconds. 0 to fire straight away
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::TriggerSettings goalSettings(15, // active at 15mm or closer
+         *                                      40, // until further than 40mm
+         *                                      20, // for 20ms
+         *                                      0); // fire straight away
+         * @endcode
+         */
+        TriggerSettings(float on, float off, std::uint32_t debounce, std::uint32_t delay)
+            : on(on),
+              off(off),
+              debounce(debounce),
+              delay(delay) {}
+
+        float on;
+        float off;
+        std::uint32_t debounce;
+        std::uint32_t delay;
+};
+
+/**
+ * @brief Fires once when a sensor sees something, while armed
+ *
+ * The trigger reads its sensor every update. While armed, once the reading has been active for the debounce time and
+ * the delay after it, the trigger fires: it runs its callbacks on the scheduler's task, and only once they are done
+ * counts as fired and wakes every task waiting for it. It then stays fired until it is armed again or disarmed. A reading that stops being active before the trigger
+ * fires starts the debounce over.
+ *
+ * Callbacks run inside update(), so like update() they must never sleep or wait. The trigger is a subsystem: it has to
+ * be added to a SubsystemScheduler to run.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::Distance goalSensor(1);
+ * pros::adi::DigitalOut clampPiston('A');
+ * lemlib::Trigger goalTrigger("goal", &goalSensor, goalSettings);
+ *
+ * void initialize() {
+ *     goalTrigger.onFire([] { clampPiston.set_value(true); });
+ *     static lemlib::SubsystemScheduler subsystems;
+ *     subsystems.add(goalTrigger);
+ * }
+ *
+ * void autonomous() {
+ *     goalTrigger.arm();
+ *     chassis.moveToPoint(0, -24, 2000, {.forwards = false});
+ *     goalTrigger.waitUntilFired(2000);
+ *     chassis.cancelMotion(); // stop as soon as the goal is clamped
+ * }
+ * @endcode
+ */
+class Trigger : public Subsystem {
+    public:
+        /**
+         * @brief Construct a new trigger on a distance sensor, reading in millimeters
+         *
+         * @param name name of the trigger, also the name of its LoopProfile. The string has to outlive it
+         * @param sensor the distance sensor
+         * @param settings the thresholds and times of the trigger
+         * @param period time between updates, in milliseconds. 10 by default, as often as smart sensors update
+         */
+        Trigger(const char* name, pros::Distance* sensor, TriggerSettings settings, std::uint32_t period = 10);
+        /**
+         * @brief Construct a new trigger on the proximity of an optical sensor, from 0 when nothing is there to 255
+         *
+         * @param name name of the trigger, also the name of its LoopProfile. The string has to outlive it
+         * @param sensor the optical sensor
+         * @param settings the thresholds and times of the trigger
+         * @param period time between updates, in milliseconds. 10 by default
+         */
+        Trigger(const char* name, pros::Optical* sensor, TriggerSettings settings, std::uint32_t period = 10);
+        /**
+         * @brief Construct a new trigger on an analog ADI sensor, like a line tracker, reading from 0 to 4095
+         *
+         * @param name name of the trigger, also the name of its LoopProfile. The string has to outlive it
+         * @param sensor the sensor
+         * @param settings the thresholds and times of the trigger
+         * @param period time between updates, in milliseconds. 10 by default, as often as ADI sensors update
+         */
+        Trigger(const char* name, pros::adi::AnalogIn* sensor, TriggerSettings settings, std::uint32_t period = 10);
+        /**
+         * @brief Construct a new trigger on a digital ADI sensor, like a limit switch, reading 1 when pressed
+         *
+         * @param name name of the trigger, also the name of its LoopProfile. The string has to outlive it
+         * @param sensor the sensor
+         * @param settings the thresholds and times of the trigger
+         * @param period time between updates, in milliseconds. 10 by default
+         */
+        Trigger(const char* name, pros::adi::DigitalIn* sensor, TriggerSettings settings, std::uint32_t period = 10);
+
+        /**
+         * @brief Read the sensor, and fire if armed and the reading has been active long enough. Called by the
+         * scheduler
+         */
+        void update() override;
+
+        /**
+         * @brief Start watching for the trigger to fire. Arming a fired trigger makes it ready to fire again
+         */
+        void arm();
+
+        /**
+         * @brief Stop watching, and forget having fired
+         */
+        void disarm();
+
+        /**
+         * @brief Whether the trigger is armed, fired or not
+         */
+        bool isArmed();
+
+        /**
+         * @brief Whether the trigger fired since it was last armed
+         */
+        bool isFired();
+
+        /**
+         * @brief Whether the reading is active at the last update, armed or not
+         */
+        bool isActive();
+
+        /**
+         * @brief Get the reading of the sensor at the last update
+         */
+        float getReading();
+
+        /**
+         * @brief Run a function every time the trigger fires
+         *
+         * @param callback the function. Runs on the scheduler's task, so it must not sleep or wait
+         */
+        void onFire(std::function<void()> callback);
+
+        /**
+         * @brief Wait until the trigger fires, or the timeout runs out. Returns straight away if it already fired
+         *
+         * The waiting task is woken by the update that fires the trigger, after the callbacks ran, so it carries on
+         * straight away with them done.
+         *
+         * @param timeout the longest time to wait, in milliseconds. Forever by default
+         * @return whether the trigger fired
+         */
+        bool waitUntilFired(std::uint32_t timeout = TIMEOUT_MAX);
+    private:
+        Trigger(const char* name, std::function<float()> read, TriggerSettings settings, std::uint32_t period);
+
+        std::function<float()> read;
+        TriggerSettings settings;
+        pros::Mutex mutex;
+        std::vector<std::function<void()>> callbacks;
+        // tasks waiting for the trigger to fire
+        std::vector<pros::task_t> waiting;
+
+        float reading = 0;
+        bool active = false;
+        std::uint32_t activeSince = 0;
+        bool armed = false;
+        bool fired = false;
+};
+} // namespace lemlib
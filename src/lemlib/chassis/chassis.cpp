@@ -2,6 +2,8 @@
 #include "pros/imu.hpp"
 #include "pros/motors.h"
 #include "pros/rtos.h"
+#include "lemlib/clock.hpp"
+#include "lemlib/controllerScreen.hpp"
 #include "lemlib/logger/logger.hpp"
 #include "lemlib/util.hpp"
 #include "lemlib/chassis/chassis.hpp"
@@ -28,18 +30,22 @@ lemlib::Drivetrain::Drivetrain(pros::MotorGroup* leftMotors, pros::MotorGroup* r
 
 lemlib::Chassis::Chassis(Drivetrain drivetrain, ControllerSettings linearSettings, ControllerSettings angularSettings,
                          OdomSensors sensors, DriveCurve* throttleCurve, DriveCurve* steerCurve)
-    : drivetrain(drivetrain),
+    : lateralPID(linearSettings.kP, linearSettings.kI, linearSettings.kD, linearSettings.windupRange, true),
+      angularPID(angularSettings.kP, angularSettings.kI, angularSettings.kD, angularSettings.windupRange, true),
       lateralSettings(linearSettings),
       angularSettings(angularSettings),
+      drivetrain(drivetrain),
       sensors(sensors),
       throttleCurve(throttleCurve),
       steerCurve(steerCurve),
-      lateralPID(linearSettings.kP, linearSettings.kI, linearSettings.kD, linearSettings.windupRange, true),
-      angularPID(angularSettings.kP, angularSettings.kI, angularSettings.kD, angularSettings.windupRange, true),
       lateralLargeExit(lateralSettings.largeError, lateralSettings.largeErrorTimeout),
       lateralSmallExit(lateralSettings.smallError, lateralSettings.smallErrorTimeout),
       angularLargeExit(angularSettings.largeError, angularSettings.largeErrorTimeout),
-      angularSmallExit(angularSettings.smallError, angularSettings.smallErrorTimeout) {}
+      angularSmallExit(angularSettings.smallError, angularSettings.smallErrorTimeout),
+      leftOutput(drivetrain.leftMotors),
+      rightOutput(drivetrain.rightMotors),
+      leftDrive(leftOutput.writer("chassis", 0)),
+      rightDrive(rightOutput.writer("chassis", 0)) {}
 
 /**
  * @brief calibrate the IMU given a sensors struct
@@ -48,31 +54,30 @@ lemlib::Chassis::Chassis(Drivetrain drivetrain, ControllerSettings linearSetting
  */
 void calibrateIMU(lemlib::OdomSensors& sensors) {
     int attempt = 1;
-    bool calibrated = false;
     // calibrate inertial, and if calibration fails, then repeat 5 times or until successful
     while (attempt <= 5) {
         sensors.imu->reset();
         // wait until IMU is calibrated
-        do pros::delay(10);
+        do lemlib::delay(10);
         while (sensors.imu->get_status() != pros::ImuStatus::error && sensors.imu->is_calibrating());
         // exit if imu has been calibrated
         if (!isnanf(sensors.imu->get_heading()) && !isinf(sensors.imu->get_heading())) {
-            calibrated = true;
             break;
         }
         // indicate error
-        pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
-        lemlib::infoSink()->warn("IMU failed to calibrate! Attempt #{}", attempt);
+        lemlib::rumbleController("---");
+        lemlib::log<lemlib::Module::CHASSIS, lemlib::Level::WARN>("IMU failed to calibrate! Attempt #{}", attempt);
         attempt++;
     }
     // check if calibration attempts were successful
     if (attempt > 5) {
         sensors.imu = nullptr;
-        lemlib::infoSink()->error("IMU calibration failed, defaulting to tracking wheels / motor encoders");
+        lemlib::log<lemlib::Module::CHASSIS, lemlib::Level::ERROR>(
+            "IMU calibration failed, defaulting to tracking wheels / motor encoders");
     }
 }
 
-void lemlib::Chassis::calibrate(bool calibrateImu) {
+void lemlib::Chassis::calibrate(bool calibrateImu, bool measureLatency) {
     // calibrate the IMU if it exists and the user doesn't specify otherwise
     if (sensors.imu != nullptr && calibrateImu) calibrateIMU(sensors);
     // initialize odom
@@ -88,10 +93,83 @@ void lemlib::Chassis::calibrate(bool calibrateImu) {
     if (sensors.horizontal2 != nullptr) sensors.horizontal2->reset();
     setSensors(sensors, drivetrain);
     init();
+    if (measureLatency) this->measureLatency();
     // rumble to controller to indicate success
-    pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, ".");
+    lemlib::rumbleController(".");
+}
+
+// drivetrain power of the pulses used to measure latency
+constexpr int LATENCY_PULSE_POWER = 60;
+// distances the tracking wheel is timed at, in inches. Starting from rest the robot moves with the square of time, so
+// the two times extrapolate back to when the pulse took effect
+constexpr float LATENCY_NEAR = 0.01;
+constexpr float LATENCY_FAR = 4 * LATENCY_NEAR;
+// number of pulses to average. They alternate forwards and backwards, so the robot ends up where it started
+constexpr int LATENCY_PULSES = 4;
+// longest a pulse can go unseen, and the robot can take to come to rest after it, before the measurement gives up, in
+// microseconds
+constexpr std::uint64_t LATENCY_TIMEOUT = 250000;
+constexpr std::uint64_t LATENCY_REST_TIMEOUT = 1000000;
+// period of the odometry task, in milliseconds. The pose a motion reads is half a period old on average
+constexpr float ODOM_PERIOD = 10;
+
+void lemlib::Chassis::measureLatency() {
+    // time the wheel odometry tracks position with, preferring unpowered tracking wheels
+    TrackingWheel* wheel = sensors.vertical1;
+    if (wheel->getType() && !sensors.vertical2->getType()) wheel = sensors.vertical2;
+    // brake between pulses so the robot barely moves
+    const auto brakeMode = static_cast<pros::motor_brake_mode_e>(drivetrain.leftMotors->get_brake_mode());
+    setBrakeMode(pros::E_MOTOR_BRAKE_BRAKE);
+    float total = 0;
+    int pulse = 0;
+    bool rested = true;
+    for (; pulse < LATENCY_PULSES; pulse++) {
+        const int power = pulse % 2 == 0 ? LATENCY_PULSE_POWER : -LATENCY_PULSE_POWER;
+        const float startDistance = wheel->getDistanceTraveled();
+        const std::uint64_t start = lemlib::micros();
+        std::uint64_t near = 0;
+        std::uint64_t far = 0;
+        leftDrive.move(power);
+        rightDrive.move(power);
+        while (far == 0 && lemlib::micros() - start < LATENCY_TIMEOUT) {
+            const float distance = fabs(wheel->getDistanceTraveled() - startDistance);
+            if (near == 0 && distance > LATENCY_NEAR) near = lemlib::micros() - start;
+            if (distance > LATENCY_FAR) far = lemlib::micros() - start;
+            lemlib::delay(1);
+        }
+        leftDrive.brake();
+        rightDrive.brake();
+        // wait for the robot to come to rest. A robot being pushed, or a wheel that keeps creeping, never does
+        const std::uint64_t braked = lemlib::micros();
+        float lastDistance;
+        do {
+            lastDistance = wheel->getDistanceTraveled();
+            lemlib::delay(20);
+            rested = fabs(wheel->getDistanceTraveled() - lastDistance) <= LATENCY_NEAR / 10;
+        } while (!rested && lemlib::micros() - braked < LATENCY_REST_TIMEOUT);
+        if (far == 0 || !rested) break;
+        // the robot moved the first quarter of the far distance in half the time
+        total += std::max(0.0f, 2.0f * near - far) / 1000;
+    }
+    setBrakeMode(brakeMode);
+    if (!rested) {
+        log<Module::CHASSIS, Level::WARN>("Latency measurement failed, the robot didn't come to rest. Latency is {} ms",
+                                          latency);
+        return;
+    }
+    if (pulse < LATENCY_PULSES) {
+        log<Module::CHASSIS, Level::WARN>("Latency measurement failed, the drivetrain didn't move. Latency is {} ms",
+                                          latency);
+        return;
+    }
+    latency = total / LATENCY_PULSES + ODOM_PERIOD / 2;
+    log<Module::CHASSIS, Level::INFO>("Measured latency: {} ms", latency);
 }
 
+float lemlib::Chassis::getLatency() const { return latency; }
+
+void lemlib::Chassis::setLatency(float latency) { this->latency = latency; }
+
 void lemlib::Chassis::setPose(float x, float y, float theta, bool radians) {
     lemlib::setPose(lemlib::Pose(x, y, theta), radians);
 }
@@ -105,14 +183,22 @@ lemlib::Pose lemlib::Chassis::getPose(bool radians, bool standardPos) {
     return pose;
 }
 
+lemlib::Pose lemlib::Chassis::getControlPose(bool predict, bool radians, bool standardPos) {
+    if (!predict) return getPose(radians, standardPos);
+    Pose pose = lemlib::estimatePose(latency / 1000, true);
+    if (standardPos) pose.theta = M_PI_2 - pose.theta;
+    if (!radians) pose.theta = radToDeg(pose.theta);
+    return pose;
+}
+
 void lemlib::Chassis::waitUntil(float dist) {
     // do while to give the thread time to start
-    do pros::delay(10);
+    do lemlib::delay(10);
     while (distTraveled <= dist && distTraveled != -1);
 }
 
 void lemlib::Chassis::waitUntilDone() {
-    do pros::delay(10);
+    do lemlib::delay(10);
     while (distTraveled != -1);
 }
 
@@ -139,13 +225,13 @@ void lemlib::Chassis::endMotion() {
 
 void lemlib::Chassis::cancelMotion() {
     this->motionRunning = false;
-    pros::delay(10); // give time for motion to stop
+    lemlib::delay(10); // give time for motion to stop
 }
 
 void lemlib::Chassis::cancelAllMotions() {
     this->motionRunning = false;
     this->motionQueued = false;
-    pros::delay(10); // give time for motion to stop
+    lemlib::delay(10); // give time for motion to stop
 }
 
 bool lemlib::Chassis::isInMotion() const { return this->motionRunning; }
@@ -159,3 +245,5 @@ void lemlib::Chassis::setBrakeMode(pros::motor_brake_mode_e mode) {
     drivetrain.leftMotors->set_brake_mode_all(mode);
     drivetrain.rightMotors->set_brake_mode_all(mode);
 }
+
+void lemlib::Chassis::setMPCSettings(const MPCSettings& settings) { mpcSettings = settings; }
@@ -1,6 +1,8 @@
 #include <cmath>
+#include "lemlib/clock.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profile.hpp"
 #include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 #include "pros/misc.hpp"
@@ -14,7 +16,7 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
     if (async) {
         pros::Task task([&]() { moveToPoint(x, y, timeout, params, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        lemlib::delay(10); // delay to give the task time to start
         return;
     }
 
@@ -31,18 +33,20 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
     bool close = false;
     float prevLateralOut = 0; // previous lateral power
     float prevAngularOut = 0; // previous angular power
-    const int compState = pros::competition::get_status();
     std::optional<bool> prevSide = std::nullopt;
 
     // calculate target pose in standard form
     Pose target(x, y);
     target.theta = lastPose.angle(target);
 
+    static LoopProfile profile("moveToPoint");
+
     // main loop
     while (!timer.isDone() && ((!lateralSmallExit.getExit() && !lateralLargeExit.getExit()) || !close) &&
            this->motionRunning) {
+        profile.start();
         // update position
-        const Pose pose = getPose(true, true);
+        const Pose pose = getControlPose(params.predict, true, true);
 
         // update distance traveled
         distTraveled += pose.distance(lastPose);
@@ -103,7 +107,7 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         prevAngularOut = angularOut;
         prevLateralOut = lateralOut;
 
-        infoSink()->debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+        log<Module::MOTION, Level::DEBUG>("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
 
         // ratio the speeds to respect the max speed
         float leftPower = lateralOut + angularOut;
@@ -115,16 +119,17 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         }
 
         // move the drivetrain
-        drivetrain.leftMotors->move(leftPower);
-        drivetrain.rightMotors->move(rightPower);
+        leftDrive.move(leftPower);
+        rightDrive.move(rightPower);
 
         // delay to save resources
-        pros::delay(10);
+        profile.delay(10);
     }
+    profile.end();
 
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    leftDrive.move(0);
+    rightDrive.move(0);
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     this->endMotion();
@@ -1,6 +1,10 @@
 #include <cmath>
+#include <optional>
+#include "lemlib/clock.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profile.hpp"
 #include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 #include "pros/misc.hpp"
@@ -14,7 +18,7 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
     if (async) {
         pros::Task task([&]() { moveToPose(x, y, theta, timeout, params, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        lemlib::delay(10); // delay to give the task time to start
         return;
     }
 
@@ -41,15 +45,24 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
     bool lateralSettled = false;
     bool prevSameSide = false;
     float prevLateralOut = 0; // previous lateral power
-    float prevAngularOut = 0; // previous angular power
-    const int compState = pros::competition::get_status();
+    // model predictive controller, which works in inches per second rather than motor power. Only built when used
+    const float fullSpeed = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    std::optional<MPC> mpc;
+    if (params.mpc) {
+        mpc.emplace(mpcSettings, drivetrain.trackWidth);
+        const float initialSpeed = getLocalSpeed(true).y;
+        mpc->reset(initialSpeed, initialSpeed);
+    }
+
+    static LoopProfile profile("moveToPose");
 
     // main loop
     while (!timer.isDone() &&
            ((!lateralSettled || (!angularLargeExit.getExit() && !angularSmallExit.getExit())) || !close) &&
            this->motionRunning) {
+        profile.start();
         // update position
-        const Pose pose = getPose(true, true);
+        const Pose pose = getControlPose(params.predict, true, true);
 
         // update distance traveled
         distTraveled += pose.distance(lastPose);
@@ -98,6 +111,19 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
         angularSmallExit.update(radToDeg(angularError));
         angularLargeExit.update(radToDeg(angularError));
 
+        // the model predictive controller drives the approach, and hands over to the PIDs to settle on the target.
+        // The PIDs aren't updated while it drives, so they start settling from a reset state
+        if (mpc && !close) {
+            const auto [left, right] = mpc->update(pose, target, params.lead, params.maxSpeed / 127 * fullSpeed,
+                                                   params.minSpeed / 127 * fullSpeed, params.forwards);
+            // the PIDs start settling from the speed the robot is at
+            prevLateralOut = (left + right) / 2 / fullSpeed * 127;
+            leftDrive.move(left / fullSpeed * 127);
+            rightDrive.move(right / fullSpeed * 127);
+            profile.delay(10);
+            continue;
+        }
+
         // get output from PIDs
         float lateralOut = lateralPID.update(lateralError);
         float angularOut = angularPID.update(radToDeg(angularError));
@@ -130,10 +156,9 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
             lateralOut = -fabs(params.minSpeed);
 
         // update previous output
-        prevAngularOut = angularOut;
         prevLateralOut = lateralOut;
 
-        infoSink()->debug("lateralOut: {} angularOut: {}", lateralOut, angularOut);
+        log<Module::MOTION, Level::DEBUG>("lateralOut: {} angularOut: {}", lateralOut, angularOut);
 
         // ratio the speeds to respect the max speed
         float leftPower = lateralOut + angularOut;
@@ -145,16 +170,17 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
         }
 
         // move the drivetrain
-        drivetrain.leftMotors->move(leftPower);
-        drivetrain.rightMotors->move(rightPower);
+        leftDrive.move(leftPower);
+        rightDrive.move(rightPower);
 
         // delay to save resources
-        pros::delay(10);
+        profile.delay(10);
     }
+    profile.end();
 
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    leftDrive.move(0);
+    rightDrive.move(0);
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     this->endMotion();
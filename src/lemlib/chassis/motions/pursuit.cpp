@@ -7,7 +7,9 @@
 #include <vector>
 #include <string>
 #include "pros/misc.hpp"
+#include "lemlib/clock.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profile.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/util.hpp"
 
@@ -69,13 +71,16 @@ std::vector<lemlib::Pose> getData(const asset& path) {
 
     // read the points until 'endData' is read
     for (std::string line : dataLines) {
-        lemlib::infoSink()->debug("read raw line {}", stringToHex(line));
+        // converting the line to hex isn't free, only do it if the message is compiled in
+        if constexpr (lemlib::compiledLevel(lemlib::Module::MOTION) <= lemlib::Level::DEBUG) {
+            lemlib::log<lemlib::Module::MOTION, lemlib::Level::DEBUG>("read raw line {}", stringToHex(line));
+        }
         if (line == "endData" || line == "endData\r") break;
         const std::vector<std::string> pointInput = readElement(line, ", "); // parse line
         // check if the line was read correctly
         if (pointInput.size() != 3) {
-            lemlib::infoSink()->error("Failed to read path file! Are you using the right format? Raw line: {}",
-                                      stringToHex(line));
+            lemlib::log<lemlib::Module::MOTION, lemlib::Level::ERROR>(
+                "Failed to read path file! Are you using the right format? Raw line: {}", stringToHex(line));
             break;
         }
         lemlib::Pose pathPoint(0, 0);
@@ -83,7 +88,7 @@ std::vector<lemlib::Pose> getData(const asset& path) {
         pathPoint.y = std::stof(pointInput.at(1)); // y position
         pathPoint.theta = std::stof(pointInput.at(2)); // velocity
         robotPath.push_back(pathPoint); // save data
-        lemlib::infoSink()->debug("read point {}", pathPoint);
+        lemlib::log<lemlib::Module::MOTION, lemlib::Level::DEBUG>("read point {}", pathPoint);
     }
 
     return robotPath;
@@ -97,11 +102,11 @@ std::vector<lemlib::Pose> getData(const asset& path) {
  * @return int index to the closest point
  */
 int findClosest(lemlib::Pose pose, std::vector<lemlib::Pose> path) {
-    int closestPoint;
+    int closestPoint = 0;
     float closestDist = infinity();
 
     // loop through all path points
-    for (int i = 0; i < path.size(); i++) {
+    for (int i = 0; i < int(path.size()); i++) {
         const float dist = pose.distance(path.at(i));
         if (dist < closestDist) { // new closest point
             closestDist = dist;
@@ -163,7 +168,7 @@ lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, std::
     // and intersections that have an index greater than or equal to the index of the last
     // lookahead point
     const int start = std::max(closest, int(lastLookahead.theta));
-    for (int i = start; i < path.size() - 1; i++) {
+    for (int i = start; i < int(path.size()) - 1; i++) {
         lemlib::Pose lastPathPose = path.at(i);
         lemlib::Pose currentPathPose = path.at(i + 1);
 
@@ -209,13 +214,13 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
     if (async) {
         pros::Task task([&]() { follow(path, lookahead, timeout, forwards, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        lemlib::delay(10); // delay to give the task time to start
         return;
     }
 
     std::vector<lemlib::Pose> pathPoints = getData(path); // get list of path points
     if (pathPoints.size() == 0) {
-        infoSink()->error("No points in path! Do you have the right format? Skipping motion");
+        log<Module::MOTION, Level::ERROR>("No points in path! Do you have the right format? Skipping motion");
         // set distTraveled to -1 to indicate that the function has finished
         distTraveled = -1;
         // give the mutex back
@@ -229,17 +234,16 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
     lastLookahead.theta = 0;
     float curvature;
     float targetVel;
-    float prevLeftVel = 0;
-    float prevRightVel = 0;
     int closestPoint;
-    float leftInput = 0;
-    float rightInput = 0;
     float prevVel = 0;
     int compState = pros::competition::get_status();
     distTraveled = 0;
 
+    static LoopProfile profile("follow");
+
     // loop until the robot is within the end tolerance
     for (int i = 0; i < timeout / 10 && pros::competition::get_status() == compState && this->motionRunning; i++) {
+        profile.start();
         // get the current position of the robot
         pose = this->getPose(true);
         if (!forwards) pose.theta -= M_PI;
@@ -277,25 +281,22 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
             targetRightVel /= ratio;
         }
 
-        // update previous velocities
-        prevLeftVel = targetLeftVel;
-        prevRightVel = targetRightVel;
-
         // move the drivetrain
         if (forwards) {
-            drivetrain.leftMotors->move(targetLeftVel);
-            drivetrain.rightMotors->move(targetRightVel);
+            leftDrive.move(targetLeftVel);
+            rightDrive.move(targetRightVel);
         } else {
-            drivetrain.leftMotors->move(-targetRightVel);
-            drivetrain.rightMotors->move(-targetLeftVel);
+            leftDrive.move(-targetRightVel);
+            rightDrive.move(-targetLeftVel);
         }
 
-        pros::delay(10);
+        profile.delay(10);
     }
+    profile.end();
 
     // stop the robot
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    leftDrive.move(0);
+    rightDrive.move(0);
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     // give the mutex back
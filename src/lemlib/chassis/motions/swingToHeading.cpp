@@ -1,6 +1,8 @@
 #include <cmath>
+#include "lemlib/clock.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profile.hpp"
 #include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 #include "pros/misc.hpp"
@@ -15,7 +17,7 @@ void lemlib::Chassis::swingToHeading(float theta, DriveSide lockedSide, int time
     if (async) {
         pros::Task task([&]() { swingToHeading(theta, lockedSide, timeout, params, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        lemlib::delay(10); // delay to give the task time to start
         return;
     }
     float targetTheta;
@@ -26,7 +28,6 @@ void lemlib::Chassis::swingToHeading(float theta, DriveSide lockedSide, int time
     bool settling = false;
     std::optional<float> prevRawDeltaTheta = std::nullopt;
     std::optional<float> prevDeltaTheta = std::nullopt;
-    std::uint8_t compState = pros::competition::get_status();
     distTraveled = 0;
     Timer timer(timeout);
     angularLargeExit.reset();
@@ -40,10 +41,13 @@ void lemlib::Chassis::swingToHeading(float theta, DriveSide lockedSide, int time
     if (lockedSide == DriveSide::LEFT) this->drivetrain.leftMotors->set_brake_mode_all(pros::E_MOTOR_BRAKE_HOLD);
     else this->drivetrain.rightMotors->set_brake_mode_all(pros::E_MOTOR_BRAKE_HOLD);
 
+    static LoopProfile profile("swingToHeading");
+
     // main loop
     while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() && this->motionRunning) {
+        profile.start();
         // update variables
-        Pose pose = getPose();
+        Pose pose = getControlPose(params.predict);
         pose.theta = fmod(pose.theta, 360);
 
         // update completion vars
@@ -78,28 +82,29 @@ void lemlib::Chassis::swingToHeading(float theta, DriveSide lockedSide, int time
         else if (motorPower > 0 && motorPower < params.minSpeed) motorPower = params.minSpeed;
         prevMotorPower = motorPower;
 
-        infoSink()->debug("Turn Motor Power: {} ", motorPower);
+        log<Module::MOTION, Level::DEBUG>("Turn Motor Power: {} ", motorPower);
 
         // move the drivetrain
         if (lockedSide == DriveSide::LEFT) {
-            drivetrain.rightMotors->move(-motorPower);
-            drivetrain.leftMotors->brake();
+            rightDrive.move(-motorPower);
+            leftDrive.brake();
         } else {
-            drivetrain.leftMotors->move(motorPower);
-            drivetrain.rightMotors->brake();
+            leftDrive.move(motorPower);
+            rightDrive.brake();
         }
 
         // delay to save resources
-        pros::delay(10);
+        profile.delay(10);
     }
+    profile.end();
 
     // set the brake mode of the locked side of the drivetrain to its
     // original value
     if (lockedSide == DriveSide::LEFT) this->drivetrain.leftMotors->set_brake_mode_all(brakeMode);
     else this->drivetrain.rightMotors->set_brake_mode_all(brakeMode);
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    leftDrive.move(0);
+    rightDrive.move(0);
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     this->endMotion();
@@ -1,6 +1,8 @@
 #include <cmath>
+#include "lemlib/clock.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profile.hpp"
 #include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 #include "pros/misc.hpp"
@@ -14,7 +16,7 @@ void lemlib::Chassis::turnToHeading(float theta, int timeout, TurnToHeadingParam
     if (async) {
         pros::Task task([&]() { turnToHeading(theta, timeout, params, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        lemlib::delay(10); // delay to give the task time to start
         return;
     }
     float targetTheta;
@@ -25,17 +27,19 @@ void lemlib::Chassis::turnToHeading(float theta, int timeout, TurnToHeadingParam
     bool settling = false;
     std::optional<float> prevRawDeltaTheta = std::nullopt;
     std::optional<float> prevDeltaTheta = std::nullopt;
-    std::uint8_t compState = pros::competition::get_status();
     distTraveled = 0;
     Timer timer(timeout);
     angularLargeExit.reset();
     angularSmallExit.reset();
     angularPID.reset();
 
+    static LoopProfile profile("turnToHeading");
+
     // main loop
     while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() && this->motionRunning) {
+        profile.start();
         // update variables
-        Pose pose = getPose();
+        Pose pose = getControlPose(params.predict);
 
         // update completion vars
         distTraveled = fabs(angleError(pose.theta, startTheta, false));
@@ -70,18 +74,19 @@ void lemlib::Chassis::turnToHeading(float theta, int timeout, TurnToHeadingParam
         else if (motorPower > 0 && motorPower < params.minSpeed) motorPower = params.minSpeed;
         prevMotorPower = motorPower;
 
-        infoSink()->debug("Turn Motor Power: {} ", motorPower);
+        log<Module::MOTION, Level::DEBUG>("Turn Motor Power: {} ", motorPower);
 
         // move the drivetrain
-        drivetrain.leftMotors->move(motorPower);
-        drivetrain.rightMotors->move(-motorPower);
+        leftDrive.move(motorPower);
+        rightDrive.move(-motorPower);
 
-        pros::delay(10);
+        profile.delay(10);
     }
+    profile.end();
 
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    leftDrive.move(0);
+    rightDrive.move(0);
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     this->endMotion();
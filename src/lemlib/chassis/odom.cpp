@@ -4,7 +4,11 @@
 // http://thepilons.ca/wp-content/uploads/2018/10/Tracking.pdf
 
 #include <math.h>
+#include <cstring>
+#include <mutex>
 #include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/profile.hpp"
 #include "lemlib/util.hpp"
 #include "lemlib/chassis/odom.hpp"
 #include "lemlib/chassis/chassis.hpp"
@@ -28,6 +32,58 @@ float prevHorizontal1 = 0;
 float prevHorizontal2 = 0;
 float prevImu = 0;
 
+// keeps updates and setPose in order for the recording
+pros::Mutex odomMutex;
+std::function<void(const lemlib::TelemetryFrame& frame)> odomConsumer = nullptr;
+
+/**
+ * @brief Send a frame of floats to the recording, after the reason on ODOM_RESET_CHANNEL. The mutex has to be taken
+ */
+static void recordFloats(std::uint8_t channel, std::uint8_t reason, std::initializer_list<float> values) {
+    std::uint8_t payload[1 + 8 * sizeof(float)];
+    std::size_t size = 0;
+    if (channel == lemlib::ODOM_RESET_CHANNEL) payload[size++] = reason;
+    for (float value : values) {
+        std::memcpy(payload + size, &value, sizeof(value));
+        size += sizeof(value);
+    }
+    odomConsumer({channel, lemlib::millis(), payload, size});
+}
+
+/**
+ * @brief Send the state a replay starts from to the recording. The mutex has to be taken
+ */
+static void recordReset(std::uint8_t reason) {
+    recordFloats(lemlib::ODOM_RESET_CHANNEL, reason,
+                 {odomPose.x, odomPose.y, odomPose.theta, prevVertical1, prevVertical2, prevHorizontal1,
+                  prevHorizontal2, prevImu});
+}
+
+/**
+ * @brief Get the reading of the vertical wheel used for position, preferring unpowered tracking wheels
+ */
+static lemlib::TrackingWheel* verticalWheel(const lemlib::OdomSample& sample, float& reading) {
+    if (!odomSensors.vertical1->getType()) reading = sample.vertical1;
+    else if (!odomSensors.vertical2->getType()) {
+        reading = sample.vertical2;
+        return odomSensors.vertical2;
+    } else reading = sample.vertical1;
+    return odomSensors.vertical1;
+}
+
+/**
+ * @brief Get the reading of the horizontal wheel used for position, nullptr if there is none
+ */
+static lemlib::TrackingWheel* horizontalWheel(const lemlib::OdomSample& sample, float& reading) {
+    reading = 0;
+    if (odomSensors.horizontal1 != nullptr) {
+        reading = sample.horizontal1;
+        return odomSensors.horizontal1;
+    }
+    if (odomSensors.horizontal2 != nullptr) reading = sample.horizontal2;
+    return odomSensors.horizontal2;
+}
+
 void lemlib::setSensors(lemlib::OdomSensors sensors, lemlib::Drivetrain drivetrain) {
     odomSensors = sensors;
     drive = drivetrain;
@@ -39,8 +95,28 @@ lemlib::Pose lemlib::getPose(bool radians) {
 }
 
 void lemlib::setPose(lemlib::Pose pose, bool radians) {
+    std::lock_guard lock(odomMutex);
     if (radians) odomPose = pose;
     else odomPose = lemlib::Pose(pose.x, pose.y, degToRad(pose.theta));
+    if (odomConsumer) recordReset(1);
+}
+
+void lemlib::resetOdom(lemlib::Pose pose, const lemlib::OdomSample& previous) {
+    std::lock_guard lock(odomMutex);
+    odomPose = pose;
+    prevVertical1 = previous.vertical1;
+    prevVertical2 = previous.vertical2;
+    prevHorizontal1 = previous.horizontal1;
+    prevHorizontal2 = previous.horizontal2;
+    prevImu = previous.imu;
+    verticalWheel(previous, prevVertical);
+    horizontalWheel(previous, prevHorizontal);
+}
+
+void lemlib::recordOdom(std::function<void(const TelemetryFrame& frame)> consumer) {
+    std::lock_guard lock(odomMutex);
+    odomConsumer = std::move(consumer);
+    if (odomConsumer) recordReset(0);
 }
 
 lemlib::Pose lemlib::getSpeed(bool radians) {
@@ -57,8 +133,9 @@ lemlib::Pose lemlib::estimatePose(float time, bool radians) {
     // get current position and speed
     Pose curPose = getPose(true);
     Pose localSpeed = getLocalSpeed(true);
-    // calculate the change in local position
+    // calculate the change in local position. Scaling a pose leaves theta alone, so scale it separately
     Pose deltaLocalPose = localSpeed * time;
+    deltaLocalPose.theta = localSpeed.theta * time;
 
     // calculate the future pose
     float avgHeading = curPose.theta + deltaLocalPose.theta / 2;
@@ -67,38 +144,48 @@ lemlib::Pose lemlib::estimatePose(float time, bool radians) {
     futurePose.y += deltaLocalPose.y * cos(avgHeading);
     futurePose.x += deltaLocalPose.x * -cos(avgHeading);
     futurePose.y += deltaLocalPose.x * sin(avgHeading);
+    futurePose.theta += deltaLocalPose.theta;
     if (!radians) futurePose.theta = radToDeg(futurePose.theta);
 
     return futurePose;
 }
 
+lemlib::OdomSample lemlib::readOdomSample() {
+    OdomSample sample;
+    if (odomSensors.vertical1 != nullptr) sample.vertical1 = odomSensors.vertical1->getDistanceTraveled();
+    if (odomSensors.vertical2 != nullptr) sample.vertical2 = odomSensors.vertical2->getDistanceTraveled();
+    if (odomSensors.horizontal1 != nullptr) sample.horizontal1 = odomSensors.horizontal1->getDistanceTraveled();
+    if (odomSensors.horizontal2 != nullptr) sample.horizontal2 = odomSensors.horizontal2->getDistanceTraveled();
+    if (odomSensors.imu != nullptr) sample.imu = degToRad(odomSensors.imu->get_rotation());
+    return sample;
+}
+
 void lemlib::update() {
-    // TODO: add particle filter
-    // get the current sensor values
-    float vertical1Raw = 0;
-    float vertical2Raw = 0;
-    float horizontal1Raw = 0;
-    float horizontal2Raw = 0;
-    float imuRaw = 0;
-    if (odomSensors.vertical1 != nullptr) vertical1Raw = odomSensors.vertical1->getDistanceTraveled();
-    if (odomSensors.vertical2 != nullptr) vertical2Raw = odomSensors.vertical2->getDistanceTraveled();
-    if (odomSensors.horizontal1 != nullptr) horizontal1Raw = odomSensors.horizontal1->getDistanceTraveled();
-    if (odomSensors.horizontal2 != nullptr) horizontal2Raw = odomSensors.horizontal2->getDistanceTraveled();
-    if (odomSensors.imu != nullptr) imuRaw = degToRad(odomSensors.imu->get_rotation());
+    const OdomSample sample = readOdomSample();
+    std::lock_guard lock(odomMutex);
+    update(sample);
+    if (odomConsumer) {
+        recordFloats(ODOM_SAMPLE_CHANNEL, 0,
+                     {sample.vertical1, sample.vertical2, sample.horizontal1, sample.horizontal2, sample.imu,
+                      odomPose.x, odomPose.y, odomPose.theta});
+    }
+}
 
+void lemlib::update(const OdomSample& sample) {
+    // TODO: add particle filter
     // calculate the change in sensor values
-    float deltaVertical1 = vertical1Raw - prevVertical1;
-    float deltaVertical2 = vertical2Raw - prevVertical2;
-    float deltaHorizontal1 = horizontal1Raw - prevHorizontal1;
-    float deltaHorizontal2 = horizontal2Raw - prevHorizontal2;
-    float deltaImu = imuRaw - prevImu;
+    float deltaVertical1 = sample.vertical1 - prevVertical1;
+    float deltaVertical2 = sample.vertical2 - prevVertical2;
+    float deltaHorizontal1 = sample.horizontal1 - prevHorizontal1;
+    float deltaHorizontal2 = sample.horizontal2 - prevHorizontal2;
+    float deltaImu = sample.imu - prevImu;
 
     // update the previous sensor values
-    prevVertical1 = vertical1Raw;
-    prevVertical2 = vertical2Raw;
-    prevHorizontal1 = horizontal1Raw;
-    prevHorizontal2 = horizontal2Raw;
-    prevImu = imuRaw;
+    prevVertical1 = sample.vertical1;
+    prevVertical2 = sample.vertical2;
+    prevHorizontal1 = sample.horizontal1;
+    prevHorizontal2 = sample.horizontal2;
+    prevImu = sample.imu;
 
     // calculate the heading of the robot
     // Priority:
@@ -124,29 +211,20 @@ void lemlib::update() {
     float deltaHeading = heading - odomPose.theta;
     float avgHeading = odomPose.theta + deltaHeading / 2;
 
-    // choose tracking wheels to use
+    // choose tracking wheels to use, from the same sample as the heading
     // Prioritize non-powered tracking wheels
-    lemlib::TrackingWheel* verticalWheel = nullptr;
-    lemlib::TrackingWheel* horizontalWheel = nullptr;
-    if (!odomSensors.vertical1->getType()) verticalWheel = odomSensors.vertical1;
-    else if (!odomSensors.vertical2->getType()) verticalWheel = odomSensors.vertical2;
-    else verticalWheel = odomSensors.vertical1;
-    if (odomSensors.horizontal1 != nullptr) horizontalWheel = odomSensors.horizontal1;
-    else if (odomSensors.horizontal2 != nullptr) horizontalWheel = odomSensors.horizontal2;
     float rawVertical = 0;
     float rawHorizontal = 0;
-    if (verticalWheel != nullptr) rawVertical = verticalWheel->getDistanceTraveled();
-    if (horizontalWheel != nullptr) rawHorizontal = horizontalWheel->getDistanceTraveled();
+    lemlib::TrackingWheel* vertical = verticalWheel(sample, rawVertical);
+    lemlib::TrackingWheel* horizontal = horizontalWheel(sample, rawHorizontal);
+    float verticalOffset = vertical->getOffset();
     float horizontalOffset = 0;
-    float verticalOffset = 0;
-    if (verticalWheel != nullptr) verticalOffset = verticalWheel->getOffset();
-    if (horizontalWheel != nullptr) horizontalOffset = horizontalWheel->getOffset();
+    if (horizontal != nullptr) horizontalOffset = horizontal->getOffset();
 
     // calculate change in x and y
     float deltaX = 0;
-    float deltaY = 0;
-    if (verticalWheel != nullptr) deltaY = rawVertical - prevVertical;
-    if (horizontalWheel != nullptr) deltaX = rawHorizontal - prevHorizontal;
+    float deltaY = rawVertical - prevVertical;
+    if (horizontal != nullptr) deltaX = rawHorizontal - prevHorizontal;
     prevVertical = rawVertical;
     prevHorizontal = rawHorizontal;
 
@@ -185,9 +263,11 @@ void lemlib::update() {
 void lemlib::init() {
     if (trackingTask == nullptr) {
         trackingTask = new pros::Task {[=] {
+            static LoopProfile profile("odom");
             while (true) {
+                profile.start();
                 update();
-                pros::delay(10);
+                profile.delay(10);
             }
         }};
     }
@@ -8,11 +8,11 @@ ExpoDriveCurve defaultDriveCurve = ExpoDriveCurve(0, 0, 1);
 
 void Chassis::tank(int left, int right, bool disableDriveCurve) {
     if (disableDriveCurve) {
-        drivetrain.leftMotors->move(left);
-        drivetrain.rightMotors->move(right);
+        leftDrive.move(left);
+        rightDrive.move(right);
     } else {
-        drivetrain.leftMotors->move(throttleCurve->curve(left));
-        drivetrain.rightMotors->move(throttleCurve->curve(right));
+        leftDrive.move(throttleCurve->curve(left));
+        rightDrive.move(throttleCurve->curve(right));
     }
 }
 
@@ -40,8 +40,8 @@ void Chassis::arcade(int throttle, int turn, bool disableDriveCurve, float desat
     int rightPower = throttle - turn;
 
     // move drive
-    drivetrain.leftMotors->move(leftPower);
-    drivetrain.rightMotors->move(rightPower);
+    leftDrive.move(leftPower);
+    rightDrive.move(rightPower);
 }
 
 void Chassis::curvature(int throttle, int turn, bool disableDriveCurve) {
@@ -66,7 +66,7 @@ void Chassis::curvature(int throttle, int turn, bool disableDriveCurve) {
         leftPower /= max;
         rightPower /= max;
     }
-    drivetrain.leftMotors->move(leftPower);
-    drivetrain.rightMotors->move(rightPower);
+    leftDrive.move(leftPower);
+    rightDrive.move(rightPower);
 }
 } // namespace lemlib
@@ -0,0 +1,47 @@
+#include "lemlib/clock.hpp"
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+std::uint64_t SystemClock::micros() { return pros::micros(); }
+
+void SystemClock::sleepUntil(std::uint64_t time) {
+    const std::uint64_t now = pros::micros();
+    if (time <= now) return;
+    // round up, so the sleep is never shorter than asked for
+    pros::delay((time - now + 999) / 1000);
+}
+
+VirtualClock::VirtualClock(std::uint64_t start)
+    : time(start) {}
+
+std::uint64_t VirtualClock::micros() { return time; }
+
+void VirtualClock::sleepUntil(std::uint64_t time) {
+    if (time > this->time) this->time = time;
+}
+
+void VirtualClock::advance(std::uint64_t time) { this->time += time; }
+
+static Clock* currentClock = nullptr;
+
+void setClock(Clock* clock) { currentClock = clock; }
+
+Clock& getClock() {
+    static SystemClock system;
+    return currentClock == nullptr ? system : *currentClock;
+}
+
+std::uint64_t micros() { return getClock().micros(); }
+
+std::uint32_t millis() { return getClock().micros() / 1000; }
+
+void delay(std::uint32_t milliseconds) {
+    Clock& clock = getClock();
+    clock.sleepUntil(clock.micros() + milliseconds * 1000ull);
+}
+
+void delayUntil(std::uint64_t& previous, std::uint64_t period) {
+    previous += period;
+    getClock().sleepUntil(previous);
+}
+} // namespace lemlib
@@ -0,0 +1,129 @@
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include "pros/error.h"
+#include "lemlib/controllerScreen.hpp"
+
+namespace lemlib {
+// the list of screens. Locals, so screens constructed as globals in other files can use them
+static pros::Mutex& screensMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
+
+static ControllerScreen*& screens() {
+    static ControllerScreen* head = nullptr;
+    return head;
+}
+
+ControllerScreen::ControllerScreen(const char* name, pros::controller_id_e_t id, std::uint32_t period)
+    : Subsystem(name, period),
+      id(id) {
+    std::lock_guard lock(screensMutex());
+    next = screens();
+    screens() = this;
+}
+
+ControllerScreen::~ControllerScreen() {
+    std::lock_guard lock(screensMutex());
+    for (ControllerScreen** screen = &screens(); *screen != nullptr; screen = &(*screen)->next) {
+        if (*screen == this) {
+            *screen = next;
+            break;
+        }
+    }
+}
+
+void ControllerScreen::update() {
+    std::string pattern;
+    std::string line;
+    int index = -1;
+    {
+        std::lock_guard lock(mutex);
+        if (!rumbles.empty()) pattern = rumbles.front();
+        else {
+            for (int i = 0; i < 3 && index < 0; i++) {
+                const int candidate = (nextLine + i) % 3;
+                if (text[candidate] != sent[candidate]) index = candidate;
+            }
+            if (index < 0) return;
+            line = text[index];
+        }
+    }
+    // write without the mutex, so setting text never waits for the controller
+    const bool rumbling = index < 0;
+    const std::int32_t result = rumbling ? pros::c::controller_rumble(id, pattern.c_str())
+                                         : pros::c::controller_set_text(id, index, 0, line.c_str());
+    std::lock_guard lock(mutex);
+    if (result == PROS_ERR) {
+        refused++;
+        return;
+    }
+    writes++;
+    if (rumbling) rumbles.pop_front();
+    else {
+        sent[index] = line;
+        nextLine = (index + 1) % 3;
+    }
+}
+
+void ControllerScreen::setText(std::uint8_t line, const std::string& text) {
+    if (line > 2) return;
+    std::string padded = text.substr(0, WIDTH);
+    padded.resize(WIDTH, ' ');
+    std::lock_guard lock(mutex);
+    const bool wasChanged = this->text[line] != sent[line];
+    this->text[line] = padded;
+    // a write is only added if the line matched the controller and doesn't anymore
+    if (wasChanged || padded == sent[line]) coalesced++;
+}
+
+void ControllerScreen::print(std::uint8_t line, const char* fmt, ...) {
+    char buffer[64];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    setText(line, buffer);
+}
+
+void ControllerScreen::clearLine(std::uint8_t line) { setText(line, ""); }
+
+void ControllerScreen::rumble(const char* pattern) {
+    std::lock_guard lock(mutex);
+    if (!rumbles.empty() && rumbles.back() == pattern) {
+        coalesced++;
+        return;
+    }
+    if (rumbles.size() >= MAX_RUMBLES) return;
+    rumbles.push_back(pattern);
+}
+
+std::uint32_t ControllerScreen::getWrites() {
+    std::lock_guard lock(mutex);
+    return writes;
+}
+
+std::uint32_t ControllerScreen::getCoalesced() {
+    std::lock_guard lock(mutex);
+    return coalesced;
+}
+
+std::uint32_t ControllerScreen::getRefused() {
+    std::lock_guard lock(mutex);
+    return refused;
+}
+
+ControllerScreen* ControllerScreen::find(pros::controller_id_e_t id) {
+    std::lock_guard lock(screensMutex());
+    for (ControllerScreen* screen = screens(); screen != nullptr; screen = screen->next) {
+        if (screen->id == id) return screen;
+    }
+    return nullptr;
+}
+
+void rumbleController(const char* pattern, pros::controller_id_e_t id) {
+    if (ControllerScreen* screen = ControllerScreen::find(id)) screen->rumble(pattern);
+    else pros::c::controller_rumble(id, pattern);
+}
+} // namespace lemlib
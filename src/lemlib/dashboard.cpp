@@ -0,0 +1,7 @@
+#include "pros/llemu.h"
+#include "pros/llemu.hpp"
+#include "lemlib/dashboard.hpp"
+
+namespace lemlib {
+void drawBrainLine(std::uint8_t line, const char* text) { pros::lcd::print(line, "%s", text); }
+} // namespace lemlib
@@ -1,5 +1,5 @@
 #include <cmath>
-#include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
 #include "lemlib/exitcondition.hpp"
 
 namespace lemlib {
@@ -10,10 +10,10 @@ ExitCondition::ExitCondition(const float range, const int time)
 bool ExitCondition::getExit() { return done; }
 
 bool ExitCondition::update(const float input) {
-    const int curTime = pros::millis();
+    const std::int64_t curTime = lemlib::micros();
     if (std::fabs(input) > range) startTime = -1;
     else if (startTime == -1) startTime = curTime;
-    else if (curTime >= startTime + time) done = true;
+    else if (curTime >= startTime + time * 1000ll) done = true;
     return done;
 }
 
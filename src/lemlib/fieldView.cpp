@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include "lemlib/fieldView.hpp"
+#include "lemlib/util.hpp"
+
+namespace lemlib {
+// the field is 144 inches across, six 24 inch tiles
+constexpr float FIELD_SIZE = 144;
+constexpr float TILE_SIZE = 24;
+constexpr float SCALE = FieldView::SIZE / FIELD_SIZE; // pixels per inch
+// width of the robot drawn, in inches
+constexpr float ROBOT_SIZE = 15;
+// how far the robot has to move or turn to be drawn again, in inches and degrees
+constexpr float ROBOT_MOVE = 0.5f / SCALE;
+constexpr float ROBOT_TURN = 2;
+// most poses the trail keeps. Past that the oldest half is forgotten
+constexpr std::size_t MAX_TRAIL = 2000;
+
+const lv_color_t FIELD_COLOR = lv_color_hex(0x505050);
+const lv_color_t TILE_COLOR = lv_color_hex(0x404040);
+const lv_color_t RED_COLOR = lv_color_hex(0xd02020);
+const lv_color_t BLUE_COLOR = lv_color_hex(0x2040d0);
+const lv_color_t PATH_COLOR = lv_color_hex(0xffd200);
+const lv_color_t TRAIL_COLOR = lv_color_hex(0x00b4ff);
+const lv_color_t ROBOT_COLOR = lv_color_hex(0xffffff);
+const lv_color_t HEADING_COLOR = lv_color_hex(0xff8000);
+
+void FieldView::Rect::add(int x, int y) {
+    x1 = std::min(x1, std::max(x, 0));
+    y1 = std::min(y1, std::max(y, 0));
+    x2 = std::max(x2, std::min(x, SIZE - 1));
+    y2 = std::max(y2, std::min(y, SIZE - 1));
+}
+
+void FieldView::Rect::add(const Rect& other) {
+    if (other.empty()) return;
+    add(other.x1, other.y1);
+    add(other.x2, other.y2);
+}
+
+int FieldView::Rect::area() const { return empty() ? 0 : (x2 - x1 + 1) * (y2 - y1 + 1); }
+
+FieldView::FieldView(const char* name, PoseHistory* history, Pose origin, std::uint32_t period)
+    : Subsystem(name, period),
+      history(history),
+      origin(origin) {}
+
+Pose FieldView::toField(const Pose& pose) const {
+    // headings are clockwise, rotate() is counterclockwise
+    const Pose field = origin + pose.rotate(-degToRad(origin.theta));
+    return {field.x, field.y, pose.theta + origin.theta};
+}
+
+void FieldView::toPixel(float x, float y, int& px, int& py) const {
+    px = std::lround(SIZE / 2.0f + x * SCALE);
+    py = std::lround(SIZE / 2.0f - y * SCALE);
+}
+
+void FieldView::drawLine(std::vector<lv_color_t>& image, int x0, int y0, int x1, int y1, lv_color_t color,
+                         Rect& dirty) {
+    const int dx = std::abs(x1 - x0);
+    const int dy = -std::abs(y1 - y0);
+    const int sx = x0 < x1 ? 1 : -1;
+    const int sy = y0 < y1 ? 1 : -1;
+    int error = dx + dy;
+    while (true) {
+        if (x0 >= 0 && x0 < SIZE && y0 >= 0 && y0 < SIZE) {
+            image[y0 * SIZE + x0] = color;
+            dirty.add(x0, y0);
+        }
+        if (x0 == x1 && y0 == y1) break;
+        const int error2 = 2 * error;
+        if (error2 >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if (error2 <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+FieldView::Rect FieldView::drawRobot(const Pose& pose) {
+    const Pose field = toField(pose);
+    const float heading = degToRad(field.theta);
+    // forward and right of the robot, in inches on the field
+    const float fx = std::sin(heading) * ROBOT_SIZE / 2;
+    const float fy = std::cos(heading) * ROBOT_SIZE / 2;
+    const float rx = fy;
+    const float ry = -fx;
+    int x[4];
+    int y[4];
+    toPixel(field.x + fx + rx, field.y + fy + ry, x[0], y[0]);
+    toPixel(field.x - fx + rx, field.y - fy + ry, x[1], y[1]);
+    toPixel(field.x - fx - rx, field.y - fy - ry, x[2], y[2]);
+    toPixel(field.x + fx - rx, field.y + fy - ry, x[3], y[3]);
+    Rect rect;
+    for (int i = 0; i < 4; i++) drawLine(pixels, x[i], y[i], x[(i + 1) % 4], y[(i + 1) % 4], ROBOT_COLOR, rect);
+    int cx, cy, hx, hy;
+    toPixel(field.x, field.y, cx, cy);
+    toPixel(field.x + fx, field.y + fy, hx, hy);
+    drawLine(pixels, cx, cy, hx, hy, HEADING_COLOR, rect);
+    return rect;
+}
+
+void FieldView::drawBase() {
+    std::fill(base.begin(), base.end(), FIELD_COLOR);
+    Rect unused;
+    for (float at = TILE_SIZE; at < FIELD_SIZE; at += TILE_SIZE) {
+        const int line = std::lround(at * SCALE);
+        drawLine(base, line, 0, line, SIZE - 1, TILE_COLOR, unused);
+        drawLine(base, 0, line, SIZE - 1, line, TILE_COLOR, unused);
+    }
+    // the alliances' sides
+    for (int x : {0, 1}) drawLine(base, x, 0, x, SIZE - 1, RED_COLOR, unused);
+    for (int x : {SIZE - 2, SIZE - 1}) drawLine(base, x, 0, x, SIZE - 1, BLUE_COLOR, unused);
+
+    const auto drawPoses = [&](const Pose& from, const Pose& to, lv_color_t color) {
+        const Pose a = toField(from);
+        const Pose b = toField(to);
+        int x0, y0, x1, y1;
+        toPixel(a.x, a.y, x0, y0);
+        toPixel(b.x, b.y, x1, y1);
+        drawLine(base, x0, y0, x1, y1, color, unused);
+    };
+    for (std::size_t i = 1; i < path.size(); i++) drawPoses(path[i - 1], path[i], PATH_COLOR);
+    for (std::size_t i = 1; i < trail.size(); i++) {
+        if (!trail[i].jump) drawPoses(trail[i - 1].pose, trail[i].pose, TRAIL_COLOR);
+    }
+    std::copy(base.begin(), base.end(), pixels.begin());
+    robotDrawn = false;
+    baseChanged = false;
+    fullRedraws++;
+}
+
+void FieldView::restore(const Rect& rect) {
+    if (rect.empty()) return;
+    for (int y = rect.y1; y <= rect.y2; y++) {
+        std::copy(base.begin() + y * SIZE + rect.x1, base.begin() + y * SIZE + rect.x2 + 1,
+                  pixels.begin() + y * SIZE + rect.x1);
+    }
+}
+
+void FieldView::invalidate(const Rect& rect) {
+    if (rect.empty()) return;
+    lv_area_t coords;
+    lv_obj_get_coords(canvas, &coords);
+    const lv_area_t area = {lv_coord_t(coords.x1 + rect.x1), lv_coord_t(coords.y1 + rect.y1),
+                            lv_coord_t(coords.x1 + rect.x2), lv_coord_t(coords.y1 + rect.y2)};
+    lv_obj_invalidate_area(canvas, &area);
+    dirtyPixels += rect.area();
+}
+
+void FieldView::update() {
+    std::lock_guard lock(mutex);
+    if (canvas == nullptr) {
+        base.resize(SIZE * SIZE);
+        pixels.resize(SIZE * SIZE);
+        view = rd_view_create(getName());
+        canvas = lv_canvas_create(rd_view_obj(view));
+        lv_canvas_set_buffer(canvas, pixels.data(), SIZE, SIZE, LV_IMG_CF_TRUE_COLOR);
+        lv_obj_align(canvas, LV_ALIGN_CENTER, 0, 0);
+        if (focusing) rd_view_focus(view);
+        baseChanged = true;
+    }
+
+    // the poses kept since the last frame, joined to the end of the trail
+    std::vector<PoseHistory::Entry> added;
+    sequence = history->getSince(sequence, added);
+    if (trail.size() + added.size() > MAX_TRAIL) {
+        trail.erase(trail.begin(), trail.begin() + std::min(trail.size(), MAX_TRAIL / 2));
+        if (!trail.empty()) trail.front().jump = true;
+        baseChanged = true;
+    }
+    const Pose pose = history->getLatest();
+    const bool moved = !robotDrawn || pose.distance(lastPose) >= ROBOT_MOVE ||
+                       std::fabs(angleError(pose.theta, lastPose.theta, false)) >= ROBOT_TURN;
+    if (!moved && added.empty() && !baseChanged) {
+        frames++;
+        return;
+    }
+
+    if (baseChanged) {
+        trail.insert(trail.end(), added.begin(), added.end());
+        drawBase();
+        Rect all;
+        all.add(0, 0);
+        all.add(SIZE - 1, SIZE - 1);
+        robot = drawRobot(pose);
+        lastPose = pose;
+        robotDrawn = true;
+        invalidate(all);
+        frames++;
+        return;
+    }
+
+    // take the robot off, grow the trail in the base and the canvas, and put the robot back on
+    Rect robotDirty = robot;
+    restore(robot);
+    Rect trailDirty;
+    for (const PoseHistory::Entry& entry : added) {
+        if (!entry.jump && !trail.empty()) {
+            const Pose a = toField(trail.back().pose);
+            const Pose b = toField(entry.pose);
+            int x0, y0, x1, y1;
+            toPixel(a.x, a.y, x0, y0);
+            toPixel(b.x, b.y, x1, y1);
+            drawLine(base, x0, y0, x1, y1, TRAIL_COLOR, trailDirty);
+        }
+        trail.push_back(entry);
+    }
+    restore(trailDirty);
+    robot = drawRobot(pose);
+    lastPose = pose;
+    robotDirty.add(robot);
+    invalidate(trailDirty);
+    invalidate(robotDirty);
+    frames++;
+}
+
+void FieldView::setPath(const std::vector<Pose>& path) {
+    std::lock_guard lock(mutex);
+    this->path = path;
+    baseChanged = true;
+}
+
+void FieldView::clearTrail() {
+    std::lock_guard lock(mutex);
+    trail.clear();
+    baseChanged = true;
+}
+
+void FieldView::focus() {
+    std::lock_guard lock(mutex);
+    focusing = true;
+    if (view != nullptr) rd_view_focus(view);
+}
+
+std::uint32_t FieldView::getFrames() {
+    std::lock_guard lock(mutex);
+    return frames;
+}
+
+std::uint64_t FieldView::getDirtyPixels() {
+    std::lock_guard lock(mutex);
+    return dirtyPixels;
+}
+
+std::uint32_t FieldView::getFullRedraws() {
+    std::lock_guard lock(mutex);
+    return fullRedraws;
+}
+} // namespace lemlib
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <mutex>
+#include "lemlib/clock.hpp"
+#include "lemlib/input.hpp"
+
+namespace lemlib {
+InputQueue::InputQueue(std::uint16_t buttons, std::size_t capacity)
+    : buttons(buttons),
+      capacity(std::max<std::size_t>(capacity, 1)) {}
+
+void InputQueue::push(const InputEvent& event) {
+    if (!(buttons & (1 << (event.button - pros::E_CONTROLLER_DIGITAL_L1)))) return;
+    std::lock_guard lock(mutex);
+    if (events.size() >= capacity) {
+        dropped++;
+        return;
+    }
+    events.push_back(event);
+    received++;
+    for (pros::task_t task : waiting) pros::Task(task).notify();
+}
+
+bool InputQueue::take(InputEvent& event) {
+    if (events.empty()) return false;
+    event = events.front();
+    events.pop_front();
+    const std::uint32_t latency = millis() - event.time;
+    taken++;
+    totalLatency += latency;
+    maxLatency = std::max(maxLatency, latency);
+    return true;
+}
+
+bool InputQueue::pop(InputEvent& event) {
+    std::lock_guard lock(mutex);
+    return take(event);
+}
+
+bool InputQueue::wait(InputEvent& event, std::uint32_t timeout) {
+    const std::uint32_t start = millis();
+    const pros::task_t self = static_cast<pros::task_t>(pros::Task::current());
+    bool result = false;
+    while (true) {
+        {
+            std::lock_guard lock(mutex);
+            result = take(event);
+            if (result) break;
+            if (std::find(waiting.begin(), waiting.end(), self) == waiting.end()) waiting.push_back(self);
+        }
+        const std::uint32_t elapsed = millis() - start;
+        if (timeout != TIMEOUT_MAX && elapsed >= timeout) break;
+        pros::Task::notify_take(true, timeout == TIMEOUT_MAX ? TIMEOUT_MAX : timeout - elapsed);
+    }
+    std::lock_guard lock(mutex);
+    waiting.erase(std::remove(waiting.begin(), waiting.end(), self), waiting.end());
+    return result;
+}
+
+void InputQueue::clear() {
+    std::lock_guard lock(mutex);
+    events.clear();
+}
+
+std::uint32_t InputQueue::getReceived() {
+    std::lock_guard lock(mutex);
+    return received;
+}
+
+std::uint32_t InputQueue::getDropped() {
+    std::lock_guard lock(mutex);
+    return dropped;
+}
+
+float InputQueue::getMeanLatency() {
+    std::lock_guard lock(mutex);
+    return taken == 0 ? 0 : float(totalLatency) / taken;
+}
+
+std::uint32_t InputQueue::getMaxLatency() {
+    std::lock_guard lock(mutex);
+    return maxLatency;
+}
+
+ControllerInput::ControllerInput(const char* name, pros::Controller* controller, InputSettings settings,
+                                 std::uint32_t period)
+    : Subsystem(name, period),
+      controller(controller),
+      settings(settings) {}
+
+void ControllerInput::update() {
+    // read the whole controller first, so the sample is one moment
+    std::array<bool, BUTTONS> now {};
+    for (int i = 0; i < BUTTONS; i++)
+        now[i] = controller->get_digital(pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i));
+    std::array<std::int32_t, 4> channels {};
+    for (int i = 0; i < 4; i++) channels[i] = controller->get_analog(pros::controller_analog_e_t(i));
+    const std::uint32_t time = millis();
+
+    std::vector<InputEvent> events;
+    std::vector<InputQueue*> subscribers;
+    {
+        std::lock_guard lock(mutex);
+        sampleTime = time;
+        analog = channels;
+        for (int i = 0; i < BUTTONS; i++) {
+            const auto button = pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i);
+            if (now[i] && !pressed[i]) {
+                events.push_back({button, InputEventType::PRESS, time, 0});
+                presses++;
+                if (pressedBefore[i] && time - lastPress[i] <= settings.doubleTapTime) {
+                    events.push_back({button, InputEventType::DOUBLE_TAP, time, time - lastPress[i]});
+                    // a third tap starts a new double tap instead of making another one
+                    pressedBefore[i] = false;
+                } else pressedBefore[i] = true;
+                lastPress[i] = time;
+                pressedSince[i] = time;
+                held[i] = false;
+            } else if (!now[i] && pressed[i]) {
+                events.push_back({button, InputEventType::RELEASE, time, time - pressedSince[i]});
+            } else if (now[i] && !held[i] && time - pressedSince[i] >= settings.holdTime) {
+                events.push_back({button, InputEventType::HOLD, time, time - pressedSince[i]});
+                held[i] = true;
+            }
+            pressed[i] = now[i];
+        }
+        if (events.empty()) return;
+        for (auto& queue : queues) subscribers.push_back(queue.get());
+    }
+    for (InputQueue* queue : subscribers) {
+        for (const InputEvent& event : events) queue->push(event);
+    }
+}
+
+InputQueue& ControllerInput::subscribe(std::initializer_list<pros::controller_digital_e_t> buttons,
+                                       std::size_t capacity) {
+    std::uint16_t mask = 0;
+    for (auto button : buttons) mask |= 1 << (button - pros::E_CONTROLLER_DIGITAL_L1);
+    std::lock_guard lock(mutex);
+    queues.push_back(std::unique_ptr<InputQueue>(new InputQueue(mask, capacity)));
+    return *queues.back();
+}
+
+bool ControllerInput::isPressed(pros::controller_digital_e_t button) {
+    std::lock_guard lock(mutex);
+    return pressed.at(button - pros::E_CONTROLLER_DIGITAL_L1);
+}
+
+std::uint32_t ControllerInput::getHoldTime(pros::controller_digital_e_t button) {
+    const int i = button - pros::E_CONTROLLER_DIGITAL_L1;
+    std::lock_guard lock(mutex);
+    return pressed.at(i) ? sampleTime - pressedSince[i] : 0;
+}
+
+std::int32_t ControllerInput::getAnalog(pros::controller_analog_e_t channel) {
+    std::lock_guard lock(mutex);
+    return analog.at(channel);
+}
+
+std::uint32_t ControllerInput::getPresses() {
+    std::lock_guard lock(mutex);
+    return presses;
+}
+} // namespace lemlib
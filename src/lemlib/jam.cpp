@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/clock.hpp"
+#include "lemlib/jam.hpp"
+#include "lemlib/util.hpp"
+
+namespace lemlib {
+JamDetector::JamDetector(pros::Motor* motor, MotorOutput::Writer writer, JamSettings settings,
+                         std::vector<RecoveryStep> recovery)
+    : motor(motor),
+      writer(writer),
+      settings(settings),
+      recovery(std::move(recovery)) {}
+
+bool JamDetector::update(bool detect) {
+    const std::uint32_t now = millis();
+    if (recovering) {
+        if (now - stepSince < recovery.at(step).time) {
+            writer.move(recovery.at(step).power);
+            return true;
+        }
+        writer.release();
+        recovering = false;
+        recoveredAt = now;
+    }
+    // samples from before a recovery, or from while not looking, say nothing about the motor now
+    if (!detect) {
+        count = 0;
+        return false;
+    }
+
+    window[next] = {now, float(motor->get_current_draw()), float(motor->get_torque()),
+                    float(motor->get_actual_velocity()), float(motor->get_voltage())};
+    next = (next + 1) % WINDOW;
+    count = std::min(count + 1, WINDOW);
+    if (!jammed()) return false;
+
+    const bool again = step >= 0 && now - recoveredAt < settings.escalationTime;
+    step = again ? std::min<int>(step + 1, recovery.size() - 1) : 0;
+    jams++;
+    recovering = true;
+    stepSince = now;
+    count = 0;
+    writer.move(recovery.at(step).power);
+    return true;
+}
+
+bool JamDetector::jammed() const {
+    if (count == 0) return false;
+    const Sample& newest = window[(next + WINDOW - 1) % WINDOW];
+    if (newest.voltage == 0) return false;
+    const float direction = sgn(newest.voltage);
+    // look back over the jam time, every sample on the way has to be stopped and straining against the voltage
+    for (std::size_t i = 0; i < count; i++) {
+        const Sample& sample = window[(next + WINDOW - 1 - i) % WINDOW];
+        if (sample.voltage == 0 || sgn(sample.voltage) != direction) return false;
+        if (sample.current < settings.stallCurrent || sample.torque < settings.stallTorque) return false;
+        if (std::fabs(sample.velocity) >= settings.stallVelocity) return false;
+        if (newest.time - sample.time < settings.jamTime) continue;
+        // a motor starting up strains too, but it speeds up
+        return (newest.velocity - sample.velocity) * direction <= settings.stallVelocity / 4;
+    }
+    // not enough samples yet
+    return false;
+}
+
+bool JamDetector::isRecovering() const { return recovering; }
+
+int JamDetector::getStep() const { return step; }
+
+int JamDetector::getJams() const { return jams; }
+} // namespace lemlib
@@ -1,11 +1,29 @@
+#include <cstring>
 #include "lemlib/logger/baseSink.hpp"
 
 namespace lemlib {
 BaseSink::BaseSink(std::initializer_list<std::shared_ptr<BaseSink>> sinks) { this->sinks = sinks; }
 
+BaseSink::~BaseSink() {
+    // the records left point to this sink, so they have to be sent before it is gone
+    flush();
+}
+
+void BaseSink::flush() {
+    for (const std::shared_ptr<BaseSink>& sink : sinks) sink->flush();
+    // only touch the records once this sink has some waiting, it might be destroyed after them when the program ends
+    while (waiting.load(std::memory_order_acquire) != 0) {
+        records().flush();
+        // a record another task is still pushing holds up the ones behind it, until it is written
+        if (waiting.load(std::memory_order_acquire) != 0) lemlib::delay(1);
+    }
+}
+
+std::uint32_t BaseSink::getDroppedRecords() { return records().getDropped(); }
+
 void BaseSink::setLowestLevel(Level lowestLevel) {
     if (!sinks.empty()) {
-        for (std::shared_ptr<BaseSink> sink : sinks) { sink->setLowestLevel(lowestLevel); }
+        for (const std::shared_ptr<BaseSink>& sink : sinks) { sink->setLowestLevel(lowestLevel); }
         return;
     }
 
@@ -19,4 +37,65 @@ fmt::dynamic_format_arg_store<fmt::format_context> BaseSink::getExtraFormattingA
 }
 
 void BaseSink::sendMessage(const Message& message) {}
+
+void BaseSink::formatText(fmt::string_view format, const char* args, std::size_t size, std::string& out) {
+    out.append(args, size);
+}
+
+void BaseSink::pushText(Level level, std::uint64_t time, const std::string& text) {
+    Record record {this, &formatText, {}, level, time, sizeof(Record)};
+    char data[RECORD_SIZE];
+    constexpr std::size_t room = RECORD_SIZE - sizeof(Record);
+    if (text.size() <= room) {
+        std::memcpy(data + record.size, text.data(), text.size());
+        record.size += text.size();
+    } else {
+        // end with a marker, so the message doesn't look whole
+        constexpr std::size_t kept = room - TRUNCATED_MARKER.size();
+        std::memcpy(data + record.size, text.data(), kept);
+        std::memcpy(data + record.size + kept, TRUNCATED_MARKER.data(), TRUNCATED_MARKER.size());
+        record.size = RECORD_SIZE;
+    }
+    push(record, data);
+}
+
+void BaseSink::push(const Record& record, char* data) {
+    std::memcpy(data, &record, sizeof(Record));
+    // counted first, the logger task might send it before pushToBuffer returns
+    waiting.fetch_add(1, std::memory_order_relaxed);
+    if (!records().pushToBuffer(std::string_view(data, record.size))) waiting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+Buffer& BaseSink::records() {
+    static Buffer records(processRecords, 64, RECORD_SIZE);
+    return records;
+}
+
+void BaseSink::processRecords(const std::string& records) {
+    for (std::size_t offset = 0; offset + sizeof(Record) <= records.size();) {
+        Record record;
+        std::memcpy(&record, records.data() + offset, sizeof(Record));
+        std::string text;
+        record.formatter(record.format, records.data() + offset + sizeof(Record), record.size - sizeof(Record), text);
+        record.sink->deliver(record.level, record.time, std::move(text));
+        record.sink->waiting.fetch_sub(1, std::memory_order_release);
+        offset += record.size;
+    }
+}
+
+void BaseSink::deliver(Level level, std::uint64_t time, std::string text) {
+    Message message = Message {.level = level, .time = time};
+
+    // get the arguments
+    fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
+
+    formattingArgs.push_back(fmt::arg("time", message.time / 1000));
+    formattingArgs.push_back(fmt::arg("micros", message.time));
+    formattingArgs.push_back(fmt::arg("level", message.level));
+    formattingArgs.push_back(fmt::arg("message", text));
+
+    std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
+    message.message = std::move(formattedString);
+    sendMessage(std::move(message));
+}
 } // namespace lemlib
\ No newline at end of file
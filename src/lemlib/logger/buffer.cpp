@@ -1,43 +1,117 @@
-#define FMT_HEADER_ONLY
-#include "fmt/core.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "lemlib/clock.hpp"
 #include "lemlib/logger/buffer.hpp"
-#include "lemlib/logger/message.hpp"
 
 namespace lemlib {
-Buffer::Buffer(std::function<void(const std::string&)> bufferFunc)
+/**
+ * @brief Round up to the next power of 2, so positions can be wrapped with a mask
+ */
+static std::uint32_t roundCapacity(std::uint32_t capacity) {
+    std::uint32_t rounded = 1;
+    while (rounded < capacity) rounded <<= 1;
+    return rounded;
+}
+
+Buffer::Buffer(std::function<void(const std::string&)> bufferFunc, std::uint32_t capacity, std::uint32_t slotSize,
+               OverflowPolicy policy)
     : bufferFunc(bufferFunc),
-      task([=]() { taskLoop(); }) {}
+      capacity(roundCapacity(capacity)),
+      slotSize(std::max<std::uint32_t>(slotSize, 1)),
+      sequences(new std::atomic<std::uint32_t>[this->capacity]),
+      lengths(new std::uint32_t[this->capacity]),
+      slots(new char[this->capacity * this->slotSize]),
+      policy(policy) {
+    for (std::uint32_t i = 0; i < this->capacity; i++) sequences[i].store(i, std::memory_order_relaxed);
+    output.reserve(this->capacity * this->slotSize);
+    // start the task last, it reads the ring as soon as it runs
+    task = std::make_unique<pros::Task>([this]() { taskLoop(); });
+}
 
 bool Buffer::buffersEmpty() {
-    mutex.take();
-    bool status = buffer.size() == 0;
-    mutex.give();
-    return status;
+    return popPosition.load(std::memory_order_acquire) == pushPosition.load(std::memory_order_acquire);
 }
 
 Buffer::~Buffer() {
     // make sure when the destructor is called so all
     // the messages are logged
-    while (!buffersEmpty()) { pros::delay(10); }
+    while (!buffersEmpty()) { lemlib::delay(10); }
 }
 
-void Buffer::pushToBuffer(const std::string& bufferData) {
-    mutex.take();
-    buffer.push_back(bufferData);
-    mutex.give();
+bool Buffer::pushToBuffer(std::string_view bufferData) {
+    // claim a free slot
+    std::uint32_t position = pushPosition.load(std::memory_order_relaxed);
+    while (true) {
+        const std::uint32_t sequence = sequences[position & (capacity - 1)].load(std::memory_order_acquire);
+        const std::int32_t difference = std::int32_t(sequence - position);
+        if (difference == 0) {
+            // the slot is free, claim it unless another task got there first
+            if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            // the slot still holds a message from the last time around, so the buffer is full
+            if (policy.load(std::memory_order_relaxed) == OverflowPolicy::DROP) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            lemlib::delay(1);
+            position = pushPosition.load(std::memory_order_relaxed);
+        } else {
+            // another task claimed the slot, try the next one
+            position = pushPosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    // copy the message into the slot, and hand the slot to the task
+    const std::uint32_t slot = position & (capacity - 1);
+    std::uint32_t length = bufferData.size();
+    char* data = slots.get() + slot * slotSize;
+    if (length > slotSize) {
+        truncated.fetch_add(1, std::memory_order_relaxed);
+        length = slotSize;
+        std::memcpy(data, bufferData.data(), length);
+        // keep the line ending, so the next message doesn't run into this one
+        if (bufferData.back() == '\n') data[length - 1] = '\n';
+    } else std::memcpy(data, bufferData.data(), length);
+    lengths[slot] = length;
+    sequences[slot].store(position + 1, std::memory_order_release);
+    return true;
 }
 
 void Buffer::setRate(uint32_t rate) { this->rate = rate; }
 
+void Buffer::setOverflowPolicy(OverflowPolicy policy) { this->policy = policy; }
+
+std::uint32_t Buffer::getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+std::uint32_t Buffer::getTruncated() const { return truncated.load(std::memory_order_relaxed); }
+
+void Buffer::flush() { drain(); }
+
+void Buffer::drain() {
+    std::lock_guard lock(drainMutex);
+    output.clear();
+    std::uint32_t position = popPosition.load(std::memory_order_relaxed);
+    // stop after one lap, so tasks that keep pushing can't keep the drain going forever
+    for (std::uint32_t i = 0; i < capacity; i++) {
+        const std::uint32_t slot = position & (capacity - 1);
+        // a claimed slot that isn't written yet ends the drain too, the message goes out on the next one
+        if (sequences[slot].load(std::memory_order_acquire) != position + 1) break;
+        output.append(slots.get() + slot * slotSize, lengths[slot]);
+        // free the slot for the push one lap later
+        sequences[slot].store(position + capacity, std::memory_order_release);
+        position++;
+    }
+    if (!output.empty()) bufferFunc(output);
+    // only count the messages as processed once they are, so buffersEmpty waits for the output
+    popPosition.store(position, std::memory_order_release);
+}
+
 void Buffer::taskLoop() {
     while (true) {
-        mutex.take();
-        if (buffer.size() > 0) {
-            bufferFunc(buffer.at(0));
-            buffer.pop_front();
-        }
-        mutex.give();
-        pros::delay(rate);
+        drain();
+        lemlib::delay(rate);
     }
 }
 } // namespace lemlib
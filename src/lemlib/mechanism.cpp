@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include "lemlib/clock.hpp"
+#include "lemlib/mechanism.hpp"
+#include "lemlib/util.hpp"
+
+namespace lemlib {
+Mechanism::Mechanism(const char* name, MotorOutput::Writer writer, pros::Rotation* sensor, MechanismSettings settings,
+                     std::uint32_t period)
+    : Subsystem(name, period),
+      writer(writer),
+      sensor(sensor),
+      settings(settings),
+      pid(settings.kP, settings.kI, settings.kD) {}
+
+void Mechanism::update() {
+    const float position = getPosition();
+    std::lock_guard lock(mutex);
+    if (!moving) return;
+    const float dt = getPeriod() / 1000.0f;
+    const float maxChange = settings.maxAcceleration * dt;
+
+    // step the motion profile to the next update: as fast as allowed, but never faster than it can still stop at the
+    // goal from. The arm is compared with where the profile is now, and the feedforward drives it along the step
+    const float now = reference;
+    float average = 0;
+    float acceleration = 0;
+    if (!profileDone) {
+        const float distance = goal - reference;
+        const float stopping = std::sqrt(2 * settings.maxAcceleration * std::fabs(distance));
+        const float desired = sgn(distance) * std::min(settings.maxVelocity, stopping);
+        const float next = velocity + std::clamp(desired - velocity, -maxChange, maxChange);
+        average = (velocity + next) / 2;
+        reference += average * dt;
+        acceleration = (next - velocity) / dt;
+        velocity = next;
+        // the last step overshoots the goal a little, finish there
+        if ((goal - reference) * distance <= 0 && sgn(velocity) == sgn(distance)) {
+            reference = goal;
+            velocity = 0;
+            average = 0;
+            acceleration = 0;
+            profileDone = true;
+        }
+    }
+
+    error = goal - position;
+    if (profileDone && std::fabs(error) < settings.tolerance) reached = true;
+    if (reached && !hold) {
+        output = 0;
+        writer.brake();
+        return;
+    }
+    const float gravity = settings.kG * std::cos(degToRad(position - settings.horizontal));
+    const float feedforward = settings.kV * average + settings.kA * acceleration + gravity;
+    output = std::clamp(feedforward + pid.update(now - position), -12000.0f, 12000.0f);
+    writer.moveVoltage(output);
+}
+
+void Mechanism::addSetpoint(const std::string& name, float angle, bool hold) {
+    std::lock_guard lock(mutex);
+    for (Setpoint& setpoint : setpoints) {
+        if (setpoint.name != name) continue;
+        setpoint.angle = angle;
+        setpoint.hold = hold;
+        return;
+    }
+    setpoints.push_back({name, angle, hold});
+}
+
+bool Mechanism::moveTo(const std::string& name) {
+    float angle;
+    bool hold;
+    {
+        std::lock_guard lock(mutex);
+        auto setpoint = std::find_if(setpoints.begin(), setpoints.end(),
+                                     [&](const Setpoint& setpoint) { return setpoint.name == name; });
+        if (setpoint == setpoints.end()) return false;
+        angle = setpoint->angle;
+        hold = setpoint->hold;
+    }
+    moveTo(angle, hold);
+    return true;
+}
+
+void Mechanism::moveTo(float angle, bool hold) {
+    const float position = getPosition();
+    std::lock_guard lock(mutex);
+    // continue from the profile during a move. Otherwise start from the arm, which may have fallen away since
+    if (!moving || profileDone) {
+        reference = position;
+        velocity = 0;
+        pid.reset();
+    }
+    moving = true;
+    goal = angle;
+    this->hold = hold;
+    profileDone = false;
+    reached = false;
+}
+
+bool Mechanism::isReached() {
+    std::lock_guard lock(mutex);
+    return reached;
+}
+
+bool Mechanism::waitUntilReached(std::uint32_t timeout) {
+    const std::uint32_t start = millis();
+    while (!isReached()) {
+        if (millis() - start >= timeout) return false;
+        delay(10);
+    }
+    return true;
+}
+
+float Mechanism::getPosition() { return sensor->get_position() / 100.0f; }
+
+float Mechanism::getTarget() {
+    std::lock_guard lock(mutex);
+    return goal;
+}
+
+float Mechanism::getError() {
+    std::lock_guard lock(mutex);
+    return error;
+}
+
+float Mechanism::getOutput() {
+    std::lock_guard lock(mutex);
+    return output;
+}
+} // namespace lemlib
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/clock.hpp"
+#include "lemlib/mpc.hpp"
+
+namespace lemlib {
+// distance from the target at which the heading cost is split evenly between the carrot and the target heading, in
+// inches. Matches the settling distance of Chassis::moveToPose
+constexpr float SETTLE_DISTANCE = 7.5;
+// squared heading error, in radians, below which the heading cost becomes quadratic
+constexpr float HEADING_SMOOTHING = 0.01;
+// weight of the last step, which stands in for the rest of the motion beyond the horizon
+constexpr float TERMINAL_WEIGHT = 3;
+// weight of going slower than the minimum speed, per (inch per second) squared
+constexpr float MIN_SPEED_WEIGHT = 0.05;
+// weight of sideways acceleration beyond the limit, per (inch per second squared) squared
+constexpr float SLIP_WEIGHT = 0.001;
+// perturbation used to estimate the gradient, in inches per second
+constexpr float GRADIENT_STEP = 0.05;
+// largest and initial gradient step, in inches per second
+constexpr float MAX_STEP_SIZE = 32;
+constexpr float INITIAL_STEP_SIZE = 8;
+// number of times a gradient step is halved before the iteration gives up
+constexpr int LINE_SEARCH_STEPS = 6;
+
+MPC::MPC(const MPCSettings& settings, float trackWidth)
+    : settings(settings),
+      trackWidth(trackWidth),
+      plan(2 * settings.steps, 0),
+      previous(2 * settings.steps, 0),
+      gradient(2 * settings.steps, 0),
+      states(settings.steps + 1),
+      inputs(2 * settings.steps + 2, 0),
+      costs(settings.steps + 1, 0),
+      stepSize(INITIAL_STEP_SIZE) {}
+
+void MPC::reset(float left, float right) {
+    this->left = left;
+    this->right = right;
+    started = false;
+}
+
+float MPC::stepCost(float x, float y, float cosTheta, float sinTheta, float speed, float turnRate) const {
+    const float dx = target.x - x;
+    const float dy = target.y - y;
+    const float distance = std::sqrt(dx * dx + dy * dy);
+
+    // heading error towards the carrot point, 0 when facing it and 2 when facing away
+    const float carrotX = dx - targetCos * lead * distance;
+    const float carrotY = dy - targetSin * lead * distance;
+    const float carrotDistance = std::sqrt(carrotX * carrotX + carrotY * carrotY);
+    const float carrotError =
+        carrotDistance < 1e-3 ? 1 - cosTheta * targetCos - sinTheta * targetSin
+                              : 1 - (cosTheta * carrotX + sinTheta * carrotY) / carrotDistance;
+    // heading error relative to the target heading
+    const float targetError = 1 - cosTheta * targetCos - sinTheta * targetSin;
+    // blend from the carrot to the target heading as the robot closes in
+    const float settle = 1 / (1 + (distance / SETTLE_DISTANCE) * (distance / SETTLE_DISTANCE));
+    const float headingError = (1 - settle) * carrotError + settle * targetError;
+
+    // with a minimum speed the target is a point to pass through, so only the distance left along the target heading
+    // and the distance off to the side count
+    float remaining = distance;
+    if (minSpeed > 0) {
+        const float along = std::max(0.0f, dx * targetCos + dy * targetSin);
+        const float side = dx * targetSin - dy * targetCos;
+        remaining = std::sqrt(along * along + side * side);
+    }
+    // both terms are smoothed absolute values: linear far away, quadratic close in. 2 - 2cos is the squared chord
+    // between the headings, which is close to the squared angle
+    float cost = std::sqrt(remaining * remaining + 1) - 1;
+    cost += settings.headingWeight * (std::sqrt(2 * headingError + HEADING_SMOOTHING) - std::sqrt(HEADING_SMOOTHING));
+
+    // keep above the minimum speed, and don't back away from the target until settling
+    float slowest = minSpeed;
+    if (distance < SETTLE_DISTANCE && minSpeed == 0) slowest = -INFINITY;
+    if (speed < slowest) cost += MIN_SPEED_WEIGHT * (slowest - speed) * (slowest - speed);
+
+    // sideways acceleration is speed times turn rate
+    const float slip = std::fabs(speed * turnRate) - settings.maxLateralAcceleration;
+    if (slip > 0) cost += SLIP_WEIGHT * slip * slip;
+    return cost;
+}
+
+float MPC::rollout(int from, bool record) {
+    const int steps = settings.steps;
+    const float dt = settings.stepTime / 1000.0f;
+    const float maxChange = settings.maxAcceleration * dt;
+    auto [x, y, theta] = states[from];
+    float cost = costs[from];
+    float prevLeft = inputs[2 * from];
+    float prevRight = inputs[2 * from + 1];
+    for (int i = from; i < steps; i++) {
+        // apply the speed and acceleration limits
+        const float left = std::clamp(std::clamp(plan[2 * i], prevLeft - maxChange, prevLeft + maxChange), -maxSpeed,
+                                      maxSpeed);
+        const float right = std::clamp(std::clamp(plan[2 * i + 1], prevRight - maxChange, prevRight + maxChange),
+                                       -maxSpeed, maxSpeed);
+        const float speed = (left + right) / 2;
+        const float turnRate = (right - left) / trackWidth;
+        // advance along the arc, using the heading halfway through the step
+        const float midTheta = theta + turnRate * dt / 2;
+        const float cosTheta = std::cos(midTheta);
+        const float sinTheta = std::sin(midTheta);
+        x += speed * cosTheta * dt;
+        y += speed * sinTheta * dt;
+        theta += turnRate * dt;
+        prevLeft = left;
+        prevRight = right;
+        if (record) {
+            states[i + 1] = {x, y, theta};
+            inputs[2 * i + 2] = left;
+            inputs[2 * i + 3] = right;
+        }
+        const float stepCost = this->stepCost(x, y, cosTheta, sinTheta, speed, turnRate);
+        cost += i == steps - 1 ? TERMINAL_WEIGHT * stepCost : stepCost;
+        if (record) costs[i + 1] = cost;
+        evaluations++;
+    }
+    return cost;
+}
+
+std::array<float, 2> MPC::update(Pose pose, Pose target, float lead, float maxSpeed, float minSpeed,
+                                 bool forwards) {
+    const int steps = settings.steps;
+    // plan backwards motion as a robot facing the other way, whose left and right sides are swapped
+    if (!forwards) pose.theta += M_PI;
+    float left = forwards ? this->left : -this->right;
+    float right = forwards ? this->right : -this->left;
+    // the plan is much coarser than the motion loop, so the last plan is still a good place to start from
+    if (!started || forwards != this->forwards) {
+        for (int i = 0; i < steps; i++) {
+            plan[2 * i] = left;
+            plan[2 * i + 1] = right;
+        }
+        stepSize = INITIAL_STEP_SIZE;
+    }
+    // time since the last command, used to limit how fast the command changes
+    const std::uint32_t now = lemlib::millis();
+    const float elapsed = started ? std::clamp<float>(now - lastUpdate, 1, settings.stepTime) : 10;
+    started = true;
+    lastUpdate = now;
+    this->forwards = forwards;
+    this->target = target;
+    targetCos = std::cos(target.theta);
+    targetSin = std::sin(target.theta);
+    this->lead = lead;
+    this->maxSpeed = maxSpeed;
+    this->minSpeed = minSpeed;
+    states[0] = {pose.x, pose.y, pose.theta};
+    inputs[0] = left;
+    inputs[1] = right;
+    costs[0] = 0;
+    evaluations = 0;
+
+    float cost = rollout(0, true);
+    for (int iteration = 0; iteration < settings.iterations; iteration++) {
+        // estimate the gradient with central differences. Changing a step only affects the steps after it, so each
+        // estimate only simulates from the changed step onwards
+        float largest = 0;
+        for (int i = 0; i < 2 * steps; i++) {
+            const float original = plan[i];
+            plan[i] = original + GRADIENT_STEP;
+            const float higher = rollout(i / 2, false);
+            plan[i] = original - GRADIENT_STEP;
+            const float lower = rollout(i / 2, false);
+            plan[i] = original;
+            gradient[i] = (higher - lower) / (2 * GRADIENT_STEP);
+            largest = std::max(largest, std::fabs(gradient[i]));
+        }
+        if (largest == 0) break;
+
+        // take a normalized step downhill, halving it until the cost decreases
+        previous = plan;
+        bool improved = false;
+        for (int attempt = 0; attempt < LINE_SEARCH_STEPS && !improved; attempt++) {
+            for (int i = 0; i < 2 * steps; i++) {
+                plan[i] = std::clamp(previous[i] - stepSize * gradient[i] / largest, -maxSpeed, maxSpeed);
+            }
+            const float newCost = rollout(0, false);
+            if (newCost < cost) {
+                cost = newCost;
+                improved = true;
+                stepSize = std::min(stepSize * 1.5f, MAX_STEP_SIZE);
+            } else stepSize /= 2;
+        }
+        if (!improved) {
+            plan = previous;
+            stepSize = INITIAL_STEP_SIZE;
+            break;
+        }
+        rollout(0, true);
+    }
+
+    // head towards the first step of the plan, as fast as the acceleration limit allows
+    const float maxChange = settings.maxAcceleration * elapsed / 1000;
+    left = std::clamp(inputs[2], left - maxChange, left + maxChange);
+    right = std::clamp(inputs[3], right - maxChange, right + maxChange);
+    this->left = forwards ? left : -right;
+    this->right = forwards ? right : -left;
+    return {this->left, this->right};
+}
+
+int MPC::getEvaluations() const { return evaluations; }
+} // namespace lemlib
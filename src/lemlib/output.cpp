@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <mutex>
+#include "lemlib/clock.hpp"
+#include "lemlib/output.hpp"
+
+namespace lemlib {
+MotorOutput::Writer::Writer(MotorOutput* output, int id)
+    : output(output),
+      id(id) {}
+
+void MotorOutput::Writer::move(int power) {
+    moveVoltage(std::clamp(power, -127, 127) * 12000 / 127);
+}
+
+void MotorOutput::Writer::moveVoltage(int voltage) {
+    output->request(id, {MotorCommand::Mode::VOLTAGE, std::clamp(voltage, -12000, 12000)}, true);
+}
+
+void MotorOutput::Writer::moveVelocity(int velocity) {
+    output->request(id, {MotorCommand::Mode::VELOCITY, velocity}, true);
+}
+
+void MotorOutput::Writer::brake() { output->request(id, {MotorCommand::Mode::BRAKE, 0}, true); }
+
+void MotorOutput::Writer::release() { output->request(id, {}, false); }
+
+bool MotorOutput::Writer::owns() const {
+    std::lock_guard lock(output->mutex);
+    return output->findOwner() == id;
+}
+
+MotorOutput::MotorOutput(pros::AbstractMotor* motor, int keepalive)
+    : motor(motor),
+      keepalive(keepalive) {}
+
+MotorOutput::Writer MotorOutput::writer(const std::string& name, int priority) {
+    std::lock_guard lock(mutex);
+    requests.push_back({name, priority});
+    return Writer(this, requests.size() - 1);
+}
+
+int MotorOutput::findOwner() const {
+    int owner = -1;
+    for (int i = 0; i < int(requests.size()); i++) {
+        const Request& r = requests[i];
+        if (!r.active) continue;
+        if (owner == -1 || r.priority > requests[owner].priority ||
+            (r.priority == requests[owner].priority && r.sequence > requests[owner].sequence))
+            owner = i;
+    }
+    return owner;
+}
+
+void MotorOutput::request(int id, const MotorCommand& command, bool active) {
+    std::lock_guard lock(mutex);
+    Request& r = requests[id];
+    r.sequence = ++sequence;
+    r.active = active;
+    r.command = command;
+    requestCount++;
+
+    const int owner = findOwner();
+    const MotorCommand target = owner == -1 ? MotorCommand() : requests[owner].command;
+    const std::uint32_t now = lemlib::millis();
+    if (hasWritten && target == written && now - lastWrite < keepalive) return;
+    switch (target.mode) {
+        case MotorCommand::Mode::BRAKE: motor->brake(); break;
+        case MotorCommand::Mode::VOLTAGE: motor->move_voltage(target.value); break;
+        case MotorCommand::Mode::VELOCITY: motor->move_velocity(target.value); break;
+    }
+    written = target;
+    hasWritten = true;
+    lastWrite = now;
+    writes++;
+}
+
+std::string MotorOutput::getOwner() {
+    std::lock_guard lock(mutex);
+    const int owner = findOwner();
+    return owner == -1 ? "" : requests[owner].name;
+}
+
+std::uint32_t MotorOutput::getWrites() {
+    std::lock_guard lock(mutex);
+    return writes;
+}
+
+std::uint32_t MotorOutput::getRequests() {
+    std::lock_guard lock(mutex);
+    return requestCount;
+}
+} // namespace lemlib
@@ -20,11 +20,17 @@ float PID::update(const float error) {
     prevError = error;
 
     // calculate output
-    return error * kP + integral * kI + derivative * kD;
+    prevOutput = error * kP + integral * kI + derivative * kD;
+    return prevOutput;
 }
 
 void PID::reset() {
     integral = 0;
     prevError = 0;
+    prevOutput = 0;
 }
+
+float PID::getError() const { return prevError; }
+
+float PID::getOutput() const { return prevOutput; }
 } // namespace lemlib
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <mutex>
+#include "lemlib/clock.hpp"
+#include "lemlib/poseHistory.hpp"
+
+namespace lemlib {
+// faster than any robot drives, in inches per second. A pose further from the last sample than this is a jump
+constexpr float MAX_SPEED = 150;
+
+PoseHistory::PoseHistory(const char* name, std::function<Pose()> sample, float spacing, std::size_t capacity,
+                         std::uint32_t period)
+    : Subsystem(name, period),
+      sample(std::move(sample)),
+      spacing(spacing),
+      capacity(std::max<std::size_t>(capacity, 1)) {
+    entries.reserve(this->capacity);
+}
+
+void PoseHistory::update() {
+    const Pose pose = sample();
+    const std::uint32_t now = millis();
+    std::lock_guard lock(mutex);
+    const bool jump = started && pose.distance(latest) > MAX_SPEED * (now - latestTime) / 1000.0f + spacing;
+    const bool moved = sequence == 0 || pose.distance(entries[(sequence - 1) % capacity].pose) >= spacing;
+    latest = pose;
+    latestTime = now;
+    started = true;
+    samples++;
+    if (!jump && !moved) return;
+    const Entry entry = {pose, jump || sequence == 0};
+    if (entries.size() < capacity) entries.push_back(entry);
+    else entries[sequence % capacity] = entry;
+    sequence++;
+}
+
+Pose PoseHistory::getLatest() {
+    std::lock_guard lock(mutex);
+    return latest;
+}
+
+std::uint32_t PoseHistory::getSequence() {
+    std::lock_guard lock(mutex);
+    return sequence;
+}
+
+std::uint32_t PoseHistory::getSince(std::uint32_t sequence, std::vector<Entry>& entries) {
+    std::lock_guard lock(mutex);
+    // poses older than the capacity were overwritten. The trail starts again after the gap
+    const bool skipped = this->sequence - sequence > capacity;
+    std::uint32_t next = skipped ? this->sequence - capacity : sequence;
+    for (; next < this->sequence; next++) {
+        entries.push_back(this->entries[next % capacity]);
+        if (skipped && next == this->sequence - capacity) entries.back().jump = true;
+    }
+    return this->sequence;
+}
+
+std::uint32_t PoseHistory::getSamples() {
+    std::lock_guard lock(mutex);
+    return samples;
+}
+} // namespace lemlib
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/profile.hpp"
+
+namespace lemlib {
+void Histogram::add(std::uint32_t duration) {
+    const int bucket = std::min<int>(std::bit_width(duration), BUCKETS - 1);
+    buckets[bucket]++;
+    count++;
+    total += duration;
+    if (duration > max) max = duration;
+}
+
+float Histogram::mean() const { return count == 0 ? 0 : float(total) / count; }
+
+std::uint32_t Histogram::percentile(float percentile) const {
+    if (count == 0) return 0;
+    const std::uint32_t target = std::max<std::uint32_t>(1, std::ceil(count * std::clamp(percentile, 0.0f, 100.0f) / 100));
+    std::uint32_t seen = 0;
+    for (int i = 0; i < BUCKETS - 1; i++) {
+        seen += buckets[i];
+        if (seen >= target) return std::min<std::uint32_t>(i == 0 ? 0 : (1u << i) - 1, max);
+    }
+    return max;
+}
+
+// the list of profiles. Locals, so profiles constructed as globals in other files can use them
+static pros::Mutex& profilesMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
+
+static LoopProfile*& profiles() {
+    static LoopProfile* head = nullptr;
+    return head;
+}
+
+LoopProfile::LoopProfile(const char* name)
+    : name(name) {
+    std::lock_guard lock(profilesMutex());
+    next = profiles();
+    profiles() = this;
+}
+
+LoopProfile::~LoopProfile() {
+    std::lock_guard lock(profilesMutex());
+    for (LoopProfile** profile = &profiles(); *profile != nullptr; profile = &(*profile)->next) {
+        if (*profile == this) {
+            *profile = next;
+            break;
+        }
+    }
+}
+
+void LoopProfile::start() {
+    const std::uint64_t now = micros();
+    if (sleeping) lateness.add(now > wakeTime ? now - wakeTime : 0);
+    sleeping = false;
+    started = true;
+    startTime = now;
+}
+
+void LoopProfile::start(std::uint64_t due) {
+    wakeTime = due;
+    sleeping = true;
+    start();
+}
+
+void LoopProfile::end() {
+    if (started) execution.add(micros() - startTime);
+    started = false;
+    sleeping = false;
+}
+
+void LoopProfile::delay(std::uint32_t milliseconds) {
+    Clock& clock = getClock();
+    const std::uint64_t now = clock.micros();
+    if (started) execution.add(now - startTime);
+    started = false;
+    sleeping = true;
+    wakeTime = now + milliseconds * 1000ull;
+    clock.sleepUntil(wakeTime);
+}
+
+void LoopProfile::delayUntil(std::uint64_t& previous, std::uint64_t period) {
+    end();
+    previous += period;
+    sleeping = true;
+    wakeTime = previous;
+    getClock().sleepUntil(previous);
+}
+
+void LoopProfile::reset() {
+    execution = Histogram();
+    lateness = Histogram();
+}
+
+const char* LoopProfile::getName() const { return name; }
+
+const Histogram& LoopProfile::getExecution() const { return execution; }
+
+const Histogram& LoopProfile::getLateness() const { return lateness; }
+
+LoopProfile* LoopProfile::find(const char* name) {
+    std::lock_guard lock(profilesMutex());
+    for (LoopProfile* profile = profiles(); profile != nullptr; profile = profile->next) {
+        if (std::strcmp(profile->name, name) == 0) return profile;
+    }
+    return nullptr;
+}
+
+void LoopProfile::forEach(const std::function<void(LoopProfile& profile)>& function) {
+    std::lock_guard lock(profilesMutex());
+    for (LoopProfile* profile = profiles(); profile != nullptr; profile = profile->next) function(*profile);
+}
+} // namespace lemlib
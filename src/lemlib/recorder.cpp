@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include "lemlib/recorder.hpp"
+
+namespace lemlib {
+FlightRecorder::FlightRecorder(const std::string& directory, std::uint32_t blockSize)
+    : directory(directory),
+      blockSize(std::max<std::uint32_t>(blockSize, TELEMETRY_OVERHEAD + TELEMETRY_MAX_PAYLOAD)),
+      blocks(new char[2 * this->blockSize]),
+      task([this]() { taskLoop(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "flight recorder") {}
+
+void FlightRecorder::start(const std::string& name) {
+    std::lock_guard lock(mutex);
+    recording = true;
+    nextName = name;
+    requests++;
+    if (!switching) markSwitch();
+    task.notify();
+}
+
+void FlightRecorder::stop() {
+    std::lock_guard lock(mutex);
+    recording = false;
+    nextName.clear();
+    requests++;
+    if (!switching) markSwitch();
+    task.notify();
+}
+
+bool FlightRecorder::write(std::string_view data) {
+    if (data.size() > blockSize) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::lock_guard lock(mutex);
+    if (!recording) return false;
+    // the record fills the active block, so it needs the other one too. While switching files the task still writes
+    // the end of the last file from the active block, so it can't be sealed until the new file is open
+    if (data.size() >= blockSize - fill && (sealedEnd != 0 || switching)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // records run over from one block into the next, so every block but the last of a file is full
+    const std::uint32_t first = std::min<std::uint32_t>(data.size(), blockSize - fill);
+    std::memcpy(blocks.get() + active * blockSize + fill, data.data(), first);
+    fill += first;
+    if (fill == blockSize) {
+        seal();
+        task.notify();
+        std::memcpy(blocks.get() + active * blockSize, data.data() + first, data.size() - first);
+        fill = data.size() - first;
+    }
+    return true;
+}
+
+bool FlightRecorder::write(const TelemetryFrame& frame) {
+    char data[TELEMETRY_OVERHEAD + TELEMETRY_MAX_PAYLOAD];
+    const std::size_t length =
+        encodeTelemetry(reinterpret_cast<std::uint8_t*>(data), frame.channel, frame.time, frame.payload, frame.size);
+    if (length == 0) return false;
+    return write(std::string_view(data, length));
+}
+
+std::uint32_t FlightRecorder::getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+std::uint32_t FlightRecorder::getWritten() const { return written.load(std::memory_order_relaxed); }
+
+std::uint32_t FlightRecorder::getFailed() const { return failed.load(std::memory_order_relaxed); }
+
+void FlightRecorder::seal() {
+    sealedBegin = skip;
+    sealedEnd = fill;
+    active ^= 1;
+    fill = 0;
+    skip = 0;
+}
+
+void FlightRecorder::markSwitch() {
+    switching = true;
+    if (sealedEnd == 0) {
+        // the last file ends with the active block
+        if (fill > skip) seal();
+        boundary = skip;
+    } else {
+        // the last file ends with the block the task has, and then part of the active block
+        boundary = fill;
+    }
+}
+
+void FlightRecorder::writeBlock(const char* data, std::uint32_t size) {
+    if (file != nullptr && std::fwrite(data, 1, size, file) == size) {
+        written.fetch_add(size, std::memory_order_relaxed);
+    } else failed.fetch_add(size, std::memory_order_relaxed);
+}
+
+void FlightRecorder::rotate(const std::string& name) {
+    if (file != nullptr) std::fclose(file);
+    file = nullptr;
+    if (name.empty()) return;
+    // don't overwrite the files of earlier runs
+    std::string path;
+    for (int i = 0; i < 1000; i++) {
+        path = directory + "/" + name + "_" + std::to_string(i) + ".bin";
+        std::FILE* existing = std::fopen(path.c_str(), "rb");
+        if (existing == nullptr) break;
+        std::fclose(existing);
+    }
+    file = std::fopen(path.c_str(), "wb");
+    // blocks go straight to the card, without being copied into another buffer first
+    if (file != nullptr) std::setvbuf(file, nullptr, _IONBF, 0);
+}
+
+void FlightRecorder::taskLoop() {
+    while (true) {
+        pros::Task::notify_take(true, TIMEOUT_MAX);
+        while (true) {
+            mutex.take();
+            if (sealedEnd == 0 && !switching) {
+                mutex.give();
+                break;
+            }
+            const char* data = blocks.get() + (active ^ 1) * blockSize;
+            const std::uint32_t begin = sealedBegin;
+            const std::uint32_t end = sealedEnd;
+            // when switching files, the end of the last one can be in the active block too. Producers can't seal
+            // a block until the switch is done, so it stays put, and nothing is sealed behind the task's back
+            const bool switchFiles = switching;
+            const char* current = blocks.get() + active * blockSize;
+            const std::uint32_t lastBegin = skip;
+            const std::uint32_t lastEnd = boundary;
+            const std::string name = nextName;
+            const std::uint32_t request = requests;
+            mutex.give();
+
+            if (end > begin) writeBlock(data + begin, end - begin);
+            if (switchFiles) {
+                if (lastEnd > lastBegin) writeBlock(current + lastBegin, lastEnd - lastBegin);
+                rotate(name);
+            }
+
+            mutex.take();
+            sealedBegin = 0;
+            sealedEnd = 0;
+            if (switchFiles) {
+                if (lastEnd > lastBegin) skip = lastEnd;
+                // start() or stop() was called again while switching, switch again from here
+                if (requests != request) markSwitch();
+                else switching = false;
+            }
+            mutex.give();
+        }
+    }
+}
+} // namespace lemlib
@@ -0,0 +1,40 @@
+#include <algorithm>
+#include <mutex>
+#include "lemlib/clock.hpp"
+#include "lemlib/state.hpp"
+
+namespace lemlib {
+std::uint32_t StateBase::getSequence() const { return sequence.load(); }
+
+std::uint32_t StateBase::waitForChange(std::uint32_t sequence, std::uint32_t timeout) {
+    waitFor([&] { return getSequence() != sequence; }, timeout);
+    return getSequence();
+}
+
+void StateBase::changed() {
+    sequence.fetch_add(1);
+    std::lock_guard lock(mutex);
+    for (pros::task_t task : waiting) pros::Task(task).notify();
+}
+
+bool StateBase::waitFor(const std::function<bool()>& done, std::uint32_t timeout) {
+    const std::uint32_t start = millis();
+    const pros::task_t self = static_cast<pros::task_t>(pros::Task::current());
+    bool result = false;
+    while (true) {
+        // wait in the list before checking, so a change between the check and sleeping still wakes the task
+        {
+            std::lock_guard lock(mutex);
+            if (std::find(waiting.begin(), waiting.end(), self) == waiting.end()) waiting.push_back(self);
+        }
+        result = done();
+        if (result) break;
+        const std::uint32_t elapsed = millis() - start;
+        if (timeout != TIMEOUT_MAX && elapsed >= timeout) break;
+        pros::Task::notify_take(true, timeout == TIMEOUT_MAX ? TIMEOUT_MAX : timeout - elapsed);
+    }
+    std::lock_guard lock(mutex);
+    waiting.erase(std::remove(waiting.begin(), waiting.end(), self), waiting.end());
+    return result;
+}
+} // namespace lemlib
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <mutex>
+#include "lemlib/clock.hpp"
+#include "lemlib/subsystem.hpp"
+
+namespace lemlib {
+Subsystem::Subsystem(const char* name, std::uint32_t period, bool enabled)
+    : period(std::max<std::uint32_t>(period, 1)),
+      enabled(enabled),
+      profile(name) {}
+
+void Subsystem::setEnabled(bool enabled) { this->enabled.store(enabled, std::memory_order_relaxed); }
+
+bool Subsystem::isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+const char* Subsystem::getName() const { return profile.getName(); }
+
+std::uint32_t Subsystem::getPeriod() const { return period; }
+
+const LoopProfile& Subsystem::getProfile() const { return profile; }
+
+SubsystemScheduler::SubsystemScheduler(std::uint32_t period, std::uint32_t priority)
+    : period(std::max<std::uint32_t>(period, 1)),
+      task([this]() { taskLoop(); }, priority, TASK_STACK_DEPTH_DEFAULT, "subsystems") {}
+
+void SubsystemScheduler::add(Subsystem& subsystem) {
+    std::lock_guard lock(mutex);
+    subsystems.push_back(&subsystem);
+}
+
+std::uint32_t SubsystemScheduler::getOverruns() const { return overruns.load(std::memory_order_relaxed); }
+
+void SubsystemScheduler::taskLoop() {
+    std::uint64_t wake = micros();
+    while (true) {
+        {
+            std::lock_guard lock(mutex);
+            for (Subsystem* subsystem : subsystems) {
+                const std::uint32_t decimation = std::max<std::uint32_t>(subsystem->period / period, 1);
+                if (ticks % decimation != 0 || !subsystem->isEnabled()) continue;
+                subsystem->profile.start(wake);
+                subsystem->update();
+                subsystem->profile.end();
+            }
+            ticks++;
+        }
+        if (micros() > wake + period * 1000) overruns.fetch_add(1, std::memory_order_relaxed);
+        delayUntil(wake, period * 1000);
+    }
+}
+} // namespace lemlib
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+#include "lemlib/clock.hpp"
+#include "lemlib/telemetry.hpp"
+#include "lemlib/logger/stdout.hpp"
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+std::uint16_t crc16(const std::uint8_t* data, std::size_t size, std::uint16_t crc) {
+    for (std::size_t i = 0; i < size; i++) {
+        crc ^= std::uint16_t(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++) crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+std::size_t encodeTelemetry(std::uint8_t* frame, std::uint8_t channel, std::uint32_t time, const void* payload,
+                            std::size_t size) {
+    if (size > TELEMETRY_MAX_PAYLOAD) return 0;
+    frame[0] = TELEMETRY_SYNC[0];
+    frame[1] = TELEMETRY_SYNC[1];
+    frame[2] = channel;
+    frame[3] = size;
+    for (int i = 0; i < 4; i++) frame[4 + i] = time >> (8 * i);
+    std::memcpy(frame + 8, payload, size);
+    const std::uint16_t crc = crc16(frame + 2, 6 + size);
+    frame[8 + size] = crc;
+    frame[9 + size] = crc >> 8;
+    return TELEMETRY_OVERHEAD + size;
+}
+
+bool sendTelemetryFrame(std::uint8_t channel, const void* payload, std::size_t size) {
+    return sendTelemetryFrame({channel, lemlib::millis(), static_cast<const std::uint8_t*>(payload), size});
+}
+
+bool sendTelemetryFrame(const TelemetryFrame& frame) {
+    std::uint8_t data[TELEMETRY_OVERHEAD + TELEMETRY_MAX_PAYLOAD];
+    const std::size_t length = encodeTelemetry(data, frame.channel, frame.time, frame.payload, frame.size);
+    if (length == 0) return false;
+    return bufferedStdout().pushToBuffer(std::string_view(reinterpret_cast<const char*>(data), length));
+}
+
+// time between schema frames, in milliseconds
+constexpr std::uint32_t SCHEMA_PERIOD = 2000;
+
+TelemetryRegistry::TelemetryRegistry(std::uint32_t period)
+    : period(std::max<std::uint32_t>(period, 1)),
+      task([this]() { taskLoop(); }) {}
+
+void TelemetryRegistry::addChannel(std::uint8_t id, const std::string& name, const std::vector<std::string>& fields,
+                                   const std::string& types, std::uint32_t period,
+                                   std::function<std::size_t(std::uint8_t* payload)> sample) {
+    std::lock_guard lock(mutex);
+    channels.push_back({id, name, types, fields, period, true, std::move(sample)});
+}
+
+TelemetryRegistry::Channel* TelemetryRegistry::find(const std::string& name) {
+    for (Channel& channel : channels) {
+        if (channel.name == name) return &channel;
+    }
+    return nullptr;
+}
+
+bool TelemetryRegistry::subscribe(const std::string& name, Consumer consumer, std::uint32_t decimation) {
+    std::lock_guard lock(mutex);
+    Channel* channel = find(name);
+    if (channel == nullptr) return false;
+    describe(*channel, consumer, lemlib::millis());
+    channel->subscriptions.push_back({std::move(consumer), std::max<std::uint32_t>(decimation, 1)});
+    return true;
+}
+
+bool TelemetryRegistry::setEnabled(const std::string& name, bool enabled) {
+    std::lock_guard lock(mutex);
+    Channel* channel = find(name);
+    if (channel == nullptr) return false;
+    channel->enabled = enabled;
+    return true;
+}
+
+bool TelemetryRegistry::setPeriod(const std::string& name, std::uint32_t period) {
+    std::lock_guard lock(mutex);
+    Channel* channel = find(name);
+    if (channel == nullptr) return false;
+    channel->period = period;
+    return true;
+}
+
+std::uint32_t TelemetryRegistry::getSamples(const std::string& name) {
+    std::lock_guard lock(mutex);
+    Channel* channel = find(name);
+    return channel == nullptr ? 0 : channel->samples;
+}
+
+void TelemetryRegistry::describe(const Channel& channel, const Consumer& consumer, std::uint32_t time) {
+    std::uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    std::string text = channel.name + ":";
+    for (std::size_t i = 0; i < channel.fields.size(); i++) text += (i ? "," : "") + channel.fields[i];
+    payload[0] = channel.id;
+    payload[1] = channel.types.size();
+    std::size_t size = 2;
+    std::memcpy(payload + size, channel.types.data(), channel.types.size());
+    size += channel.types.size();
+    // long names are cut off, the decoder falls back to numbered fields
+    const std::size_t length = std::min(text.size(), TELEMETRY_MAX_PAYLOAD - size);
+    std::memcpy(payload + size, text.data(), length);
+    size += length;
+    consumer({TELEMETRY_SCHEMA_CHANNEL, time, payload, size});
+}
+
+void TelemetryRegistry::taskLoop() {
+    std::uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    std::uint64_t wake = micros();
+    while (true) {
+        const std::uint32_t now = wake / 1000;
+        {
+            std::lock_guard lock(mutex);
+            // the schema frames go out one channel per tick, so they don't all land in the same drain of the output
+            if (now - lastSchema >= SCHEMA_PERIOD) {
+                lastSchema = now;
+                nextSchema = 0;
+            }
+            for (; nextSchema < channels.size(); nextSchema++) {
+                const Channel& channel = channels[nextSchema];
+                if (!channel.enabled || channel.subscriptions.empty()) continue;
+                for (const Subscription& subscription : channel.subscriptions)
+                    describe(channel, subscription.consumer, now);
+                nextSchema++;
+                break;
+            }
+            for (std::size_t i = 0; i < channels.size(); i++) {
+                Channel& channel = channels[i];
+                // disabled channels and channels nobody listens to cost nothing
+                if (!channel.enabled || channel.subscriptions.empty()) continue;
+                // channels of the same period are sampled on different ticks, for the same reason
+                const std::uint32_t decimation = std::max<std::uint32_t>(channel.period / period, 1);
+                if ((ticks + i) % decimation != 0) continue;
+                const TelemetryFrame frame {channel.id, now, payload, channel.sample(payload)};
+                for (const Subscription& subscription : channel.subscriptions) {
+                    if (channel.samples % subscription.decimation == 0) subscription.consumer(frame);
+                }
+                channel.samples++;
+            }
+            ticks++;
+        }
+        delayUntil(wake, period * 1000);
+    }
+}
+} // namespace lemlib
@@ -1,46 +1,46 @@
-#include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
 #include "lemlib/timer.hpp"
 
 using namespace lemlib;
 
 Timer::Timer(uint32_t time)
     : period(time) {
-    lastTime = pros::millis();
+    lastTime = lemlib::micros();
 }
 
 uint32_t Timer::getTimeSet() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint64_t time = lemlib::micros(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update if paused
     lastTime = time; // update last time
     return period;
 }
 
 uint32_t Timer::getTimeLeft() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint64_t time = lemlib::micros(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update if paused
     lastTime = time; // update last time
-    const int delta = period - timeWaited; // calculate how much time is left
-    return (delta > 0) ? delta : 0; // return 0 if timer is done
+    const int64_t delta = int64_t(period) * 1000 - int64_t(timeWaited); // calculate how much time is left, in microseconds
+    return (delta > 0) ? (delta + 999) / 1000 : 0; // return 0 if timer is done
 }
 
 uint32_t Timer::getTimePassed() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint64_t time = lemlib::micros(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update if paused
     lastTime = time; // update last time;
-    return timeWaited;
+    return timeWaited / 1000;
 }
 
 bool Timer::isDone() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint64_t time = lemlib::micros(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update if paused
     lastTime = time; // update last time
-    const int delta = period - timeWaited; // calculate how much time is left
-    return delta <= 0;
+    return timeWaited >= period * 1000ull;
 }
 
 bool Timer::isPaused() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint64_t time = lemlib::micros(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time, so the next call doesn't count this time again
     return paused;
 }
 
@@ -51,20 +51,20 @@ void Timer::set(uint32_t time) {
 
 void Timer::reset() {
     timeWaited = 0;
-    lastTime = pros::millis();
+    lastTime = lemlib::micros();
 }
 
 void Timer::pause() {
-    if (!paused) lastTime = pros::millis();
+    if (!paused) lastTime = lemlib::micros();
     paused = true;
 }
 
 void Timer::resume() {
-    if (paused) lastTime = pros::millis();
+    if (paused) lastTime = lemlib::micros();
     paused = false;
 }
 
 void Timer::waitUntilDone() {
-    do pros::delay(5);
+    do lemlib::delay(5);
     while (!this->isDone());
 }
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <mutex>
+#include "lemlib/clock.hpp"
+#include "lemlib/trigger.hpp"
+
+namespace lemlib {
+Trigger::Trigger(const char* name, std::function<float()> read, TriggerSettings settings, std::uint32_t period)
+    : Subsystem(name, period),
+      read(std::move(read)),
+      settings(settings) {}
+
+Trigger::Trigger(const char* name, pros::Distance* sensor, TriggerSettings settings, std::uint32_t period)
+    : Trigger(name, [sensor] { return float(sensor->get_distance()); }, settings, period) {}
+
+Trigger::Trigger(const char* name, pros::Optical* sensor, TriggerSettings settings, std::uint32_t period)
+    : Trigger(name, [sensor] { return float(sensor->get_proximity()); }, settings, period) {}
+
+Trigger::Trigger(const char* name, pros::adi::AnalogIn* sensor, TriggerSettings settings, std::uint32_t period)
+    : Trigger(name, [sensor] { return float(sensor->get_value()); }, settings, period) {}
+
+Trigger::Trigger(const char* name, pros::adi::DigitalIn* sensor, TriggerSettings settings, std::uint32_t period)
+    : Trigger(name, [sensor] { return float(sensor->get_value()); }, settings, period) {}
+
+void Trigger::update() {
+    const float value = read();
+    const std::uint32_t now = millis();
+    std::vector<std::function<void()>> fire;
+    {
+        std::lock_guard lock(mutex);
+        reading = value;
+        const bool falling = settings.on < settings.off;
+        const bool on = falling ? value <= settings.on : value >= settings.on;
+        const bool off = falling ? value >= settings.off : value <= settings.off;
+        if (!active && on) {
+            active = true;
+            activeSince = now;
+        } else if (active && off) active = false;
+
+        if (!armed || fired || !active) return;
+        if (now - activeSince < settings.debounce + settings.delay) return;
+        fire = callbacks;
+    }
+    // only updates fire, so nothing can fire again while the callbacks run outside the lock
+    for (auto& callback : fire) callback();
+    // then count as fired and wake the waiting tasks, so they carry on with the callbacks done
+    std::vector<pros::task_t> wake;
+    {
+        std::lock_guard lock(mutex);
+        // unless disarmed while the callbacks ran
+        if (armed) fired = true;
+        wake.swap(waiting);
+    }
+    for (pros::task_t task : wake) pros::Task(task).notify();
+}
+
+void Trigger::arm() {
+    std::lock_guard lock(mutex);
+    armed = true;
+    fired = false;
+}
+
+void Trigger::disarm() {
+    std::lock_guard lock(mutex);
+    armed = false;
+    fired = false;
+}
+
+bool Trigger::isArmed() {
+    std::lock_guard lock(mutex);
+    return armed;
+}
+
+bool Trigger::isFired() {
+    std::lock_guard lock(mutex);
+    return fired;
+}
+
+bool Trigger::isActive() {
+    std::lock_guard lock(mutex);
+    return active;
+}
+
+float Trigger::getReading() {
+    std::lock_guard lock(mutex);
+    return reading;
+}
+
+void Trigger::onFire(std::function<void()> callback) {
+    std::lock_guard lock(mutex);
+    callbacks.push_back(std::move(callback));
+}
+
+bool Trigger::waitUntilFired(std::uint32_t timeout) {
+    const std::uint32_t start = millis();
+    const pros::task_t self = static_cast<pros::task_t>(pros::Task::current());
+    while (true) {
+        {
+            std::lock_guard lock(mutex);
+            if (fired) return true;
+            if (std::find(waiting.begin(), waiting.end(), self) == waiting.end()) waiting.push_back(self);
+        }
+        const std::uint32_t elapsed = millis() - start;
+        if (timeout != TIMEOUT_MAX && elapsed >= timeout) break;
+        pros::Task::notify_take(true, timeout == TIMEOUT_MAX ? TIMEOUT_MAX : timeout - elapsed);
+    }
+    std::lock_guard lock(mutex);
+    waiting.erase(std::remove(waiting.begin(), waiting.end(), self), waiting.end());
+    return fired;
+}
+} // namespace lemlib
@@ -10,11 +10,6 @@ float lemlib::slew(float target, float current, float maxChange) {
     return current + change;
 }
 
-constexpr float lemlib::sanitizeAngle(float angle, bool radians) {
-    if (radians) return std::fmod(std::fmod(angle, 2 * M_PI) + 2 * M_PI, 2 * M_PI);
-    else return std::fmod(std::fmod(angle, 360) + 360, 360);
-}
-
 float lemlib::angleError(float target, float position, bool radians, AngularDirection direction) {
     // bound angles from 0 to 2pi or 0 to 360
     target = sanitizeAngle(target, radians);
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <deque>
 #include "main.h"
 #include "lemlib/api.hpp" // IWYU pragma: keep
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/fieldView.hpp"
+#include "lemlib/logger/stdout.hpp"
 #include "robodash/api.h"
 
 // tracking wheels
@@ -78,15 +83,22 @@ lemlib::ExpoDriveCurve steerCurve(3, // joystick deadband out of 127
 lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors, &throttleCurve, &steerCurve);
 
 // controller
+// a button is held after 400ms, and double tapped when pressed again within 250ms
+lemlib::InputSettings inputSettings(400, 250);
+// samples the controller once every 5ms. The driver loop and the subsystems take their presses from its queues, and read
+// the sticks and buttons from its last sample
+lemlib::ControllerInput controllerInput("controller", &controller, inputSettings, 5);
+// writes the controller screen and rumbles at the rate the controller takes them. Calibration rumbles through it too
+lemlib::ControllerScreen controllerScreen("controller screen");
 
 
-//Pneumatics (pros::ADIDigitalOut _NAME_ (ADI_PORT))
-pros::ADIDigitalOut clamp('F');
-pros::ADIDigitalOut doinker('G');
-pros::ADIDigitalOut hang('H');
+//Pneumatics (pros::adi::DigitalOut _NAME_ (ADI_PORT))
+pros::adi::DigitalOut clamp('F');
+pros::adi::DigitalOut doinker('G');
+pros::adi::DigitalOut hang('H');
 
 
-pros::ADIAnalogIn line_tracker ('A');
+pros::adi::AnalogIn line_tracker ('A');
 
 //Other motors
 pros::Motor intake1(-11, pros::MotorGearset::blue);
@@ -94,6 +106,38 @@ pros::Motor intake2(-20, pros::MotorGearset::green);
 
 pros::Motor lb1 (21, pros::MotorGearset::green);
 
+// motor outputs. Every write to these motors goes through a writer, so tasks sharing a motor don't fight over it and
+// unchanged commands aren't resent every tick
+lemlib::MotorOutput intake1Output(&intake1);
+lemlib::MotorOutput intake2Output(&intake2);
+lemlib::MotorOutput lbOutput(&lb1);
+
+// writer priorities, higher wins. The routines, color sorting and the driver share the intake by priority and take
+// turns through first_stage and opC, unjamming overrides all of them
+constexpr int INTAKE_PRIORITY = 1;
+constexpr int UNJAM_PRIORITY = 2;
+
+lemlib::MotorOutput::Writer sortIntake1 = intake1Output.writer("color sort", INTAKE_PRIORITY);
+lemlib::MotorOutput::Writer sortIntake2 = intake2Output.writer("color sort", INTAKE_PRIORITY);
+lemlib::MotorOutput::Writer routineIntake1 = intake1Output.writer("routine", INTAKE_PRIORITY);
+lemlib::MotorOutput::Writer routineIntake2 = intake2Output.writer("routine", INTAKE_PRIORITY);
+lemlib::MotorOutput::Writer driverIntake1 = intake1Output.writer("driver", INTAKE_PRIORITY);
+lemlib::MotorOutput::Writer driverIntake2 = intake2Output.writer("driver", INTAKE_PRIORITY);
+lemlib::MotorOutput::Writer unjamIntake1 = intake1Output.writer("unjam", UNJAM_PRIORITY);
+lemlib::MotorOutput::Writer lbWriter = lbOutput.writer("lady brown", 0);
+// routines driving the drivetrain directly share it with the chassis, the latest request wins
+lemlib::MotorOutput::Writer routineLeftDrive = chassis.leftOutput.writer("routine", 0);
+lemlib::MotorOutput::Writer routineRightDrive = chassis.rightOutput.writer("routine", 0);
+
+// hand the intake and the drivetrain back once a routine is over. A writer stays active until released, so the last
+// command of the routine would otherwise stay in force, and keep competing with the driver and color sorting
+void releaseRoutineOutputs() {
+    routineIntake1.release();
+    routineIntake2.release();
+    routineLeftDrive.release();
+    routineRightDrive.release();
+}
+
 //rotation sensor
 pros::Rotation ladyBrownRotation(17); //make sure you get the right port
 pros::Distance clamp_sensor(5);
@@ -102,277 +146,470 @@ pros::Distance reset_distance(14);
 //optical
 pros::Optical optical(18);
 
-//current team color
-char team_color = 'B';
-
-bool intake_on = false;
-bool reversed = false;
+// robot state shared by the routines, the driver and the subsystems, which run on different tasks. Tasks wait for a
+// change with waitUntil instead of polling
 
-bool auton = false;
-bool opC = false;
+//current team color
+lemlib::State<char> team_color = 'B';
 
-float targetTheta = 0;
-float exitRange = 0;
+lemlib::State<bool> intake_on = false;
+lemlib::State<bool> reversed = false;
 
-bool clampOn = false;
-bool current = false;
+lemlib::State<bool> auton = false;
+lemlib::State<bool> opC = false;
 
-bool ringStop = false;
-bool is_ring_stopped = false;
+lemlib::State<bool> clampOn = false;
+lemlib::State<bool> current = false;
 
-int sequenceStep = 0;
+lemlib::State<bool> ringStop = false;
+lemlib::State<bool> is_ring_stopped = false;
 
-bool is_stuck = false;
+lemlib::State<int> sequenceStep = 0;
 
-bool skills_hold = false;
-bool is_ring_stopped_s = false;
-bool first_stage = false;
+lemlib::State<bool> is_stuck = false;
 
-void clampCheck(void* param){
-    bool check = false;
-    int distance;
-    
+lemlib::State<bool> skills_hold = false;
+lemlib::State<bool> is_ring_stopped_s = false;
+lemlib::State<bool> first_stage = false;
 
-    while(true){
-        distance = clamp_sensor.get_distance();
-        //pros::lcd::print(6, "%i", distance);
-        if (clampOn && distance < 25 && !current){
-            pros::delay(250);
-            clamp.set_value(true);
-            current = true;
-        }
-        else if (!clampOn && current){
-            clamp.set_value(false);
-            current = !current;
-            pros::delay(100);
-        }
-        
-        int dynamic_delay = (clampOn) ? 10 : 100;
-        pros::delay(dynamic_delay);
-        if (opC) break;
-    }
-}
+// timing of the driver loop, sent as telemetry. The subsystems have their own
+lemlib::LoopProfile driverProfile("driver");
 
+// a goal is in the clamp once the clamp sensor reads 25mm or less for 20ms. It is gone once the sensor reads more than
+// 50mm
+lemlib::TriggerSettings clampTriggerSettings(25, 50, 20, 0);
+// closes the clamp the moment a goal is in it, while armed. The routines wait for it to know the goal is clamped
+lemlib::Trigger clampTrigger("clamp sensor", &clamp_sensor, clampTriggerSettings);
 
-void color_check(void* param) {
-    // Variables for RGB values
-    float hue = 0;
-    int x = 0;
-    
-    skills_hold = false;
-    first_stage = false;
-    ringStop = false;
+// arms clampTrigger while clampOn, and opens the clamp when clampOn is cleared. Runs until driver control, where the
+// driver clamps by hand
+class Clamp : public lemlib::Subsystem {
+    public:
+        Clamp()
+            : Subsystem("clamp", 10) {}
 
-    while (true) {
-        // Read RGB values from the optical sensor
-        auto k = optical.get_proximity();
-        auto c = optical.get_rgb();
-        
-        if (!is_stuck && !first_stage){
-            is_ring_stopped = false;
-            if(ringStop){
-                if ((k > 60 && c.brightness > 0.05) && (c.red > c.blue) == (team_color == 'R') || x > 300){
-                    intake1.move(0);
-                    intake2.move(0);
-                    while (ringStop){
-                        is_ring_stopped = true;
-                        pros::delay(200);
-                    }
+        void update() override {
+            if (opC) {
+                clampTrigger.disarm();
+                return;
+            }
+            const std::uint32_t now = lemlib::millis();
+            if (now < holdUntil) return;
+            if (!clampOn) {
+                if (current) {
+                    clamp.set_value(false);
+                    current = false;
+                    // the goal just let go of is still in front of the sensor
+                    holdUntil = now + 100;
                 }
-                else{
-                    x++;
-                    intake1.move(-100);
-                    intake2.move(127);
+                clampTrigger.disarm();
+            } else if (!current && !clampTrigger.isArmed()) clampTrigger.arm();
+        }
+    private:
+        std::uint32_t holdUntil = 0;
+};
+
+// intake1 turns this far, in degrees, while it carries a ring from the optical sensor to the top of the intake, where
+// the ring is thrown off if intake1 reverses under it
+constexpr float RING_TRAVEL = 540;
+// the closest two rings can be on intake1, in degrees of travel
+constexpr float RING_SPACING = 300;
+// how early to reverse intake1 before a ring reaches the top, in seconds of travel at the current speed. Covers the
+// update period and the time intake1 takes to stop
+constexpr float EJECT_LEAD = 0.02;
+// how long intake1 runs backwards to throw a ring off, in milliseconds
+constexpr std::uint32_t EJECT_TIME = 120;
+
+// runs the intake for the routines, throws out rings of the other color, and stops a ring of ours at the top while
+// ringStop. Runs until driver control
+//
+// A ring of the other color is seen when it passes the optical sensor, and thrown off when intake1 has carried it
+// RING_TRAVEL further, so it is timed by how far the intake turned and not by a fixed delay. A slow or jammed intake
+// throws the ring off late, when it actually gets to the top. Nothing is sorted while first_stage or is_stuck
+class ColorSort : public lemlib::Subsystem {
+    public:
+        ColorSort()
+            : Subsystem("color", 5) {}
+
+        void update() override {
+            if (opC) {
+                // hand the intake to the driver
+                if (!released) {
+                    sortIntake1.release();
+                    sortIntake2.release();
+                    released = true;
                 }
-                
+                return;
             }
-            else if ((k > 100 && c.brightness > 0.05) && (c.red > c.blue) == (team_color == 'B')) { // ((team_color == 'R' && hue > 137) || (team_color == 'B' && hue < 22))
-                // Wrong color detected: Reject object
-                pros::delay(150);
-                intake1.move(120); 
-                pros::delay(200);
-            } 
-            
-            else {
-                // Correct color detected or no wrong color
-                if (intake_on) {
-                    intake1.move(-127); // Keep the intake running forward
-                    intake2.move(127);
-                } else if (!reversed){
-                    intake1.move(0);   // Stop the intake if not needed
-                    intake2.move(0);
+            const std::uint32_t now = lemlib::millis();
+            // intake1 is reversed, it turns backwards to carry rings up
+            const float travel = -intake1.get_position();
+            const float speed = -intake1.get_actual_velocity() * 6; // degrees per second
+            // a ring of ours is held at the top until ringStop is cleared
+            if (holding) {
+                if (ringStop) {
+                    is_ring_stopped = true;
+                    return;
                 }
+                holding = false;
+            }
+            // the routines and jam recovery have the intake, don't sort under them. Rings seen before are forgotten,
+            // the intake moved them without the sorter knowing where to
+            if (is_stuck || first_stage) {
+                ejectAt.clear();
+                ejecting = false;
+                return;
             }
-        }
-
-        // Small delay to avoid overwhelming the system
-        int dynamic_delay = (intake_on) ? 10 : 50;
-        pros::delay(dynamic_delay);
-        if (opC) break;
-    }
-}
 
-lemlib::PID armPID(1.6, 0, 0);
+            auto k = optical.get_proximity();
+            auto c = optical.get_rgb();
+            // a ring passing the sensor is seen for several samples, only look at its color once. Rings carried back
+            // down while throwing one off pass the sensor again at the same travel, and are only counted once
+            const bool seen = k > 100 && c.brightness > 0.05;
+            if (seen && !ringInView && speed > 0 && !ringStop && (c.red > c.blue) == (team_color == 'B')) {
+                const bool counted = std::any_of(ejectAt.begin(), ejectAt.end(), [&](float at) {
+                    return std::fabs(at - RING_TRAVEL - travel) < RING_SPACING / 2;
+                });
+                if (!counted) ejectAt.push_back(travel + RING_TRAVEL);
+            }
+            ringInView = seen;
 
-void LBpidTask(void* param) {
-        float currentTheta = 0;
-        float prevMotorPower = 0;
-        exitRange = 40;
-        float error = 0.0f;
-        bool allianceS = false;
-        int sequenceStepA = 0;
-        bool deScore = false;
-        skills_hold = false;
-        pros::delay(25);
-
-        while(true){
-
-            if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
-
-                allianceS = false;
-                sequenceStep = (sequenceStep + 1) % 3;
-
-                switch (sequenceStep) {
-                    case 1:
-                        targetTheta = 26;
-                        lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-                        exitRange = 0.2;
-                        break;
-                    case 9:
-                        targetTheta = 100;
-                        //exitRange = 0.2;
-                        break;
-                    case 2:
-                        targetTheta = 210;
-                        lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-                        exitRange = 40;
-                        break;
-                }
+            // throwing out a ring: run intake1 backwards under it for a moment
+            if (ejecting) {
+                if (now - ejectSince < EJECT_TIME) return;
+                ejecting = false;
+            }
+            if (!ejectAt.empty() && ejectAt.front() - travel <= std::max(speed, 0.0f) * EJECT_LEAD) {
+                sortIntake1.move(120);
+                ejecting = true;
+                ejectSince = now;
+                ejectAt.pop_front();
+                return;
             }
 
-            else if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN)){
-                
-                switch (sequenceStepA) {
-                        case 0:
-                            targetTheta = 250;
-                            lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-                            exitRange = 10;
-                            break;
-                    
-                     case 1:
-                        targetTheta = 0;
-                        lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-                        exitRange = 10;
-                        
-                        break;
+            is_ring_stopped = false;
+            if (ringStop) {
+                if ((k > 60 && c.brightness > 0.05 && (c.red > c.blue) == (team_color == 'R')) || x > 600) {
+                    sortIntake1.move(0);
+                    sortIntake2.move(0);
+                    holding = true;
+                    is_ring_stopped = true;
+                } else {
+                    x++;
+                    sortIntake1.move(-100);
+                    sortIntake2.move(127);
                 }
-                sequenceStepA = (sequenceStepA + 1) % 2;
-                    allianceS = !allianceS;
+            } else if (intake_on) {
+                // correct color detected or no wrong color, keep the intake running forward
+                sortIntake1.move(-127);
+                sortIntake2.move(127);
+            } else if (!reversed) {
+                // stop the intake if not needed
+                sortIntake1.move(0);
+                sortIntake2.move(0);
             }
+        }
+    private:
+        // updates spent looking for a ring to stop, it stops anyway after 600
+        int x = 0;
+        bool holding = false;
+        bool ringInView = false;
+        // intake1 travel at which each ring of the other color on the way up reaches the top, oldest first
+        std::deque<float> ejectAt;
+        bool ejecting = false;
+        std::uint32_t ejectSince = 0;
+        bool released = false;
+};
+
+// the lady brown arm is horizontal at rest, and swings up over the top to score
+lemlib::MechanismSettings armSettings(160, // proportional gain (kP)
+                                      0, // integral gain (kI)
+                                      1000, // derivative gain (kD)
+                                      10, // velocity feedforward (kV)
+                                      0.8, // acceleration feedforward (kA)
+                                      600, // gravity feedforward (kG)
+                                      0, // horizontal at 0 degrees
+                                      900, // maximum velocity, in degrees per second
+                                      6000, // maximum acceleration, in degrees per second squared
+                                      2); // reached within 2 degrees
+
+// presses of the buttons that move the lady brown arm
+lemlib::InputQueue& armButtons() {
+    static lemlib::InputQueue& queue = controllerInput.subscribe(
+        {pros::E_CONTROLLER_DIGITAL_RIGHT, pros::E_CONTROLLER_DIGITAL_DOWN, pros::E_CONTROLLER_DIGITAL_B});
+    return queue;
+}
 
-            else if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_B)){
-                    if (deScore == false){
-                        targetTheta = 180;
-                        lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-                        exitRange = 2;
+// moves the lady brown arm between its setpoints, and steps it through them with the controller
+class LadyBrown : public lemlib::Mechanism {
+    public:
+        LadyBrown()
+            : Mechanism("ladyBrown", lbWriter, &ladyBrownRotation, armSettings) {}
+
+        void update() override {
+            lemlib::InputEvent event;
+            while (armButtons().pop(event)) {
+                if (event.type != lemlib::InputEventType::PRESS) continue;
+                if (event.button == pros::E_CONTROLLER_DIGITAL_RIGHT) {
+                    allianceS = false;
+                    sequenceStep = (sequenceStep + 1) % 3;
+
+                    switch (sequenceStep) {
+                        case 1: moveTo("load"); break;
+                        case 2: moveTo("wallStake"); break;
                     }
-                    else{
+                } else if (event.button == pros::E_CONTROLLER_DIGITAL_DOWN) {
+                    switch (sequenceStepA) {
+                        case 0: moveTo("allianceStake"); break;
+                        case 1: moveTo("rest"); break;
+                    }
+                    sequenceStepA = (sequenceStepA + 1) % 2;
+                    allianceS = !allianceS;
+                } else if (event.button == pros::E_CONTROLLER_DIGITAL_B) {
+                    if (deScore == false) {
+                        moveTo("descore");
+                    } else {
                         sequenceStep = 0;
-                        targetTheta = 0;
-                        lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-                        exitRange = 10;
+                        moveTo("rest");
                     }
                     deScore = !deScore;
+                }
             }
+            // after scoring on the wall stake, come back down. The stake stops the arm short of the setpoint, so it
+            // never counts as reached there: come back once it is within 30 degrees
+            if (sequenceStep == 2 && getPosition() > WALL_STAKE_SCORED) {
+                sequenceStep = 0;
+                moveTo("rest");
+            }
+            Mechanism::update();
+        }
+    private:
+        // angle at which the arm has scored on the wall stake, 30 degrees short of the setpoint
+        static constexpr float WALL_STAKE_SCORED = 180;
 
-            
-
+        bool allianceS = false;
+        int sequenceStepA = 0;
+        bool deScore = false;
+};
 
-                currentTheta = (float)ladyBrownRotation.get_angle() / 100;
+LadyBrown ladyBrown;
 
-                if (currentTheta > 350){
-                    currentTheta = currentTheta - 360;
-                }
-                // Get output from PID (Target - Actual (Accounts for gear ratio))
-                
-
-                error = targetTheta - currentTheta;
-                
-                if (fabs(error) > exitRange) {
-                    double out = armPID.update(error);
-                    
-                    lb1.move_voltage(out * 100);  // Output to motor
-                } 
-                else if (sequenceStep == 2 && fabs(error) < 30){
-                        sequenceStep = 0;
-                        targetTheta = 0;
-                        exitRange = 40;
-                }
-                else lb1.brake();  // Stop the motor when within range with said brake mode
-                
-                pros::delay(20);  // Don't hog the CPU
-            
-        } 
+// presses of the hang button. Subscribed when the hang is first enabled, so presses before driver control are ignored
+lemlib::InputQueue& hangButton() {
+    static lemlib::InputQueue& queue = controllerInput.subscribe({pros::E_CONTROLLER_DIGITAL_X});
+    return queue;
 }
 
-void hang_task(void* param){
-    while(true){
-        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_X)) {
-                if (sequenceStep == 1){
-                    targetTheta = 0;
-                    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-                    exitRange = 1;
-                    pros::delay(550);
+// fires the hang with X, lowering the arm out of the way first if it is loading. Enabled in driver control
+class Hang : public lemlib::Subsystem {
+    public:
+        Hang()
+            : Subsystem("hang", 20, false) {}
+
+        void update() override {
+            const std::uint32_t now = lemlib::millis();
+            if (step == Step::IDLE) {
+                lemlib::InputEvent event;
+                if (!hangButton().pop(event) || event.type != lemlib::InputEventType::PRESS) return;
+                if (sequenceStep == 1) {
+                    ladyBrown.moveTo(0);
+                    step = Step::LOWERING;
+                } else {
                     hang.set_value(true);
-                    pros::delay(200);
-                    targetTheta = 41;
-                    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-                    exitRange = 1;
+                    step = Step::FIRING;
                 }
-                else{
-                    hang.set_value(true);
-                    pros::delay(200);
-                    targetTheta = 41;
-                    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-                    exitRange = 1;
-                }
-                    
+                since = now;
+            } else if (step == Step::LOWERING && (ladyBrown.isReached() || now - since >= 550)) {
+                hang.set_value(true);
+                step = Step::FIRING;
+                since = now;
+            } else if (step == Step::FIRING && now - since >= 200) {
+                ladyBrown.moveTo("hang");
+                step = Step::IDLE;
+            }
         }
-    }
-    pros::delay(30);
+    private:
+        enum class Step { IDLE, LOWERING, FIRING };
+
+        Step step = Step::IDLE;
+        std::uint32_t since = 0;
+};
+
+// intake1 is jammed once it has been stopped while straining for 40ms, and not speeding up, so rings slowing it down
+// and starting up aren't. A ring loaded into the lady brown jams it too, which the routines wait for with is_stuck
+lemlib::JamSettings intakeJamSettings(1800, // strained above 1800mA
+                                      0.25, // and 0.25Nm
+                                      90, // stopped below 90rpm
+                                      40, // for 40ms
+                                      1000); // jams within 1s of a recovery escalate
+// how intake1 gets out of a jam: briefly backwards, then for longer if it jams again straight away, then stopped for a
+// moment if that didn't clear it either
+std::vector<lemlib::RecoveryStep> intakeRecovery = {{90, 100}, {127, 250}, {0, 500}};
+
+// runs intake1 backwards when it jams. Detects jams until driver control
+class Unjam : public lemlib::Subsystem {
+    public:
+        Unjam()
+            : Subsystem("stuck", 10),
+              detector(&intake1, unjamIntake1, intakeJamSettings, intakeRecovery) {}
+
+        void update() override { is_stuck = detector.update(!opC && !reversed); }
+    private:
+        lemlib::JamDetector detector;
+};
+
+Clamp clampSubsystem;
+ColorSort colorSort;
+Hang hangSubsystem;
+Unjam unjam;
+
+// what the screens show, sampled once per frame
+struct RobotView {
+        lemlib::Pose pose;
+        char team;
+        bool goal;
+        int armStep;
+        bool jammed;
+};
+
+// shows the pose on the brain screen, and the alliance, the goal, the pose and the arm on the controller
+lemlib::Dashboard<RobotView> dashboard("dashboard", [] {
+    return RobotView {chassis.getPose(), team_color, current, sequenceStep, is_stuck};
+});
+
+// where the robot has been, a pose every inch. The field view draws its trail from it
+lemlib::PoseHistory poseHistory("pose history", [] { return chassis.getPose(); }, 1);
+// the field on the brain screen, with the robot and its trail. The routines start at (0, 0), drawn in the middle
+lemlib::FieldView fieldView("Field", &poseHistory);
+
+// every subsystem runs from this one task, every 5ms so the color sort sees every sample of the optical sensor
+lemlib::SubsystemScheduler& subsystems() {
+    static lemlib::SubsystemScheduler subsystems(5);
+    return subsystems;
 }
 
+// the brain and controller screens run from their own task every 50ms, below the control loops so drawing never makes
+// them late
+lemlib::SubsystemScheduler& displays() {
+    static lemlib::SubsystemScheduler displays(50, TASK_PRIORITY_DEFAULT - 1);
+    return displays;
+}
 
-void is_stuck_check(void* param) {
-    while (!opC) {
-        float intake_torque = intake1.get_torque();  // Store once
-        float intake_velocity = intake1.get_actual_velocity();  
+// telemetry channels, sampled by one task. host/tools/telemetry decodes them on the computer
+lemlib::TelemetryRegistry& telemetry() {
+    static lemlib::TelemetryRegistry telemetry;
+    return telemetry;
+}
 
-        if (intake_torque > 0.34 && fabs(intake_velocity) < 1 && !reversed) {
-            is_stuck = true;
-            intake1.move(90);
-            pros::delay(100);
-            intake1.move(0);
-        } 
-        else {
-            is_stuck = false;
-            int dynamic_delay = (intake_on) ? 10 : 150;
-            pros::delay(dynamic_delay);
-        }
+// records telemetry to the SD card, one file per autonomous and driver control period
+lemlib::FlightRecorder& recorder() {
+    static lemlib::FlightRecorder recorder;
+    return recorder;
+}
+
+void setup_dashboard() {
+    // two decimals, so the lines are only redrawn when the robot moves
+    dashboard.addWidget(0, [](const RobotView& view, char* text, std::size_t size) {
+        std::snprintf(text, size, "X: %.2f", view.pose.x);
+    });
+    dashboard.addWidget(1, [](const RobotView& view, char* text, std::size_t size) {
+        std::snprintf(text, size, "Y: %.2f", view.pose.y);
+    });
+    dashboard.addWidget(2, [](const RobotView& view, char* text, std::size_t size) {
+        std::snprintf(text, size, "Theta: %.2f", view.pose.theta);
+    });
+    // rounded, so the controller lines only change when there is something new to show
+    const auto toController = [](std::uint8_t line, const char* text) { controllerScreen.setText(line, text); };
+    dashboard.addWidget(
+        0,
+        [](const RobotView& view, char* text, std::size_t size) {
+            std::snprintf(text, size, "%s %s", view.team == 'R' ? "red" : "blue", view.goal ? "goal" : "no goal");
+        },
+        toController);
+    dashboard.addWidget(
+        1,
+        [](const RobotView& view, char* text, std::size_t size) {
+            std::snprintf(text, size, "%4.0f %4.0f %4.0f", view.pose.x, view.pose.y, view.pose.theta);
+        },
+        toController);
+    dashboard.addWidget(
+        2,
+        [](const RobotView& view, char* text, std::size_t size) {
+            static const char* arm[] = {"rest", "load", "wall"};
+            std::snprintf(text, size, "arm %s%s", arm[view.armStep % 3], view.jammed ? " jam" : "");
+        },
+        toController);
+}
+
+void setup_telemetry() {
+    lemlib::TelemetryRegistry& registry = telemetry();
+    registry.add(1, "pose", {"x", "y", "theta"}, 10, [] {
+        const lemlib::Pose pose = chassis.getPose();
+        return std::tuple(pose.x, pose.y, pose.theta);
+    });
+    // rpm, of the first motor on each side
+    registry.add(2, "wheels", {"left", "right"}, 10, [] {
+        return std::tuple(std::int16_t(leftMotors.get_actual_velocity()),
+                          std::int16_t(rightMotors.get_actual_velocity()));
+    });
+    registry.add(3, "lateral", {"error", "output"}, 20,
+                 [] { return std::tuple(chassis.lateralPID.getError(), chassis.lateralPID.getOutput()); });
+    registry.add(4, "angular", {"error", "output"}, 20,
+                 [] { return std::tuple(chassis.angularPID.getError(), chassis.angularPID.getOutput()); });
+    registry.add(5, "ladyBrown", {"error", "output"}, 20,
+                 [] { return std::tuple(ladyBrown.getError(), ladyBrown.getOutput()); });
+    // milliamps and degrees celsius
+    registry.add(6, "motors", {"leftCurrent", "rightCurrent", "intakeCurrent", "leftTemp", "rightTemp", "intakeTemp"},
+                 100, [] {
+                     return std::tuple(std::int16_t(leftMotors.get_current_draw()),
+                                       std::int16_t(rightMotors.get_current_draw()),
+                                       std::int16_t(intake1.get_current_draw()),
+                                       std::uint8_t(leftMotors.get_temperature()),
+                                       std::uint8_t(rightMotors.get_temperature()),
+                                       std::uint8_t(intake1.get_temperature()));
+                 });
+    registry.add(7, "state", {"intake", "stuck", "clamp", "lbStep"}, 50, [] {
+        return std::tuple(std::uint8_t(intake_on), std::uint8_t(is_stuck), std::uint8_t(clampOn),
+                          std::uint8_t(sequenceStep));
+    });
+    std::vector<std::string> channels = {"pose", "wheels", "lateral", "angular", "ladyBrown", "motors", "state"};
+    // timing of the loops, in microseconds. Motions only have a profile once they have run
+    std::uint8_t id = 8;
+    for (const char* loop : {"odom", "moveToPoint", "moveToPose", "turnToHeading", "turnToPoint", "swingToHeading",
+                             "swingToPoint", "follow", "clamp", "color", "ladyBrown", "hang", "stuck", "dashboard",
+                             "driver"}) {
+        channels.push_back(std::string("loop.") + loop);
+        registry.add(id++, channels.back(), {"count", "mean", "p99", "max", "lateP99", "lateMax"}, 1000, [loop] {
+            const lemlib::LoopProfile* profile = lemlib::LoopProfile::find(loop);
+            if (profile == nullptr) return std::tuple(0u, 0.0f, 0u, 0u, 0u, 0u);
+            const lemlib::Histogram& execution = profile->getExecution();
+            const lemlib::Histogram& lateness = profile->getLateness();
+            return std::tuple(execution.count, execution.mean(), execution.percentile(99), execution.max,
+                              lateness.percentile(99), lateness.max);
+        });
+    }
+    // frames and messages lost because the output to the computer, the recorder or the logger task was full
+    channels.push_back("drops");
+    registry.add(id++, channels.back(), {"stdout", "recorder", "log"}, 1000, [] {
+        return std::tuple(lemlib::bufferedStdout().getDropped(), recorder().getDropped(),
+                          lemlib::BaseSink::getDroppedRecords());
+    });
+    // stream everything to the computer, and record it
+    for (const std::string& channel : channels) {
+        registry.subscribe(channel, [](const lemlib::TelemetryFrame& frame) { lemlib::sendTelemetryFrame(frame); });
+        registry.subscribe(channel, [](const lemlib::TelemetryFrame& frame) { recorder().write(frame); });
     }
 }
+
 bool line_detect = false;
 bool track = false;
 
-int temp = 0;
-
 void red_SAWP() {
     team_color = 'R';
     chassis.setPose(0, 0, 0);
     chassis.moveToPoint(0, 5, 1000);
-    targetTheta = 220;
-    exitRange = 5;
-    pros::delay(350);
+    ladyBrown.moveTo("preload");
+    ladyBrown.waitUntilReached(350);
     chassis.moveToPoint(0, -3, 1000, {.forwards = false, .minSpeed = 30, .earlyExitRange = 3});
     //chassis.moveToPoint(27.018, 11.853, 2000, {.forwards = false, .minSpeed = 50, .earlyExitRange = 10});
     chassis.moveToPoint(-16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 110});
@@ -380,11 +617,8 @@ void red_SAWP() {
     chassis.cancelMotion();
     chassis.moveToPoint(-16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 60, .minSpeed = 30});
     clampOn = true;
-    targetTheta = 0;
-    exitRange = 30;
-    while(!current){
-        pros::delay(10);
-    }
+    ladyBrown.moveTo("rest");
+    clampTrigger.waitUntilFired();
     pros::delay(50);
     chassis.cancelMotion();
     chassis.turnToPoint(-4.26, -42.55, 690, {.minSpeed = 50, .earlyExitRange = 3});
@@ -410,11 +644,9 @@ void red_SAWP() {
     chassis.waitUntilDone();
     clampOn = true;
     first_stage = true;
-    intake2.move(127);
+    routineIntake2.move(127);
     chassis.moveToPoint(-57.76, 6.5, 1000, {.forwards = false, .maxSpeed = 40});
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     chassis.cancelMotion();
     pros::delay(90);
     first_stage = false;
@@ -430,16 +662,14 @@ void red_SAWP() {
     chassis.swingToPoint(-60.3, 5.37, DriveSide::RIGHT, 1000, {.direction = AngularDirection::CCW_COUNTERCLOCKWISE, .minSpeed = 40, .earlyExitRange = 9, });
     chassis.moveToPoint(-60.3, 5.37, 1000, {.earlyExitRange = 4});
     chassis.waitUntil(5);
-    targetTheta = 210;
-    exitRange = 90;
+    ladyBrown.moveTo("ladder");
 }
 void blue_SAWP() {
     team_color = 'B';
     chassis.setPose(0, 0, 0);
     chassis.moveToPoint(0, 5, 1000);
-    targetTheta = 220;
-    exitRange = 5;
-    pros::delay(350);
+    ladyBrown.moveTo("preload");
+    ladyBrown.waitUntilReached(350);
     chassis.moveToPoint(0, -3, 1000, {.forwards = false, .minSpeed = 30, .earlyExitRange = 3});
     //chassis.moveToPoint(27.018, 11.853, 2000, {.forwards = false, .minSpeed = 50, .earlyExitRange = 10});
     chassis.moveToPoint(16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 100});
@@ -447,11 +677,8 @@ void blue_SAWP() {
     chassis.cancelMotion();
     chassis.moveToPoint(16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 40, .minSpeed = 5});
     clampOn = true;
-    while(!current){
-        pros::delay(10);
-    }
-    targetTheta = 0;
-    exitRange = 30;
+    clampTrigger.waitUntilFired();
+    ladyBrown.moveTo("rest");
     pros::delay(120);
     chassis.cancelMotion();
     chassis.turnToPoint(4.26, -42.55, 690, {.minSpeed = 50, .earlyExitRange = 3});
@@ -467,19 +694,15 @@ void blue_SAWP() {
     chassis.waitUntil(8);
     clampOn = false;
     ringStop = true;
-    while (!is_ring_stopped){
-        pros::delay(10);
-    }
+    is_ring_stopped.waitUntil(true);
     first_stage = true;
-    intake2.move(127);
+    routineIntake2.move(127);
     chassis.swingToPoint(56.355, 7.8, DriveSide::RIGHT ,1000, {.forwards = false, .minSpeed = 30 , .earlyExitRange = 8});
 
     chassis.waitUntilDone();
     clampOn = true;
     chassis.moveToPoint(56.355, 7.8, 1000, {.forwards = false, .maxSpeed = 40});
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     chassis.cancelMotion();
     pros::delay(100);
     first_stage = false;
@@ -495,16 +718,14 @@ void blue_SAWP() {
     chassis.swingToPoint(60.3, 5.37, DriveSide::LEFT, 1000, {.direction = AngularDirection::CW_CLOCKWISE, .minSpeed = 40, .earlyExitRange = 9});
     chassis.moveToPoint(60.3, 5.37, 1000, {.earlyExitRange = 4});
     chassis.waitUntil(6);
-    targetTheta = 210;
-    exitRange = 90;
+    ladyBrown.moveTo("ladder");
 }
 void red_ring() {
     team_color = 'R';
     chassis.setPose(0, 0, 0);
     chassis.moveToPoint(0, 5, 1000);
-    targetTheta = 220;
-    exitRange = 5;
-    pros::delay(350);
+    ladyBrown.moveTo("preload");
+    ladyBrown.waitUntilReached(350);
     chassis.moveToPoint(0, -3, 1000, {.forwards = false, .minSpeed = 30, .earlyExitRange = 3});
     //chassis.moveToPoint(27.018, 11.853, 2000, {.forwards = false, .minSpeed = 50, .earlyExitRange = 10});
     chassis.moveToPoint(-16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 110});
@@ -512,12 +733,9 @@ void red_ring() {
     chassis.cancelMotion();
     chassis.moveToPoint(-16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 50, .minSpeed = 30});
     clampOn = true;
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     pros::delay(50);
-    targetTheta = 0;
-    exitRange = 30;
+    ladyBrown.moveTo("rest");
     chassis.cancelMotion();
     chassis.turnToHeading(195, 1000);
     
@@ -540,17 +758,17 @@ void red_ring() {
     chassis.waitUntilDone();
     intake_on = false;
     first_stage = true;
-    intake2.move(127);
+    routineIntake2.move(127);
     chassis.moveToPose(9.1, 0.26, -45, 2000, {.lead = 0.15, .maxSpeed = 50});
     chassis.waitUntilDone();
     
     
     //doinker.set_value(false);
-    leftMotors.move(60);
-    rightMotors.move(70);
+    routineLeftDrive.move(60);
+    routineRightDrive.move(70);
     pros::delay(350);
-    intake2.move(27);
-    intake1.move(-127);
+    routineIntake2.move(27);
+    routineIntake1.move(-127);
     /*chassis.swingToHeading(13, DriveSide::LEFT, 1000, {.minSpeed = 30, .earlyExitRange = 9});
     chassis.moveToPose(-7.87, -4.6, -41, 1500, {.lead = 0.37, .minSpeed = 20, .earlyExitRange = 18});
     chassis.moveToPoint(-23, 11.34, 1700, {.maxSpeed = 50});
@@ -558,17 +776,15 @@ void red_ring() {
     chassis.turnToPoint(-28.26, -3.1, 1000, {.minSpeed = 30, .earlyExitRange = 8});
     chassis.moveToPoint(-28.26, -3.1, 1000);
     chassis.waitUntil(1);
-    targetTheta = 180;
-    exitRange = 20;*/
+    ladyBrown.moveTo("descore");*/
 }
 void blue_ring() {}
 void red_goal(){
     team_color = 'R';
     chassis.setPose(0, 0, 0);
     chassis.moveToPoint(0, 5, 1000);
-    targetTheta = 220;
-    exitRange = 5;
-    pros::delay(350);
+    ladyBrown.moveTo("preload");
+    ladyBrown.waitUntilReached(350);
     chassis.moveToPoint(0, -3, 1000, {.forwards = false, .minSpeed = 60, .earlyExitRange = 3});
     //chassis.moveToPoint(27.018, 11.853, 2000, {.forwards = false, .minSpeed = 50, .earlyExitRange = 10});
     chassis.moveToPoint(16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 70});
@@ -576,11 +792,8 @@ void red_goal(){
     chassis.cancelMotion();
     chassis.moveToPoint(16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 60, .minSpeed = 30});
     clampOn = true;
-    while(!current){
-        pros::delay(10);
-    }
-    targetTheta = 0;
-    exitRange = 30;
+    clampTrigger.waitUntilFired();
+    ladyBrown.moveTo("rest");
     pros::delay(120);
     chassis.cancelMotion();
     chassis.moveToPose(-26.85, -20.7, -117, 1000, {.lead = 0.4, .minSpeed = 30});
@@ -596,15 +809,11 @@ void red_goal(){
     doinker.set_value(false);
     chassis.turnToPoint(-5.28, -45.34, 1000);
     chassis.waitUntilDone();
-    targetTheta = 26;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    exitRange = 0.2;
+    ladyBrown.moveTo("load");
     chassis.moveToPoint(-5.28, -45.34, 1000);
     chassis.waitUntil(4);
     clampOn = false;
-    while(!is_stuck){
-        pros::delay(10);
-    }
+    is_stuck.waitUntil(true);
     intake_on = false;
     chassis.waitUntilDone();
     doinker.set_value(true);
@@ -614,30 +823,24 @@ void red_goal(){
     chassis.turnToPoint(-3.41, -64.1, 1000);
     chassis.moveToPoint(-3.41, -64.1, 1000, {.maxSpeed = 50});
     chassis.waitUntilDone();
-    targetTheta = 140;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    exitRange = 20;
+    ladyBrown.moveTo(140, false);
 }
 void blue_goal(){
     team_color = 'B';
     chassis.setPose(0, 0, 0);
     pros::delay(1000);
     chassis.moveToPoint(0, 5, 1000);
-    targetTheta = 220;
-    exitRange = 5;
-    pros::delay(350);
+    ladyBrown.moveTo("preload");
+    ladyBrown.waitUntilReached(350);
     chassis.moveToPoint(0, -3, 1000, {.forwards = false, .minSpeed = 60, .earlyExitRange = 3});
     //chassis.moveToPoint(27.018, 11.853, 2000, {.forwards = false, .minSpeed = 50, .earlyExitRange = 10});
     chassis.moveToPoint(-16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 70});
     chassis.waitUntil(9);
-    targetTheta = 0;
-    exitRange = 20;
+    ladyBrown.moveTo("rest");
     chassis.cancelMotion();
     chassis.moveToPoint(-16.7, -32.9, 2000, {.forwards = false, .maxSpeed = 60, .minSpeed = 30});
     clampOn = true;
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     pros::delay(50);
     chassis.cancelMotion();
     chassis.swingToPoint(1, -23.3, DriveSide::RIGHT, 1000, {.minSpeed = 40, .earlyExitRange = 4});
@@ -661,41 +864,31 @@ void blue_goal(){
     chassis.moveToPose(-2.76, -44.25, -185, 3000, {.lead = 0.2, .minSpeed = 50, .earlyExitRange = 8});
     chassis.waitUntil(10);
     clamp.set_value(false);
-    targetTheta = 26;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    exitRange = 0.2;
+    ladyBrown.moveTo("load");
 
     chassis.moveToPoint(-2.2, -66.12, 1000);     
-    while(!is_stuck){
-        pros::delay(10);
-    }
+    is_stuck.waitUntil(true);
     intake_on = false;
     first_stage = true;
-    intake2.move(120);
+    routineIntake2.move(120);
     chassis.turnToHeading(-180, 1000);
     chassis.waitUntil(2);
-    targetTheta = 150;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    exitRange = 20;
+    ladyBrown.moveTo(150, false);
 }
 void skills_auto_v2(){
     team_color = 'R';
     chassis.setPose(0, 0, 0);
-    targetTheta = 220;
-    exitRange = 5;
-    pros::delay(400);
+    ladyBrown.moveTo("preload");
+    ladyBrown.waitUntilReached(400);
     chassis.moveToPoint(0, -9, 700, {.forwards = false});
     chassis.turnToPoint(18.8, -6.7, 500, {.forwards = false});
     chassis.waitUntilDone();
     pros::delay(50);
     clampOn = true;
     chassis.moveToPoint(18.8, -6.7, 1000, {.forwards = false, .maxSpeed = 70, .minSpeed = 30});
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     chassis.cancelMotion();
-    targetTheta = 0;
-    exitRange = 40;
+    ladyBrown.moveTo("rest");
     chassis.turnToPoint(21.5, -25.37, 700);
     chassis.waitUntilDone();
     intake_on = true;
@@ -703,31 +896,25 @@ void skills_auto_v2(){
     chassis.moveToPoint(31.4, -39.14, 1000, {.minSpeed = 40, .earlyExitRange = 5});
     chassis.swingToPoint(45.17, -73.9, DriveSide::RIGHT, 600, {.minSpeed = 40});
     chassis.waitUntilDone();
-    targetTheta = 26;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    exitRange = 0.2;
+    ladyBrown.moveTo("load");
     chassis.moveToPoint(45.17, -73.9, 1400);
-    while(!is_stuck){
-        pros::delay(10);
-    }
+    is_stuck.waitUntil(true);
     intake_on = false;
-    targetTheta = 60;
+    ladyBrown.moveTo(60);
     chassis.moveToPose(42.6, -53.5, -194, 1000, {.forwards = false, .lead = 0.2});
     chassis.turnToHeading(-271, 700);
     chassis.waitUntilDone();
     intake_on = true;
     chassis.moveToPoint(59.83, -53.65, 1000, {.minSpeed = 50});
     chassis.waitUntilDone();
-    sequenceStep = 2;
-    targetTheta = 220;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    exitRange = 30;
-    pros::delay(350);
-    leftMotors.move(-40);
-    rightMotors.move(-40);
+    ladyBrown.moveTo("wallStake");
+    ladyBrown.waitUntilReached(350);
+    ladyBrown.moveTo("rest");
+    routineLeftDrive.move(-40);
+    routineRightDrive.move(-40);
     pros::delay(500);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     //chassis.moveToPoint(45.55, .78, 1000, {.forwards = false});
     chassis.turnToPoint(47, 5.86, 1000);
     chassis.moveToPoint(47, 5.86, 1000, {.maxSpeed = 60, .minSpeed = 20, .earlyExitRange = 9});
@@ -741,11 +928,11 @@ void skills_auto_v2(){
     chassis.waitUntilDone();
     intake_on = false;
     
-    leftMotors.move(-70);
-    rightMotors.move(-70);
+    routineLeftDrive.move(-70);
+    routineRightDrive.move(-70);
     pros::delay(400);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     clampOn = false;
     pros::delay(80);
     chassis.moveToPose(-31.1, -11.877, 272.5, 1300, {.lead = 0.25, .maxSpeed = 60});
@@ -757,9 +944,7 @@ void skills_auto_v2(){
     chassis.waitUntilDone();
     clampOn = true;
     chassis.moveToPoint(-68.3, -14.2, 1000, {.forwards = false, .maxSpeed = 60});
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     chassis.cancelMotion();
     chassis.turnToPoint(-64.63, -37.1, 700);
     chassis.waitUntilDone();
@@ -768,32 +953,26 @@ void skills_auto_v2(){
     chassis.turnToHeading(577, 700);
     chassis.moveToPose(-84.67, -90.6, 190, 2000, {.lead = 0.2});
     chassis.waitUntil(13);
-    targetTheta = 26;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    exitRange = 0.2;
-    while(!is_stuck || !(temp > 100)){
-        pros::delay(10);
-        temp = temp + 1;
-    }
-    temp = 0;
+    ladyBrown.moveTo("load");
+    // give the ring at least a second to load, then wait for it to jam against the arm
+    pros::delay(1000);
+    is_stuck.waitUntil(true);
     intake_on = false;
-    targetTheta = 60;
+    ladyBrown.moveTo(60);
     chassis.moveToPose(-83, -62.6, 210, 1200, {.forwards = false, .lead = 0.25});
     chassis.turnToPoint(-99, -64.8, 700);
     chassis.waitUntilDone();
     intake_on = true;
     chassis.moveToPoint(-99, -64.8, 1000, {.minSpeed = 20});
     chassis.waitUntilDone();
-    sequenceStep = 2;
-    targetTheta = 210;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    exitRange = 40;
-    pros::delay(350);
-    leftMotors.move(-40);
-    rightMotors.move(-40);
+    ladyBrown.moveTo("wallStake");
+    ladyBrown.waitUntilReached(350);
+    ladyBrown.moveTo("rest");
+    routineLeftDrive.move(-40);
+    routineRightDrive.move(-40);
     pros::delay(600);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     //chassis.moveToPoint(-83.9, -58.4, 1000, {.forwards = false});
    
     chassis.turnToPoint(-87, -0.88, 700);
@@ -802,34 +981,32 @@ void skills_auto_v2(){
     chassis.turnToHeading(630, 1000);
     chassis.waitUntilDone();
     clampOn = true;
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     pros::delay(100);
 
 
-    leftMotors.move(80);
-    rightMotors.move(80);
+    routineLeftDrive.move(80);
+    routineRightDrive.move(80);
     pros::delay(1000);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     chassis.setPose(float(reset_distance.get_distance()) / 25.4, 0, 0);
     pros::delay(50);
     chassis.swingToHeading(-135, DriveSide::RIGHT, 1000, {.minSpeed = 20});
     chassis.waitUntilDone();
-    leftMotors.move(-50);
-    rightMotors.move(-50);
+    routineLeftDrive.move(-50);
+    routineRightDrive.move(-50);
     pros::delay(300);
     clampOn = false;
-    leftMotors.move(50);
-    rightMotors.move(50);
+    routineLeftDrive.move(50);
+    routineRightDrive.move(50);
     pros::delay(300);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     chassis.turnToHeading(-137,  1000, {.minSpeed = 40});
     chassis.waitUntilDone();
     intake_on = false;
-    intake2.move(127);
+    routineIntake2.move(127);
     chassis.moveToPoint(-52.5, -96.7, 5000, {.maxSpeed = 100});
     chassis.turnToPoint(-77.6, -90.1, 1000, {.forwards = false});
     chassis.waitUntilDone();
@@ -838,14 +1015,12 @@ void skills_auto_v2(){
     
     clampOn = true;
     chassis.moveToPoint(-77.6, -90.1, 1200, {.forwards = false, .maxSpeed = 60, .minSpeed = 9});
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     chassis.cancelMotion();
     chassis.turnToPoint(-80.25, -109.67, 1000);
     chassis.waitUntilDone();
     first_stage = true;
-    intake2.move(127);
+    routineIntake2.move(127);
     doinker.set_value(true);
     chassis.moveToPoint(-80.25, -109.67, 1000);
     chassis.waitUntilDone();
@@ -854,14 +1029,14 @@ void skills_auto_v2(){
     chassis.turnToHeading(-320, 1000);
     chassis.waitUntilDone();
     clampOn = false;
-    leftMotors.move(-50);
-    rightMotors.move(-50);
+    routineLeftDrive.move(-50);
+    routineRightDrive.move(-50);
     pros::delay(300);
-    leftMotors.move(50);
-    rightMotors.move(50);
+    routineLeftDrive.move(50);
+    routineRightDrive.move(50);
     pros::delay(500);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     chassis.turnToPoint(-81.44, -103.5, 1000, {.forwards = false});
     chassis.waitUntilDone();
     doinker.set_value(false);
@@ -872,67 +1047,56 @@ void skills_auto_v2(){
     chassis.turnToPoint(-68.45, -62.1, 700, {.forwards = false});
     chassis.waitUntilDone();
     
-    targetTheta = 26;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    exitRange = 0.2;
+    ladyBrown.moveTo("load");
     chassis.moveToPoint(-68.45, -62.1, 1500, {.forwards = false, .maxSpeed = 50});
     chassis.turnToPoint(-80.76, -65.2, 700);
     chassis.waitUntilDone();
     ringStop = false;
     first_stage = false;
     intake_on = true;
-    while(!is_stuck){
-        pros::delay(10);
-    }
+    is_stuck.waitUntil(true);
     intake_on = false;
-    leftMotors.move(100);
-    rightMotors.move(100);
+    routineLeftDrive.move(100);
+    routineRightDrive.move(100);
     pros::delay(400);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     pros::delay(100);
     chassis.setPose(0, 0, 0);
     chassis.moveToPoint(0, -7.4, 800, {.forwards = false, .maxSpeed = 30});
     chassis.waitUntilDone();
-    targetTheta = 220;
-    exitRange = 10;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
+    ladyBrown.moveTo("preload");
     pros::delay(100);
     intake_on = true;
     pros::delay(350);
     chassis.moveToPoint(0, -16, 800, {.forwards = false, .maxSpeed = 30});
     chassis.turnToPoint(23.865, -6.147, 1000);
     chassis.waitUntilDone();
-    targetTheta = 0;
-    exitRange = 30;
+    ladyBrown.moveTo("rest");
     clampOn = false;
-    leftMotors.move(120);
-    rightMotors.move(120);
+    routineLeftDrive.move(120);
+    routineRightDrive.move(120);
     pros::delay(1500);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
     chassis.turnToHeading(45, 1000);
     chassis.waitUntilDone();
-    leftMotors.move(-60);
-    rightMotors.move(-60);
+    routineLeftDrive.move(-60);
+    routineRightDrive.move(-60);
     hang.set_value(true);
     pros::delay(200);
-    targetTheta = 41;
-    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    exitRange = 1;
-    pros::delay(1600);
-    leftMotors.move(50);
-    rightMotors.move(50);
+    ladyBrown.moveTo("hang");
+    ladyBrown.waitUntilReached(1600);
+    routineLeftDrive.move(50);
+    routineRightDrive.move(50);
     pros::delay(120);
-    leftMotors.move(0);
-    rightMotors.move(0);
+    routineLeftDrive.move(0);
+    routineRightDrive.move(0);
 }   
 void test(){
     team_color = 'R';
     clampOn = true;
-    while(!current){
-        pros::delay(10);
-    }
+    clampTrigger.waitUntilFired();
     intake_on = true;
 }
 
@@ -957,30 +1121,42 @@ void initialize() {
     chassis.calibrate();  // Wait for calibration before starting tasks
     
 
-    // Start background tasks only after calibration
-    pros::Task screenTask([]() {
-        while (true) {
-            pros::lcd::print(0, "X: %f", chassis.getPose().x);
-            pros::lcd::print(1, "Y: %f", chassis.getPose().y);
-            pros::lcd::print(2, "Theta: %f", chassis.getPose().theta);
-            
-            //pros::lcd::print(4, "%i", line_tracker.get_value());
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
-            pros::delay(50);
-        }
+    // the optical sensor measures for 3ms per sample, its fastest, so a passing ring is seen close to where it is
+    optical.set_integration_time(3);
+    // the arm starts down against its hard stop, at 0 degrees. Named positions it moves between, and whether it is held
+    // there or falls back on its own
+    ladyBrownRotation.reset_position();
+    lb1.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
+    ladyBrown.addSetpoint("rest", 0, false);
+    ladyBrown.addSetpoint("load", 26);
+    ladyBrown.addSetpoint("wallStake", 210, false);
+    ladyBrown.addSetpoint("allianceStake", 250);
+    ladyBrown.addSetpoint("preload", 220, false); // the alliance stake, from the starting tile
+    ladyBrown.addSetpoint("descore", 180);
+    ladyBrown.addSetpoint("ladder", 120, false);
+    ladyBrown.addSetpoint("hang", 41);
+    clampTrigger.onFire([] {
+        clamp.set_value(true);
+        current = true;
     });
 
-    // Start background tasks
-    pros::Task isStuckTask(is_stuck_check, nullptr, "stuck task");
-    pros::Task clampTask(clampCheck, nullptr, "clamp task");
-    pros::Task color_check_task(color_check, nullptr, "color check task");
-    
-
-    pros::Task lbPidTask(LBpidTask, nullptr, "LB PID Task");
+    // Start the subsystems only after calibration
+    for (lemlib::Subsystem* subsystem : std::initializer_list<lemlib::Subsystem*> {
+             &controllerInput, &unjam, &clampTrigger, &clampSubsystem, &colorSort, &ladyBrown, &hangSubsystem})
+        subsystems().add(*subsystem);
+    setup_dashboard();
+    displays().add(controllerScreen);
+    displays().add(dashboard);
+    subsystems().add(poseHistory);
+    displays().add(fieldView);
+    setup_telemetry();
 }
 
 
-void disabled() {}
+void disabled() {
+    lemlib::recordOdom(nullptr);
+    recorder().stop();
+}
 
 void competition_initialize() {}
 
@@ -988,18 +1164,33 @@ void competition_initialize() {}
 // this needs to be put outside a function
 
 void autonomous() {
+    recorder().start("auton");
+    lemlib::recordOdom([](const lemlib::TelemetryFrame& frame) { recorder().write(frame); });
     optical.set_led_pwm(95);
+    fieldView.focus();
     selector.run_auton();
+    releaseRoutineOutputs();
     //red_ring();
 }
 
 
+// presses of the buttons the driver loop toggles the pistons with. Subscribed when driver control starts
+lemlib::InputQueue& driverButtons() {
+    static lemlib::InputQueue& queue =
+        controllerInput.subscribe({pros::E_CONTROLLER_DIGITAL_Y, pros::E_CONTROLLER_DIGITAL_L1});
+    return queue;
+}
+
 /**
  * Runs in driver control
  */
 void opcontrol() {
-    pros::Task hangTask(hang_task, nullptr, "hang task");
-    //pros::Task lbPidTask(LBpidTask, nullptr, "LB PID Task");
+    // autonomous can be cut short before it releases them
+    releaseRoutineOutputs();
+    recorder().start("driver");
+    fieldView.focus();
+    lemlib::recordOdom([](const lemlib::TelemetryFrame& frame) { recorder().write(frame); });
+    hangSubsystem.setEnabled(true);
     
 
     optical.set_led_pwm(0);
@@ -1011,13 +1202,11 @@ void opcontrol() {
 
     ringStop = false;
 
-    targetTheta = 0;
-    exitRange = 30;
+    ladyBrown.moveTo("rest");
 
     /*  chassis.setPose(0, 0, 0);
-    targetTheta = 220;
-    exitRange = 5;
-    pros::delay(400);
+    ladyBrown.moveTo("preload");
+    ladyBrown.waitUntilReached(400);
     chassis.moveToPoint(0, -9, 700, {.forwards = false});
     chassis.turnToPoint(18.8, -6.7, 500, {.forwards = false});
     chassis.waitUntilDone();
@@ -1025,53 +1214,53 @@ void opcontrol() {
     clampOn = true;
     chassis.moveToPoint(18.8, -6.7, 1000, {.forwards = false, .maxSpeed = 70, .minSpeed = 40});
     chassis.waitUntilDone();
-    targetTheta = 0;
-    exitRange = 31;
+    ladyBrown.moveTo("rest");
     controller.rumble(".");*/
     opC = true;
     while (true) {
+        driverProfile.start();
 
-        int leftY = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
-        int rightX = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X);
+        int leftY = controllerInput.getAnalog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+        int rightX = controllerInput.getAnalog(pros::E_CONTROLLER_ANALOG_RIGHT_X);
 
         float scaleFactor = current ? 0.45 : 0.22;
         chassis.arcade(leftY, rightX, false, scaleFactor);
 
-        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_Y)) {
-            current = !current; // Toggle piston state
-            clamp.set_value(current);
-        } 
-
-        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_L1)) {
-            doinkerState = !doinkerState; // Toggle piston state
-            doinker.set_value(doinkerState);
-        } 
+        lemlib::InputEvent event;
+        while (driverButtons().pop(event)) {
+            if (event.type != lemlib::InputEventType::PRESS) continue;
+            if (event.button == pros::E_CONTROLLER_DIGITAL_Y) {
+                current = !current; // Toggle piston state
+                clamp.set_value(current);
+            } else if (event.button == pros::E_CONTROLLER_DIGITAL_L1) {
+                doinkerState = !doinkerState; // Toggle piston state
+                doinker.set_value(doinkerState);
+            }
+        }
 
 
         // Intake control
         
-        int intakeSpeed = 0;
-
-        if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_R1)) {
+        if (controllerInput.isPressed(pros::E_CONTROLLER_DIGITAL_R1)) {
             reversed = false;
             if (!is_stuck){
-                intake1.move(-127);
-                intake2.move(127);
+                driverIntake1.move(-127);
+                driverIntake2.move(127);
             }
             else{
-                intake2.move(127);
+                driverIntake2.move(127);
             }
         } 
-        else if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) {
-            intake1.move(127);
-            intake2.move(-127);
+        else if (controllerInput.isPressed(pros::E_CONTROLLER_DIGITAL_R2)) {
+            driverIntake1.move(127);
+            driverIntake2.move(-127);
             reversed = true;
         }
         else{
-            intake1.move(0);
-            intake2.move(0);
+            driverIntake1.move(0);
+            driverIntake2.move(0);
         }
 
-        pros::delay(10);  // Small delay to avoid overwhelming the system
+        driverProfile.delay(10);  // Small delay to avoid overwhelming the system
+}
 }
-}
\ No newline at end of file